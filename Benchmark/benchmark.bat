@@ -1,12 +1,13 @@
 @echo off
 for %%x in (
-			"Release Basic (shadows only)"
-			"Release PCF (shadows only)"
-			"Release VSM (shadows only)"
-			"Release PCSS (shadows only)"
-			"Release CHSS (shadows only)"
 			"Release Master (shadows only)"
 			) do (
-				echo Running benchmark for %%x...
-				..\x64\%%x\OpenGLShadowsExec.exe benchmark
+				rem with and without the depth prepass, to measure the shaded overdraw
+				for %%y in ("" "prepass") do (
+					rem with and without contact shadows, to weigh them against the map sizes
+					for %%z in ("" "contact") do (
+						echo Running benchmark for %%x %%~y %%~z...
+						..\x64\%%x\OpenGLShadowsExec.exe all %%~y %%~z benchmark
+					)
+				)
 			)
\ No newline at end of file
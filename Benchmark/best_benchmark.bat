@@ -1,12 +1,10 @@
 @echo off
 for %%x in (
-			"Release Basic (shadows only)"
-			"Release PCF (shadows only)"
-			"Release VSM (shadows only)"
-			"Release PCSS (shadows only)"
-			"Release CHSS (shadows only)"
 			"Release Master (shadows only)"
 			) do (
-				echo Running benchmark for %%x...
-				..\x64\%%x\OpenGLShadowsExec.exe best benchmark
+				rem with and without the depth prepass, to measure the shaded overdraw
+				for %%y in ("" "prepass") do (
+					echo Running benchmark for %%x %%~y...
+					..\x64\%%x\OpenGLShadowsExec.exe all best %%~y benchmark
+				)
 			)
\ No newline at end of file
@@ -3,12 +3,12 @@
 #include "SceneNode.h"
 #include "Primitives.h"
 #include "ShadowUtils.h"
-#include "ShadowVariants.h"
 
 #include <glm/detail/type_quat.hpp>
 #include <glm/ext/quaternion_trigonometric.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 
@@ -24,7 +24,7 @@
 int main(int argc, char** argv)
 {
     using namespace shadow;
-    bool forceBenchmark = false, genScreenshots = false, useBestBenchmark = false;
+    bool forceBenchmark = false, genScreenshots = false, useBestBenchmark = false, lightAutoFit = false, sdsm = false, virtualShadowMap = false, incrementalShadowMaps = false, shadowTileClassification = false, deferredShadows = false, depthPrepass = false, deferredRendering = false, contactShadows = false, staticShadowCache = false, temporalShadows = false, shadowDenoising = false, lightSweep = false, sweepTechniques = false;
     for (int i = 0; i < argc; ++i)
     {
         std::string arg = argv[i];
@@ -37,6 +37,48 @@ int main(int argc, char** argv)
         else if (arg == "best") {
             useBestBenchmark = true;
         }
+        else if (arg == "autofit") {
+            lightAutoFit = true;
+        }
+        else if (arg == "sdsm") {
+            sdsm = true;
+        }
+        else if (arg == "virtual") {
+            virtualShadowMap = true;
+        }
+        else if (arg == "incremental") {
+            incrementalShadowMaps = true;
+        }
+        else if (arg == "tiles") {
+            shadowTileClassification = true;
+        }
+        else if (arg == "deferred") {
+            deferredShadows = true;
+        }
+        else if (arg == "prepass") {
+            depthPrepass = true;
+        }
+        else if (arg == "gbuffer") {
+            deferredRendering = true;
+        }
+        else if (arg == "contact") {
+            contactShadows = true;
+        }
+        else if (arg == "static") {
+            staticShadowCache = true;
+        }
+        else if (arg == "temporal") {
+            temporalShadows = true;
+        }
+        else if (arg == "denoise") {
+            shadowDenoising = true;
+        }
+        else if (arg == "lights") {
+            lightSweep = true;
+        }
+        else if (arg == "all") {
+            sweepTechniques = true;
+        }
     }
     AppWindow& appWindow = AppWindow::getInstance();
     ResourceManager& resourceManager = ResourceManager::getInstance();
@@ -44,7 +86,7 @@ int main(int argc, char** argv)
     {
         return 1;
     }
-    Configurator configurator(appWindow, resourceManager);
+    TechniqueConfigurator* configurator = &appWindow.getShadowRenderer().getConfigurator();
     std::shared_ptr<UboLights> uboLights = ResourceManager::getInstance().getUboLights();
     std::shared_ptr<DirectionalLight> dirLight = uboLights->getDirectionalLight();
     std::shared_ptr<SpotLight> spotLight = uboLights->getSpotLight();
@@ -56,28 +98,6 @@ int main(int argc, char** argv)
     dirLight->setColor(glm::vec3(0.5f, 0.5f, 1.0f));
     dirLight->setStrength(5.0f);
 #endif
-#if SHADOW_MASTER || SHADOW_CHSS || SHADOW_PCSS
-    dirLight->setLightSize(0.09f);
-#endif
-    dirLight->setProjectionSize(1.45f);
-    dirLight->setNearZ(0.2f);
-    switch (SHADOW_IMPL) {
-    default:
-        dirLight->setFarZ(1.5f);
-        break;
-    case SHADOW_IMPL_BASIC:
-        dirLight->setFarZ(8.0f);
-        break;
-    case SHADOW_IMPL_PCF:
-        dirLight->setProjectionSize(1.8f);
-        dirLight->setNearZ(0.2f);
-        dirLight->setFarZ(2.0f);
-        break;
-    case SHADOW_IMPL_VSM:
-        dirLight->setNearZ(0.3f);
-        dirLight->setFarZ(2.0f);
-        break;
-    }
     dirLight->setPosition(glm::vec3(-0.03f, 1.0f, 0.4f));
     dirLight->setDirection(
         glm::quat(glm::vec3(glm::radians(-49.0f), glm::radians(15.0f), 0.0f))
@@ -89,26 +109,7 @@ int main(int argc, char** argv)
     spotLight->setColor(glm::vec3(1.0f, 0.5f, 0.5f));
     spotLight->setStrength(15.0f);
 #endif
-#if SHADOW_MASTER || SHADOW_CHSS || SHADOW_PCSS
-    spotLight->setLightSize(0.09f);
-#endif
-    spotLight->setFarZ(2.35f);
-    switch (SHADOW_IMPL) {
-    default:
-        spotLight->setNearZ(0.95f);
-        break;
-    case SHADOW_IMPL_BASIC:
-        spotLight->setNearZ(0.2f);
-        break;
-    case SHADOW_IMPL_PCF:
-        spotLight->setNearZ(1.2f);
-        spotLight->setFarZ(4.0f);
-        break;
-    case SHADOW_IMPL_VSM:
-        spotLight->setNearZ(1.45f);
-        spotLight->setFarZ(2.5f);
-        break;
-    }
+    configurator->applyLightSetup(*dirLight, *spotLight);
     spotLight->setInnerCutOff(cosf(glm::radians(20.0f)));
     spotLight->setOuterCutOff(cosf(glm::radians(25.0f)));
     spotLight->setPosition(glm::vec3(1.07f, 1.6f, 0.4f));
@@ -138,14 +139,37 @@ int main(int argc, char** argv)
     suitcaseNode->setMesh(suitcase).scale(glm::vec3(0.0055f)).rotate(-FPI * 0.3f, glm::vec3(0.0f, 1.0f, 0.0f)).setPosition(glm::vec3(0.07f, 0.267f, -0.2f));
     chairNode->setMesh(chair).scale(glm::vec3(0.5f)).rotate(FPI * 0.85f, glm::vec3(0.0f, 1.0f, 0.0f)).setPosition(glm::vec3(-0.03f, 0.0f, 0.3f));
     planeNode->setMesh(plane).translate(glm::vec3(0.0f, -0.0f, 0.0f));
+    suitcaseNode->setDynamic(true); // stands in for the moving content, the furniture and the floor stay in the static shadow cache
     scene->setParent(node, tableNode);
     scene->setParent(node, suitcaseNode);
     scene->setParent(node, chairNode);
     scene->setParent(node, planeNode);
+    appWindow.setLightAutoFit(lightAutoFit);
+    appWindow.setSdsm(sdsm);
+    if (!appWindow.getShadowRenderer().hasDepthMaps())
+    {
+        virtualShadowMap = incrementalShadowMaps = false;
+    }
+    appWindow.setVirtualShadowMap(virtualShadowMap);
+    appWindow.setIncrementalShadowMaps(incrementalShadowMaps);
+    appWindow.setShadowTileClassification(shadowTileClassification);
+    appWindow.setDeferredShadows(deferredShadows);
+    appWindow.setDepthPrepass(depthPrepass);
+#ifdef RENDER_SHADOW_ONLY
+    deferredRendering = false;
+#endif
+    appWindow.setDeferredRendering(deferredRendering);
+    appWindow.setContactShadows(contactShadows);
+    appWindow.setStaticShadowCache(staticShadowCache);
+    appWindow.setTemporalShadows(temporalShadows);
+    if (shadowDenoising)
+    {
+        appWindow.setShadowDenoiseIterations(2U);
+    }
 
     constexpr double BENCHMARK_TIME = 10.0f;
     double currentBenchmarkTime = 0.0;
-    std::vector<ShadowParams> benchmarkParams;
+    size_t benchmarkParamCount = 0;
     size_t currentBenchmarkFrameCount = 0;
     unsigned int currentBenchmarkIndex = 0U;
     bool benchmarkRunning = false;
@@ -153,6 +177,34 @@ int main(int argc, char** argv)
     bool benchmarkWaitFrame = false;
     bool closeWindowAfterBenchmark = true;
     std::ostringstream benchmarkCsv;
+    auto writeCsv = [&benchmarkCsv](const std::filesystem::path& csvFile)
+    {
+        FILE* file{};
+        if (int err = fopen_s(&file, csvFile.generic_string().c_str(), "w"); err != 0) {
+            constexpr size_t BUFFER_SIZE = 256;
+            char buffer[BUFFER_SIZE];
+            strerror_s(buffer, BUFFER_SIZE, err);
+            SHADOW_ERROR("Failed to open file '{}' for writing! {}", csvFile.generic_string(), buffer);
+            throw std::runtime_error("Failed to open output CSV file!");
+        }
+        std::string csvString = benchmarkCsv.str();
+        benchmarkCsv.clear();
+        size_t written = fwrite(csvString.c_str(), 1, csvString.length(), file);
+        if (written != csvString.length()) {
+            SHADOW_ERROR("Attempted to write {} bytes to '{}', but wrote only {}!", csvString.length(), csvFile.generic_string(), written);
+        }
+        if (int err = fclose(file); err != 0) {
+            constexpr size_t BUFFER_SIZE = 256;
+            char buffer[BUFFER_SIZE];
+            strerror_s(buffer, BUFFER_SIZE, err);
+            SHADOW_ERROR("Failed to close file '{}'! {}", csvFile.generic_string(), buffer);
+        }
+    };
+
+    unsigned int currentLightCountIndex = 0U;
+    double baseFrameTime = 0.0;
+    bool lightSweepRunning = false;
+    bool lightSweepStarting = lightSweep;
 
     unsigned int currentScreenshotIndex = 0U;
     bool genScreenshotsRunning = false;
@@ -160,6 +212,7 @@ int main(int argc, char** argv)
     bool genScreenshotsWaitFrame = true;
     bool closeWindowAfterGenScreenshots = genScreenshots && !forceBenchmark;
 
+    bool sweepRunning = false;
 
     double timeDelta = 0.0;
     unsigned int secondCounter = 0U;
@@ -175,38 +228,97 @@ int main(int argc, char** argv)
     float projectionSize = dirLight->getProjectionSize();
     glm::vec3 dirColor = dirData.color, spotColor = spotData.color;
     glm::vec3 spotPosition = spotData.position;
+    int lightCount = 2, currLightCount = lightCount;
 
     std::vector<GLsizei> MAP_SIZES{ 128, 256, 384, 512, 640, 768, 896, 1024, 1280, 1536, 1792, 2048, 2560, 3072, 3584, 4096 };
     int currMapSizeIndex = static_cast<int>(MAP_SIZES.size()) - 1;
     int mapSize = MAP_SIZES[currMapSizeIndex];
 
-#if SHADOW_MASTER || SHADOW_CHSS || SHADOW_PCSS
-    int currShadowSamples = 32, currPenumbraSamples = 16;
-    unsigned int shadowSamples = currShadowSamples, penumbraSamples = currPenumbraSamples;
-#endif
-#if SHADOW_MASTER || SHADOW_CHSS
-    std::vector<unsigned int> PENUMBRA_DIVISORS{ 1,2,4,8,16,32,64,128,256 };
-    int currPenumbraDivisorIndex = 0;
-    unsigned int penumbraTextureSizeDivisor = PENUMBRA_DIVISORS[currPenumbraDivisorIndex];
-    resourceManager.updateVogelDisk(shadowSamples, penumbraSamples);
-#elif SHADOW_PCSS
-    resourceManager.updatePoisson(shadowSamples, penumbraSamples);
-#elif SHADOW_PCF
-    std::vector<unsigned int> FILTER_SIZES{ 1,3,5,7,9,11,13,15,17,19,21,23,25,27,29,31 };
-    int currFilterSizeIndex = 0;
-    unsigned int filterSize = FILTER_SIZES[currFilterSizeIndex];
-    resourceManager.updateFilterSize(filterSize);
-#elif SHADOW_VSM
-    int blurPasses = appWindow.getBlurPasses();
-#endif
-#if SHADOW_MASTER || SHADOW_CHSS
-    appWindow.resizeLights(mapSize, penumbraTextureSizeDivisor);
-#else
+    // the settings of a technique belong to its shadow renderer and start from the defaults when switching to it
+    int currTechnique = static_cast<int>(appWindow.getShadowTechnique());
+    bool animatedNoise = appWindow.isAnimatedNoise();
+    std::vector<GLsizei> SHADOW_TILE_SIZES{ 8, 16 };
+    int currShadowTileSizeIndex = static_cast<int>(std::find(SHADOW_TILE_SIZES.begin(), SHADOW_TILE_SIZES.end(), appWindow.getShadowTileSize()) - SHADOW_TILE_SIZES.begin());
+    GLsizei shadowTileSize = SHADOW_TILE_SIZES[currShadowTileSizeIndex];
+    float contactShadowLength = appWindow.getContactShadowLength();
+    float temporalHistoryWeight = appWindow.getTemporalHistoryWeight();
+    int denoiseIterations = appWindow.getShadowDenoiseIterations();
+    int denoiseKernelRadius = appWindow.getShadowDenoiseKernelRadius();
     appWindow.resizeLights(mapSize);
-#endif
+
+    auto applyTechnique = [&](ShadowTechnique technique)
+    {
+        if (!appWindow.setShadowTechnique(technique))
+        {
+            SHADOW_ERROR("Failed to switch to the {} shadow technique!", getShadowTechniqueName(technique));
+            return;
+        }
+        SHADOW_INFO("Switched to the {} shadow technique.", getShadowTechniqueName(technique));
+        currTechnique = static_cast<int>(technique);
+        configurator = &appWindow.getShadowRenderer().getConfigurator();
+        configurator->applyLightSetup(*dirLight, *spotLight);
+        if (!appWindow.getShadowRenderer().hasDepthMaps())
+        {
+            virtualShadowMap = incrementalShadowMaps = false;
+        }
+        else
+        {
+            appWindow.setVirtualShadowMap(virtualShadowMap);
+            appWindow.setIncrementalShadowMaps(incrementalShadowMaps);
+        }
+        dirClip = glm::vec2(dirData.nearZ, dirData.farZ);
+        spotClip = glm::vec2(spotData.nearZ, spotData.farZ);
+        projectionSize = dirLight->getProjectionSize();
+        dirSize = dirData.lightSize;
+        spotSize = spotData.lightSize;
+        if (resourceManager.reworkShaderFiles())
+        {
+            resourceManager.updateShaders();
+        }
+    };
+    // moves a technique sweep on to the next technique, false once all of them were covered
+    auto nextSweepTechnique = [&]()
+    {
+        if (!sweepRunning)
+        {
+            return false;
+        }
+        unsigned int next = static_cast<unsigned int>(appWindow.getShadowTechnique()) + 1U;
+        if (next >= static_cast<unsigned int>(ShadowTechnique::ShadowTechniqueEnd))
+        {
+            sweepRunning = false;
+            return false;
+        }
+        applyTechnique(static_cast<ShadowTechnique>(next));
+        return true;
+    };
+    auto beginSweep = [&]()
+    {
+        if (sweepTechniques && !sweepRunning)
+        {
+            sweepRunning = true;
+            applyTechnique(static_cast<ShadowTechnique>(0U));
+        }
+    };
+
+    // compiles the shader permutations of every parameter set up front, so that none are compiled within the measured windows
+    auto prewarmParamSets = [&](size_t paramSetCount)
+    {
+        unsigned int compiled{};
+        for (size_t i = 0U; i < paramSetCount; ++i)
+        {
+            configurator->applyParamSet(i);
+            if (resourceManager.reworkShaderFiles())
+            {
+                compiled += resourceManager.prewarmShaders();
+            }
+        }
+        SHADOW_INFO("Prewarmed {} parameter sets, {} programs had to be compiled.", paramSetCount, compiled);
+    };
+
     auto guiProc = [&]()
     {
-        if (!genScreenshotsRunning && !benchmarkRunning) {
+        if (!genScreenshotsRunning && !benchmarkRunning && !lightSweepRunning) {
             if (screenshotState == 1) {
                 ++screenshotState;
             }
@@ -231,27 +343,39 @@ int main(int argc, char** argv)
                 ImGui::SameLine();
                 ImGui::Checkbox("Close app after benchmark", &closeWindowAfterBenchmark);
                 ImGui::Checkbox("Use best params for benchmark", &useBestBenchmark);
+                if (ImGui::Button("Run light count sweep"))
+                {
+                    lightSweepStarting = true;
+                }
                 if (ImGui::Button("Generate screenshots"))
                 {
                     genScreenshotsStarting = true;
                 }
                 ImGui::SameLine();
                 ImGui::Checkbox("Close app after generating screenshots", &closeWindowAfterGenScreenshots);
+                ImGui::Checkbox("Run for all techniques", &sweepTechniques);
                 ImGui::Checkbox("Show settings", &showingSettings);
                 if (showingSettings)
                 {
+                    ShadowRenderer& shadowRenderer = appWindow.getShadowRenderer();
+                    ImGui::SliderInt("Technique", &currTechnique, 0, static_cast<int>(ShadowTechnique::ShadowTechniqueEnd) - 1, getShadowTechniqueName(static_cast<ShadowTechnique>(currTechnique)));
                     ImGui::SliderInt("Shadow map size", &currMapSizeIndex, 0, static_cast<int>(MAP_SIZES.size()) - 1, std::to_string(MAP_SIZES[currMapSizeIndex]).c_str());
-#if SHADOW_MASTER || SHADOW_CHSS
-                    ImGui::SliderInt("Penumbra map size divisor", &currPenumbraDivisorIndex, 0, static_cast<int>(PENUMBRA_DIVISORS.size()) - 1, std::to_string(PENUMBRA_DIVISORS[currPenumbraDivisorIndex]).c_str());
-#endif
-#if SHADOW_MASTER || SHADOW_CHSS || SHADOW_PCSS
-                    ImGui::SliderInt("Shadow samples", &currShadowSamples, 1, 64);
-                    ImGui::SliderInt("Penumbra samples", &currPenumbraSamples, 1, 64);
-#elif SHADOW_PCF
-                    ImGui::SliderInt("Filter size", &currFilterSizeIndex, 0, static_cast<int>(FILTER_SIZES.size()) - 1, std::to_string(FILTER_SIZES[currFilterSizeIndex]).c_str());
-#elif SHADOW_VSM
-                    ImGui::SliderInt("Blur passes", &blurPasses, 0, 100);
-#endif
+                    shadowRenderer.drawSettings();
+                    if (shadowRenderer.hasBlockerSearch())
+                    {
+                        ImGui::Checkbox("Animated blue noise", &animatedNoise);
+                        ImGui::Checkbox("Shadow tile classification", &shadowTileClassification);
+                        if (shadowTileClassification)
+                        {
+                            ImGui::SliderInt("Shadow tile size", &currShadowTileSizeIndex, 0, static_cast<int>(SHADOW_TILE_SIZES.size()) - 1, std::to_string(SHADOW_TILE_SIZES[currShadowTileSizeIndex]).c_str());
+                        }
+                        ImGui::SliderInt("Denoise iterations", &denoiseIterations, 0, static_cast<int>(ShadowDenoiser::MAX_ITERATIONS));
+                        if (denoiseIterations > 0)
+                        {
+                            ImGui::SliderInt("Denoise kernel radius", &denoiseKernelRadius, 1, static_cast<int>(ShadowDenoiser::MAX_KERNEL_RADIUS));
+                        }
+                    }
+                    ImGui::SliderInt("Lights", &currLightCount, 2, static_cast<int>(SsboPointLights::MAX_POINT_LIGHTS) + 2);
                     ImGui::DragFloat("Directional light strength", &dirStrength, 0.05f, 0.0f, 25.0f);
                     ImGui::DragFloat("Spot light strength", &spotStrength, 0.05f, 0.0f, 25.0f);
                     ImGui::DragFloat("Directional light size", &dirSize, 0.005f, 0.0f, 5.0f);
@@ -260,49 +384,48 @@ int main(int argc, char** argv)
                     ImGui::ColorPicker3("Directional light color", value_ptr(dirColor));
                     ImGui::ColorPicker3("Spot light color", value_ptr(spotColor));
                     ImGui::DragFloat("Dir projection size", &projectionSize, 0.05f, 0.0f, 15.0f);
-                    ImGui::DragFloat2("Directional clipping", value_ptr(dirClip), 0.05f, 0.0f, 10.0f);
-                    ImGui::DragFloat2("Spot clipping", value_ptr(spotClip), 0.05f, 0.0f, 10.0f);
-                    bool mapSizeChanged = false;
-                    if (mapSize != MAP_SIZES[currMapSizeIndex])
+                    ImGui::Checkbox("Auto-fit light frustums", &lightAutoFit);
+                    ImGui::Checkbox("SDSM (fit to visible depth)", &sdsm);
+                    ImGui::Checkbox("Deferred shadow mask", &deferredShadows);
+                    ImGui::Checkbox("Temporal shadow accumulation", &temporalShadows);
+                    if (temporalShadows)
                     {
-                        mapSizeChanged = true;
-                        mapSize = MAP_SIZES[currMapSizeIndex];
+                        ImGui::SliderFloat("Temporal history weight", &temporalHistoryWeight, 0.0f, 0.98f);
                     }
-#if SHADOW_MASTER || SHADOW_CHSS
-                    if (penumbraTextureSizeDivisor != PENUMBRA_DIVISORS[currPenumbraDivisorIndex])
+                    ImGui::Checkbox("Depth prepass", &depthPrepass);
+#ifndef RENDER_SHADOW_ONLY
+                    ImGui::Checkbox("Deferred rendering (G-buffer)", &deferredRendering);
+#endif
+                    ImGui::Checkbox("Contact shadows", &contactShadows);
+                    ImGui::Checkbox("Static shadow cache", &staticShadowCache);
+                    if (contactShadows)
                     {
-                        mapSizeChanged = true;
-                        penumbraTextureSizeDivisor = PENUMBRA_DIVISORS[currPenumbraDivisorIndex];
+                        ImGui::DragFloat("Contact shadow length", &contactShadowLength, 0.005f, 0.01f, 1.0f);
                     }
-#endif
-                    if (mapSizeChanged)
+                    if (shadowRenderer.hasDepthMaps())
                     {
-#if SHADOW_MASTER || SHADOW_CHSS
-                        appWindow.resizeLights(mapSize, penumbraTextureSizeDivisor);
-#else
-                        appWindow.resizeLights(mapSize);
-#endif
+                        ImGui::Checkbox("Virtual directional shadow map", &virtualShadowMap);
+                        ImGui::Checkbox("Incremental shadow map updates", &incrementalShadowMaps);
                     }
-#if SHADOW_MASTER || SHADOW_CHSS || SHADOW_PCSS
-                    if (shadowSamples != static_cast<unsigned int>(currShadowSamples) || penumbraSamples != static_cast<unsigned int>(currPenumbraSamples))
+                    if (!lightAutoFit && !sdsm)
                     {
-                        shadowSamples = currShadowSamples;
-                        penumbraSamples = currPenumbraSamples;
-#if SHADOW_MASTER || SHADOW_CHSS
-                        resourceManager.updateVogelDisk(shadowSamples, penumbraSamples);
-#else
-                        resourceManager.updatePoisson(shadowSamples, penumbraSamples);
-#endif
+                        ImGui::DragFloat2("Directional clipping", value_ptr(dirClip), 0.05f, 0.0f, 10.0f);
+                        ImGui::DragFloat2("Spot clipping", value_ptr(spotClip), 0.05f, 0.0f, 10.0f);
                     }
-#elif SHADOW_PCF
-                    if (filterSize != FILTER_SIZES[currFilterSizeIndex])
+                    if (currTechnique != static_cast<int>(appWindow.getShadowTechnique()))
                     {
-                        filterSize = FILTER_SIZES[currFilterSizeIndex];
-                        resourceManager.updateFilterSize(filterSize);
+                        applyTechnique(static_cast<ShadowTechnique>(currTechnique));
+                    }
+                    if (mapSize != MAP_SIZES[currMapSizeIndex])
+                    {
+                        mapSize = MAP_SIZES[currMapSizeIndex];
+                        appWindow.resizeLights(mapSize);
+                    }
+                    if (lightCount != currLightCount)
+                    {
+                        lightCount = currLightCount;
+                        configurator->applyLightCount(lightCount);
                     }
-#elif SHADOW_VSM
-                    GUI_UPDATE(blurPasses, appWindow.getBlurPasses(), appWindow.setBlurPasses);
-#endif
                     GUI_UPDATE(dirStrength, dirData.strength, dirLight->setStrength);
                     GUI_UPDATE(spotStrength, spotData.strength, spotLight->setStrength);
                     GUI_UPDATE(dirSize, dirData.lightSize, dirLight->setLightSize);
@@ -311,10 +434,40 @@ int main(int argc, char** argv)
                     GUI_UPDATE(dirColor, dirData.color, dirLight->setColor);
                     GUI_UPDATE(spotColor, spotData.color, spotLight->setColor);
                     GUI_UPDATE(projectionSize, dirLight->getProjectionSize(), dirLight->setProjectionSize);
-                    GUI_UPDATE(dirClip.x, dirData.nearZ, dirLight->setNearZ);
-                    GUI_UPDATE(dirClip.y, dirData.farZ, dirLight->setFarZ);
-                    GUI_UPDATE(spotClip.x, spotData.nearZ, spotLight->setNearZ);
-                    GUI_UPDATE(spotClip.y, spotData.farZ, spotLight->setFarZ);
+                    GUI_UPDATE(lightAutoFit, appWindow.isLightAutoFit(), appWindow.setLightAutoFit);
+                    GUI_UPDATE(sdsm, appWindow.isSdsm(), appWindow.setSdsm);
+                    GUI_UPDATE(animatedNoise, appWindow.isAnimatedNoise(), appWindow.setAnimatedNoise);
+                    GUI_UPDATE(shadowTileClassification, appWindow.isShadowTileClassification(), appWindow.setShadowTileClassification);
+                    GUI_UPDATE(deferredShadows, appWindow.isDeferredShadows(), appWindow.setDeferredShadows);
+                    GUI_UPDATE(temporalShadows, appWindow.isTemporalShadows(), appWindow.setTemporalShadows);
+                    GUI_UPDATE(temporalHistoryWeight, appWindow.getTemporalHistoryWeight(), appWindow.setTemporalHistoryWeight);
+                    GUI_UPDATE(denoiseIterations, appWindow.getShadowDenoiseIterations(), appWindow.setShadowDenoiseIterations);
+                    GUI_UPDATE(denoiseKernelRadius, appWindow.getShadowDenoiseKernelRadius(), appWindow.setShadowDenoiseKernelRadius);
+                    GUI_UPDATE(depthPrepass, appWindow.isDepthPrepass(), appWindow.setDepthPrepass);
+                    GUI_UPDATE(deferredRendering, appWindow.isDeferredRendering(), appWindow.setDeferredRendering);
+                    GUI_UPDATE(contactShadows, appWindow.isContactShadows(), appWindow.setContactShadows);
+                    GUI_UPDATE(staticShadowCache, appWindow.isStaticShadowCache(), appWindow.setStaticShadowCache);
+                    GUI_UPDATE(contactShadowLength, appWindow.getContactShadowLength(), appWindow.setContactShadowLength);
+                    if (shadowTileSize != SHADOW_TILE_SIZES[currShadowTileSizeIndex])
+                    {
+                        shadowTileSize = SHADOW_TILE_SIZES[currShadowTileSizeIndex];
+                        appWindow.setShadowTileSize(shadowTileSize);
+                    }
+                    GUI_UPDATE(virtualShadowMap, appWindow.isVirtualShadowMap(), appWindow.setVirtualShadowMap);
+                    GUI_UPDATE(incrementalShadowMaps, appWindow.isIncrementalShadowMaps(), appWindow.setIncrementalShadowMaps);
+                    if (lightAutoFit || sdsm)
+                    {
+                        // the fitted clipping planes become the starting point once auto-fit is disabled
+                        dirClip = glm::vec2(dirData.nearZ, dirData.farZ);
+                        spotClip = glm::vec2(spotData.nearZ, spotData.farZ);
+                    }
+                    else
+                    {
+                        GUI_UPDATE(dirClip.x, dirData.nearZ, dirLight->setNearZ);
+                        GUI_UPDATE(dirClip.y, dirData.farZ, dirLight->setFarZ);
+                        GUI_UPDATE(spotClip.x, spotData.nearZ, spotLight->setNearZ);
+                        GUI_UPDATE(spotClip.y, spotData.farZ, spotLight->setFarZ);
+                    }
                 }
                 ImGui::End();
             }
@@ -327,12 +480,12 @@ int main(int argc, char** argv)
         {
             if (!genScreenshotsWaitFrame)
             {
-                const std::filesystem::path directory = configurator.getFullShadowName();
-                appWindow.takeScreenshot(directory / configurator.formatParams(benchmarkParams[currentScreenshotIndex]));
-                if (++currentScreenshotIndex < benchmarkParams.size())
+                const std::filesystem::path directory = configurator->getFullShadowName();
+                appWindow.takeScreenshot(directory / configurator->formatParamSet(currentScreenshotIndex));
+                if (++currentScreenshotIndex < benchmarkParamCount)
                 {
                     genScreenshotsWaitFrame = true;
-                    configurator.applyParams(benchmarkParams[currentScreenshotIndex]);
+                    configurator->applyParamSet(currentScreenshotIndex);
                     if (resourceManager.reworkShaderFiles())
                     {
                         resourceManager.updateShaders();
@@ -340,8 +493,12 @@ int main(int argc, char** argv)
                 }
                 else {
                     genScreenshotsRunning = false;
+                    appWindow.setShadowMaskForced(false); // not a GUI option, so nothing else restores it after the denoiser sets
                     SHADOW_INFO("Finished generating screenshots!");
-                    if (closeWindowAfterGenScreenshots) {
+                    if (nextSweepTechnique()) {
+                        genScreenshotsStarting = true;
+                    }
+                    else if (closeWindowAfterGenScreenshots) {
                         appWindow.close();
                     }
                 }
@@ -352,25 +509,21 @@ int main(int argc, char** argv)
         }
         else if (genScreenshotsStarting)
         {
+            beginSweep();
             genScreenshotsRunning = true;
             genScreenshotsStarting = false;
             currentScreenshotIndex = 0U;
             genScreenshotsWaitFrame = true;
             if (useBestBenchmark) {
-                SHADOW_INFO("Running screenshot gen. for best params only:");
-                benchmarkParams.clear();
-                std::map<unsigned int, ShadowParams> bestParams = configurator.getBestParams();
-                for (const auto& pair : bestParams) {
-                    SHADOW_INFO("For {} FPS -> {}", pair.first, configurator.formatParams(pair.second));
-                    benchmarkParams.push_back(pair.second);
-                }
+                SHADOW_INFO("Running {} screenshot gen. for best params only:", configurator->getShadowName());
             }
             else {
-                SHADOW_INFO("Running screenshot gen. for all params...");
-                benchmarkParams = configurator.getAllParams();
+                SHADOW_INFO("Running {} screenshot gen. for all params...", configurator->getShadowName());
             }
-            SHADOW_INFO("Generating {} screenshots...", benchmarkParams.size());
-            configurator.applyParams(benchmarkParams[currentScreenshotIndex]);
+            benchmarkParamCount = configurator->selectParamSets(useBestBenchmark);
+            prewarmParamSets(benchmarkParamCount);
+            SHADOW_INFO("Generating {} screenshots...", benchmarkParamCount);
+            configurator->applyParamSet(currentScreenshotIndex);
             if (resourceManager.reworkShaderFiles())
             {
                 resourceManager.updateShaders();
@@ -384,45 +537,75 @@ int main(int argc, char** argv)
                 currentBenchmarkTime += timeDelta;
                 if (currentBenchmarkTime >= BENCHMARK_TIME)
                 {
-                    benchmarkCsv << configurator.formatCsv(benchmarkParams[currentBenchmarkIndex]) << '\t' << configurator.formatCommonCsv(currentBenchmarkFrameCount, currentBenchmarkTime) << std::endl;
-                    SHADOW_INFO("[BM] {}% ({}/{}): {} -> {} ({} FPS)", (currentBenchmarkIndex + 1) * static_cast<size_t>(100) / benchmarkParams.size(), currentBenchmarkIndex + 1, benchmarkParams.size(), configurator.formatParams(benchmarkParams[currentBenchmarkIndex]), currentBenchmarkFrameCount, currentBenchmarkFrameCount / currentBenchmarkTime);
+                    benchmarkCsv << configurator->formatParamSetCsv(currentBenchmarkIndex) << '\t' << configurator->formatCommonCsv(currentBenchmarkFrameCount, currentBenchmarkTime) << std::endl;
+                    SHADOW_INFO("[BM] {}% ({}/{}): {} -> {} ({} FPS)", (currentBenchmarkIndex + 1) * static_cast<size_t>(100) / benchmarkParamCount, currentBenchmarkIndex + 1, benchmarkParamCount, configurator->formatParamSet(currentBenchmarkIndex), currentBenchmarkFrameCount, currentBenchmarkFrameCount / currentBenchmarkTime);
                     currentBenchmarkTime = 0.0f;
                     currentBenchmarkFrameCount = 0U;
                     ++currentBenchmarkIndex;
-                    if (currentBenchmarkIndex < benchmarkParams.size())
+                    if (currentBenchmarkIndex < benchmarkParamCount)
                     {
                         benchmarkWaitFrame = true;
-                        configurator.applyParams(benchmarkParams[currentBenchmarkIndex]);
+                        configurator->applyParamSet(currentBenchmarkIndex);
                         if (resourceManager.reworkShaderFiles())
                         {
                             resourceManager.updateShaders();
                         }
                     }
                     else {
-                        const std::filesystem::path csvFile = (std::filesystem::path(configurator.getFullShadowName()) / ((useBestBenchmark ? (configurator.getShadowName() + "_Best") : configurator.getShadowName()) + ".csv"));
-                        FILE* file{};
-                        if (int err = fopen_s(&file, csvFile.generic_string().c_str(), "w"); err != 0) {
-                            constexpr size_t BUFFER_SIZE = 256;
-                            char buffer[BUFFER_SIZE];
-                            strerror_s(buffer, BUFFER_SIZE, err);
-                            SHADOW_ERROR("Failed to open file '{}' for writing! {}", csvFile.generic_string(), buffer);
-                            throw std::runtime_error("Failed to open output CSV file!");
+                        const std::filesystem::path csvFile = (std::filesystem::path(configurator->getFullShadowName()) / ((useBestBenchmark ? (configurator->getShadowName() + "_Best") : configurator->getShadowName()) + ".csv"));
+                        writeCsv(csvFile);
+                        benchmarkRunning = false;
+                        appWindow.setShadowMaskForced(false);
+                        SHADOW_INFO("[BM] Benchmark finished! CSV: '{}'", csvFile.generic_string());
+                        if (nextSweepTechnique())
+                        {
+                            benchmarkStarting = true;
                         }
-                        std::string csvString = benchmarkCsv.str();
-                        benchmarkCsv.clear();
-                        size_t written = fwrite(csvString.c_str(), 1, csvString.length(), file);
-                        if (written != csvString.length()) {
-                            SHADOW_ERROR("Attempted to write {} bytes to '{}', but wrote only {}!", csvString.length(), csvFile.generic_string(), written);
+                        else if (closeWindowAfterBenchmark)
+                        {
+                            appWindow.close();
                         }
-                        if (int err = fclose(file); err != 0) {
-                            constexpr size_t BUFFER_SIZE = 256;
-                            char buffer[BUFFER_SIZE];
-                            strerror_s(buffer, BUFFER_SIZE, err);
-                            SHADOW_ERROR("Failed to close file '{}'! {}", csvFile.generic_string(), buffer);
+                    }
+                }
+            }
+            else {
+                benchmarkWaitFrame = false;
+            }
+        }
+        else if (lightSweepRunning)
+        {
+            if (!benchmarkWaitFrame)
+            {
+                ++currentBenchmarkFrameCount;
+                currentBenchmarkTime += timeDelta;
+                if (currentBenchmarkTime >= BENCHMARK_TIME)
+                {
+                    const unsigned int sweepLightCount = LIGHT_COUNTS[currentLightCountIndex];
+                    if (currentLightCountIndex == 0U)
+                    {
+                        baseFrameTime = currentBenchmarkTime * 1000.0 / currentBenchmarkFrameCount;
+                    }
+                    benchmarkCsv << configurator->formatLightSweepCsv(sweepLightCount, currentBenchmarkFrameCount, currentBenchmarkTime, baseFrameTime) << std::endl;
+                    SHADOW_INFO("[BM] Lights {} ({}/{}): {} ({} FPS)", sweepLightCount, currentLightCountIndex + 1, LIGHT_COUNTS.size(), currentBenchmarkFrameCount, currentBenchmarkFrameCount / currentBenchmarkTime);
+                    currentBenchmarkTime = 0.0f;
+                    currentBenchmarkFrameCount = 0U;
+                    ++currentLightCountIndex;
+                    if (currentLightCountIndex < LIGHT_COUNTS.size())
+                    {
+                        benchmarkWaitFrame = true;
+                        configurator->applyLightCount(LIGHT_COUNTS[currentLightCountIndex]);
+                    }
+                    else {
+                        const std::filesystem::path csvFile = (std::filesystem::path(configurator->getFullShadowName()) / (configurator->getShadowName() + "_Lights.csv"));
+                        writeCsv(csvFile);
+                        configurator->applyLightCount(lightCount);
+                        lightSweepRunning = false;
+                        SHADOW_INFO("[BM] Light count sweep finished! CSV: '{}'", csvFile.generic_string());
+                        if (nextSweepTechnique())
+                        {
+                            lightSweepStarting = true;
                         }
-                        benchmarkRunning = false;
-                        SHADOW_INFO("[BM] Benchmark finished! CSV: '{}'", csvFile.generic_string());
-                        if (closeWindowAfterBenchmark)
+                        else if (closeWindowAfterBenchmark)
                         {
                             appWindow.close();
                         }
@@ -436,39 +619,50 @@ int main(int argc, char** argv)
         else {
             if (benchmarkStarting)
             {
+                beginSweep();
                 benchmarkRunning = true;
                 benchmarkStarting = false;
                 currentBenchmarkTime = 0.0f;
                 currentBenchmarkIndex = 0U;
                 currentBenchmarkFrameCount = 0U;
                 if (useBestBenchmark) {
-                    SHADOW_INFO("Running benchmark of best params only:");
-                    benchmarkParams.clear();
-                    std::map<unsigned int, ShadowParams> bestParams = configurator.getBestParams();
-                    for (const auto& pair : bestParams) {
-                        SHADOW_INFO("For {} FPS -> {}", pair.first, configurator.formatParams(pair.second));
-                        benchmarkParams.push_back(pair.second);
-                    }
+                    SHADOW_INFO("Running {} benchmark of best params only:", configurator->getShadowName());
                 }
                 else {
-                    SHADOW_INFO("Running benchmark of all params...");
-                    benchmarkParams = configurator.getAllParams();
+                    SHADOW_INFO("Running {} benchmark of all params...", configurator->getShadowName());
                 }
+                benchmarkParamCount = configurator->selectParamSets(useBestBenchmark);
+                prewarmParamSets(benchmarkParamCount);
                 benchmarkCsv.clear();
-                benchmarkCsv << configurator.getCsvHeader() << '\t' << configurator.getCommonCsvHeader() << std::endl;
+                benchmarkCsv << configurator->getCsvHeader() << '\t' << configurator->getCommonCsvHeader() << std::endl;
                 benchmarkWaitFrame = true;
-                std::filesystem::create_directory(std::filesystem::path(configurator.getFullShadowName()));
-                configurator.applyParams(benchmarkParams[currentBenchmarkIndex]);
+                std::filesystem::create_directory(std::filesystem::path(configurator->getFullShadowName()));
+                configurator->applyParamSet(currentBenchmarkIndex);
                 if (resourceManager.reworkShaderFiles())
                 {
                     resourceManager.updateShaders();
                 }
-                int estimatedSeconds = static_cast<int>(benchmarkParams.size() * BENCHMARK_TIME + 0.5f);
+                int estimatedSeconds = static_cast<int>(benchmarkParamCount * BENCHMARK_TIME + 0.5f);
                 int estimatedMinutes = estimatedSeconds / 60;
                 estimatedSeconds %= 60;
                 int estimatedHours = estimatedMinutes / 60;
                 estimatedMinutes %= 60;
-                SHADOW_INFO("[BM] Beginning benchmark! Estimated time: [{}h:{}m:{}s] ({}s benchmark, {} parameter sets)", estimatedHours, estimatedMinutes, estimatedSeconds, BENCHMARK_TIME, benchmarkParams.size());
+                SHADOW_INFO("[BM] Beginning benchmark! Estimated time: [{}h:{}m:{}s] ({}s benchmark, {} parameter sets)", estimatedHours, estimatedMinutes, estimatedSeconds, BENCHMARK_TIME, benchmarkParamCount);
+            }
+            else if (lightSweepStarting)
+            {
+                beginSweep();
+                lightSweepRunning = true;
+                lightSweepStarting = false;
+                currentBenchmarkTime = 0.0f;
+                currentLightCountIndex = 0U;
+                currentBenchmarkFrameCount = 0U;
+                benchmarkCsv.str({});
+                benchmarkCsv << configurator->getLightSweepCsvHeader() << std::endl;
+                benchmarkWaitFrame = true;
+                std::filesystem::create_directory(std::filesystem::path(configurator->getFullShadowName()));
+                configurator->applyLightCount(LIGHT_COUNTS[currentLightCountIndex]);
+                SHADOW_INFO("[BM] Beginning light count sweep! Estimated time: {}s ({}s benchmark, {} light counts)", LIGHT_COUNTS.size() * BENCHMARK_TIME, BENCHMARK_TIME, LIGHT_COUNTS.size());
             }
             else {
                 if (screenshotState == 2)
@@ -3,6 +3,7 @@
 #include "ShadowUtils.h"
 
 #include <stb_image_write.h>
+#include <algorithm>
 
 static void glfw_error_callback(int error, const char* description)
 {
@@ -88,40 +89,91 @@ bool shadow::AppWindow::initialize(GLsizei width, GLsizei height, GLsizei lightT
         return false;
     }
 
+    // the shadow term of the directional light in red, of the spot light in green, their penumbra radii for the denoiser in blue and alpha
+    if (!shadowMaskFramebuffer.initialize(false, GL_COLOR_ATTACHMENT0, GL_RGBA8, width, height, GL_RGBA, GL_UNSIGNED_BYTE, GL_NEAREST, GL_CLAMP_TO_EDGE))
+    {
+        return false;
+    }
+
+    // the accumulated shadow terms in red and green, the view depth for the disocclusion test in blue
+    for (Framebuffer& shadowHistoryFramebuffer : shadowHistoryFramebuffers)
+    {
+        if (!shadowHistoryFramebuffer.initialize(false, GL_COLOR_ATTACHMENT0, GL_RGBA16F, width, height, GL_RGBA, GL_FLOAT, GL_LINEAR, GL_CLAMP_TO_EDGE))
+        {
+            return false;
+        }
+    }
+
+    // the contact shadow of the directional light in red, of the spot light in green
+    if (!contactShadowFramebuffer.initialize(false, GL_COLOR_ATTACHMENT0, GL_RG8, width, height, GL_RG, GL_UNSIGNED_BYTE, GL_NEAREST, GL_CLAMP_TO_EDGE))
+    {
+        return false;
+    }
+
+    // albedo and metalness, the octahedral normal and roughness, then the geometric normal for the shadows, on top of the depth of the main framebuffer
+    if (!gBufferFramebuffer.initialize(false, GL_COLOR_ATTACHMENT0, GL_RGBA8, width, height, GL_RGBA, GL_UNSIGNED_BYTE, GL_NEAREST, GL_CLAMP_TO_EDGE)
+        || !gBufferFramebuffer.addColorTexture(GL_RGB10_A2, GL_RGBA, GL_UNSIGNED_INT_2_10_10_10_REV)
+        || !gBufferFramebuffer.addColorTexture(GL_RG16, GL_RG, GL_UNSIGNED_SHORT))
+    {
+        return false;
+    }
+    gBufferFramebuffer.attachDepthTexture(mainFramebuffer.getDepthTexture());
+
+    // the shaders start out specialized for the default technique, so its includes are needed before they are loaded
+    shadowRenderer = ShadowRenderer::create(DEFAULT_SHADOW_TECHNIQUE);
     ResourceManager& resourceManager = ResourceManager::getInstance();
-    if (!resourceManager.initialize(resourceDirectory, width, height))
+    if (!resourceManager.initialize(resourceDirectory, width, height, shadowRenderer->getShaderIncludes()))
     {
         return false;
     }
 
-#if SHADOW_MASTER || SHADOW_CHSS
-    if (!LightManager::getInstance().initialize(lightTextureSize, width, height))
+    if (!shadowRenderer->initialize(lightTextureSize, width, height))
     {
         return false;
     }
-#else
-    if (!LightManager::getInstance().initialize(lightTextureSize))
+    shadowRenderer->activate();
+
+    if (!depthReduction.initialize(resourceManager.getShader(ShaderType::DepthBounds)))
+    {
+        return false;
+    }
+
+    if (!lightClusters.initialize(resourceManager.getShader(ShaderType::LightClustering)))
+    {
+        return false;
+    }
+
+    if (!dirVirtualShadowMap.initialize(resourceManager.getShader(ShaderType::DepthDirVirtual), resourceManager.getShader(ShaderType::PageMarking),
+        VIRTUAL_PAGE_SIZE, VIRTUAL_PAGES, VIRTUAL_POOL_PAGES))
+    {
+        return false;
+    }
+
+    if (!blueNoise.initialize(BLUE_NOISE_SIZE))
+    {
+        return false;
+    }
+
+    if (!shadowTiles.initialize(resourceManager.getShader(ShaderType::ShadowTiles), width, height, DEFAULT_SHADOW_TILE_SIZE))
+    {
+        return false;
+    }
+
+    if (!shadowDenoiser.initialize(resourceManager.getShader(ShaderType::ShadowDenoise), width, height))
     {
         return false;
     }
-#endif
 
     this->ppShader = resourceManager.getShader(ShaderType::PostProcess);
-#if SHADOW_VSM
-    this->depthDirShader = resourceManager.getShader(ShaderType::DepthDirVSM);
-    this->depthSpotShader = resourceManager.getShader(ShaderType::DepthSpotVSM);
-    this->blurShader = resourceManager.getShader(ShaderType::GaussianBlur);
-#else
-    this->depthDirShader = resourceManager.getShader(ShaderType::DepthDir);
-    this->depthSpotShader = resourceManager.getShader(ShaderType::DepthSpot);
-#endif
-#if SHADOW_MASTER || SHADOW_CHSS
-    this->dirPenumbraShader = resourceManager.getShader(ShaderType::DirPenumbra);
-    this->spotPenumbraShader = resourceManager.getShader(ShaderType::SpotPenumbra);
-#endif
+    this->depthCameraShader = resourceManager.getShader(ShaderType::DepthCamera);
+    this->shadowMaskShader = resourceManager.getShader(ShaderType::ShadowMask);
+    this->deferredLightingShader = resourceManager.getShader(ShaderType::DeferredLighting);
+    this->contactShadowShader = resourceManager.getShader(ShaderType::ContactShadows);
+    this->shadowTemporalShader = resourceManager.getShader(ShaderType::ShadowTemporal);
     this->uboMvp = resourceManager.getUboMvp();
     this->uboLights = resourceManager.getUboLights();
     this->uboWindow = resourceManager.getUboWindow();
+    this->uboSampling = resourceManager.getUboSampling();
     this->dirLight = uboLights->getDirectionalLight();
     this->spotLight = uboLights->getSpotLight();
     this->width = width;
@@ -130,7 +182,7 @@ bool shadow::AppWindow::initialize(GLsizei width, GLsizei height, GLsizei lightT
     glm::vec2 windowSize{ width, height };
     uboWindow->setWindowSize(windowSize);
 
-    updateLightShadowSamplers();
+    updateShadowMaps();
 
     camera = std::make_shared<Camera>(
         static_cast<float>(width) / static_cast<float>(height),
@@ -183,37 +235,297 @@ void shadow::AppWindow::resize(GLsizei width, GLsizei height)
     this->width = width;
     this->height = height;
     mainFramebuffer.resize(width, height);
+    shadowTiles.resize(width, height);
+    shadowMaskFramebuffer.resize(width, height);
+    shadowDenoiser.resize(width, height);
+    contactShadowFramebuffer.resize(width, height);
+    for (Framebuffer& shadowHistoryFramebuffer : shadowHistoryFramebuffers)
+    {
+        shadowHistoryFramebuffer.resize(width, height);
+    }
+    shadowHistoryValid = false;
+    gBufferFramebuffer.resize(width, height);
+    gBufferFramebuffer.attachDepthTexture(mainFramebuffer.getDepthTexture());
+    shadowRenderer->resizeWindow(width, height);
+    updateLightShadowSamplers();
     camera->setAspectRatio(static_cast<float>(width) / static_cast<float>(height));
     glm::vec2 windowSize{ width, height };
     uboWindow->setWindowSize(windowSize);
 }
 
-#if SHADOW_MASTER || SHADOW_CHSS
-void shadow::AppWindow::resizeLights(GLsizei textureSize, unsigned int penumbraTextureSizeDivisor)
+bool shadow::AppWindow::setShadowTechnique(ShadowTechnique technique)
 {
-    assert(penumbraTextureSizeDivisor);
-    LightManager::getInstance().resize(textureSize, width / penumbraTextureSizeDivisor, height / penumbraTextureSizeDivisor);
-    updateLightShadowSamplers();
+    assert(shadowRenderer);
+    if (shadowRenderer->getTechnique() == technique)
+    {
+        return true;
+    }
+    std::unique_ptr<ShadowRenderer> renderer = ShadowRenderer::create(technique);
+    if (!renderer || !renderer->initialize(shadowRenderer->getTextureSize(), width, height))
+    {
+        return false;
+    }
+    SHADOW_DEBUG("Switching shadow technique to {}...", renderer->getName());
+    // only the resources of the current technique are kept alive
+    shadowRenderer = std::move(renderer);
+    shadowRenderer->activate();
+    if (!shadowRenderer->hasDepthMaps())
+    {
+        setVirtualShadowMap(false);
+        setIncrementalShadowMaps(false);
+    }
+    shadowHistoryValid = false;
+    updateShadowMaps();
+    return true;
 }
-#else
+
+shadow::ShadowTechnique shadow::AppWindow::getShadowTechnique() const
+{
+    return getShadowRenderer().getTechnique();
+}
+
+shadow::ShadowRenderer& shadow::AppWindow::getShadowRenderer() const
+{
+    assert(shadowRenderer);
+    return *shadowRenderer;
+}
+
 void shadow::AppWindow::resizeLights(GLsizei textureSize)
 {
-    LightManager::getInstance().resize(textureSize);
+    // the maps are bound again once the loop notices the new revision
+    shadowRenderer->resize(textureSize);
+}
+
+void shadow::AppWindow::updateShadowMaskUsage()
+{
+    uboSampling->setDeferredShadows(isShadowMaskResolved());
+}
+
+bool shadow::AppWindow::isShadowMaskResolved() const
+{
+    return deferredShadows || temporalShadows || shadowDenoiseIterations > 0U || shadowMaskForced;
+}
+
+void shadow::AppWindow::setLightAutoFit(bool lightAutoFit)
+{
+    this->lightAutoFit = lightAutoFit;
+    dirLight->setAutoFit(lightAutoFit || sdsm);
+    spotLight->setAutoFit(lightAutoFit || sdsm);
+}
+
+bool shadow::AppWindow::isLightAutoFit() const
+{
+    return lightAutoFit;
+}
+
+void shadow::AppWindow::setSdsm(bool sdsm)
+{
+    this->sdsm = sdsm;
+    dirReceiverViewBounds = spotReceiverViewBounds = BoundingBox{};
+    dirLight->setAutoFit(lightAutoFit || sdsm);
+    spotLight->setAutoFit(lightAutoFit || sdsm);
+}
+
+bool shadow::AppWindow::isSdsm() const
+{
+    return sdsm;
+}
+
+void shadow::AppWindow::setVirtualShadowMap(bool virtualShadowMap)
+{
+    assert(!virtualShadowMap || shadowRenderer->hasDepthMaps());
+    this->virtualShadowMap = virtualShadowMap;
+    ResourceManager::getInstance().updateVirtualShadowMap(virtualShadowMap, VIRTUAL_PAGES, VIRTUAL_POOL_PAGES);
+    dirVirtualShadowMap.invalidate();
+    dirIncrementalShadowMap.invalidate(); // the regular map is not rendered while the virtual one is used
     updateLightShadowSamplers();
 }
-#endif
 
-#if SHADOW_VSM
-void shadow::AppWindow::setBlurPasses(unsigned int blurPasses)
+bool shadow::AppWindow::isVirtualShadowMap() const
+{
+    return virtualShadowMap;
+}
+
+void shadow::AppWindow::setIncrementalShadowMaps(bool incrementalShadowMaps)
+{
+    assert(!incrementalShadowMaps || shadowRenderer->hasDepthMaps());
+    this->incrementalShadowMaps = incrementalShadowMaps;
+    shadowChangeTracker.reset();
+    dirIncrementalShadowMap.invalidate();
+    spotIncrementalShadowMap.invalidate();
+}
+
+bool shadow::AppWindow::isIncrementalShadowMaps() const
+{
+    return incrementalShadowMaps;
+}
+
+void shadow::AppWindow::setStaticShadowCache(bool staticShadowCache)
+{
+    this->staticShadowCache = staticShadowCache;
+    shadowChangeTracker.reset();
+    dirStaticShadowCache.invalidate();
+    spotStaticShadowCache.invalidate();
+}
+
+bool shadow::AppWindow::isStaticShadowCache() const
+{
+    return staticShadowCache;
+}
+
+void shadow::AppWindow::setAnimatedNoise(bool animatedNoise)
 {
-    this->blurPasses = blurPasses;
+    blueNoise.setAnimated(animatedNoise);
+    uboSampling->setNoiseOffset(blueNoise.getOffset());
 }
 
-unsigned int shadow::AppWindow::getBlurPasses() const
+bool shadow::AppWindow::isAnimatedNoise() const
 {
-    return blurPasses;
+    return blueNoise.isAnimated();
 }
+
+void shadow::AppWindow::setShadowTileClassification(bool shadowTileClassification)
+{
+    this->shadowTileClassification = shadowTileClassification;
+    uboSampling->setShadowTileSize(shadowTileClassification ? static_cast<unsigned int>(shadowTiles.getTileSize()) : 0U);
+}
+
+bool shadow::AppWindow::isShadowTileClassification() const
+{
+    return shadowTileClassification;
+}
+
+void shadow::AppWindow::setShadowTileSize(GLsizei shadowTileSize)
+{
+    shadowTiles.setTileSize(shadowTileSize);
+    setShadowTileClassification(shadowTileClassification);
+    updateLightShadowSamplers();
+}
+
+GLsizei shadow::AppWindow::getShadowTileSize() const
+{
+    return shadowTiles.getTileSize();
+}
+
+void shadow::AppWindow::setDeferredShadows(bool deferredShadows)
+{
+    this->deferredShadows = deferredShadows;
+    updateShadowMaskUsage();
+}
+
+bool shadow::AppWindow::isDeferredShadows() const
+{
+    return deferredShadows;
+}
+
+void shadow::AppWindow::setTemporalShadows(bool temporalShadows)
+{
+    this->temporalShadows = temporalShadows;
+    shadowHistoryValid = false;
+    // the accumulated terms are resolved into the shadow mask as well
+    updateShadowMaskUsage();
+}
+
+bool shadow::AppWindow::isTemporalShadows() const
+{
+    return temporalShadows;
+}
+
+void shadow::AppWindow::setTemporalHistoryWeight(float temporalHistoryWeight)
+{
+    assert(temporalHistoryWeight >= 0.0f && temporalHistoryWeight < 1.0f);
+    this->temporalHistoryWeight = temporalHistoryWeight;
+}
+
+float shadow::AppWindow::getTemporalHistoryWeight() const
+{
+    return temporalHistoryWeight;
+}
+
+void shadow::AppWindow::setShadowDenoiseIterations(unsigned int shadowDenoiseIterations)
+{
+    assert(shadowDenoiseIterations <= ShadowDenoiser::MAX_ITERATIONS);
+    this->shadowDenoiseIterations = shadowDenoiseIterations;
+    // the denoiser filters the resolved shadow mask
+    updateShadowMaskUsage();
+}
+
+unsigned int shadow::AppWindow::getShadowDenoiseIterations() const
+{
+    return shadowDenoiseIterations;
+}
+
+void shadow::AppWindow::setShadowDenoiseKernelRadius(unsigned int shadowDenoiseKernelRadius)
+{
+    assert(shadowDenoiseKernelRadius > 0U && shadowDenoiseKernelRadius <= ShadowDenoiser::MAX_KERNEL_RADIUS);
+    this->shadowDenoiseKernelRadius = shadowDenoiseKernelRadius;
+}
+
+unsigned int shadow::AppWindow::getShadowDenoiseKernelRadius() const
+{
+    return shadowDenoiseKernelRadius;
+}
+
+void shadow::AppWindow::setShadowMaskForced(bool shadowMaskForced)
+{
+    this->shadowMaskForced = shadowMaskForced;
+    updateShadowMaskUsage();
+}
+
+bool shadow::AppWindow::isShadowMaskForced() const
+{
+    return shadowMaskForced;
+}
+
+void shadow::AppWindow::setDepthPrepass(bool depthPrepass)
+{
+    this->depthPrepass = depthPrepass;
+}
+
+bool shadow::AppWindow::isDepthPrepass() const
+{
+    return depthPrepass;
+}
+
+void shadow::AppWindow::setDeferredRendering(bool deferredRendering)
+{
+#ifdef RENDER_SHADOW_ONLY
+    // the G-buffer holds material inputs and the lighting pass shades them, neither has a shadow-only variant
+    if (deferredRendering)
+    {
+        SHADOW_WARN("Deferred rendering is not available when rendering shadows only!");
+        return;
+    }
 #endif
+    this->deferredRendering = deferredRendering;
+}
+
+bool shadow::AppWindow::isDeferredRendering() const
+{
+    return deferredRendering;
+}
+
+void shadow::AppWindow::setContactShadows(bool contactShadows)
+{
+    this->contactShadows = contactShadows;
+    uboSampling->setContactShadows(contactShadows);
+}
+
+bool shadow::AppWindow::isContactShadows() const
+{
+    return contactShadows;
+}
+
+void shadow::AppWindow::setContactShadowLength(float contactShadowLength)
+{
+    assert(contactShadowLength > 0.0f);
+    this->contactShadowLength = contactShadowLength;
+}
+
+float shadow::AppWindow::getContactShadowLength() const
+{
+    return contactShadowLength;
+}
 
 void shadow::AppWindow::takeScreenshot(const std::filesystem::path& filePath) const
 {
@@ -282,31 +594,81 @@ void shadow::AppWindow::updateLightShadowSamplers()
     ResourceManager& resourceManager = ResourceManager::getInstance();
     std::vector<std::shared_ptr<GLShader>> shaders{
         resourceManager.getShader(ShaderType::Material),
-        resourceManager.getShader(ShaderType::Texture)
+        resourceManager.getShader(ShaderType::Texture),
+        resourceManager.getShader(ShaderType::ShadowMask),
+        resourceManager.getShader(ShaderType::DeferredLighting)
     };
-    LightManager& lightManager = LightManager::getInstance();
+    GLuint dirShadowTexture = virtualShadowMap ? dirVirtualShadowMap.getTexture() : shadowRenderer->getDirTexture();
     for (const std::shared_ptr<GLShader>& shader : shaders)
     {
         shader->use();
-#if SHADOW_MASTER || SHADOW_CHSS
-        glActiveTexture(GL_TEXTURE10);
-        glBindTexture(GL_TEXTURE_2D, lightManager.getDirTexture());
-        glActiveTexture(GL_TEXTURE11);
-        glBindTexture(GL_TEXTURE_2D, lightManager.getDirPenumbraTexture());
-        glActiveTexture(GL_TEXTURE12);
-        glBindTexture(GL_TEXTURE_2D, lightManager.getSpotTexture());
-        glActiveTexture(GL_TEXTURE13);
-        glBindTexture(GL_TEXTURE_2D, lightManager.getSpotPenumbraTexture());
-#else
-        glActiveTexture(GL_TEXTURE10);
-        glBindTexture(GL_TEXTURE_2D, lightManager.getDirTexture());
-        glActiveTexture(GL_TEXTURE11);
-        glBindTexture(GL_TEXTURE_2D, lightManager.getSpotTexture());
-#endif
+        shadowRenderer->bindShadowTextures(dirShadowTexture);
+        glActiveTexture(GL_TEXTURE15);
+        glBindTexture(GL_TEXTURE_2D, dirVirtualShadowMap.getPageTable());
+        glActiveTexture(GL_TEXTURE18);
+        glBindTexture(GL_TEXTURE_2D, blueNoise.getTexture());
+        glActiveTexture(GL_TEXTURE19);
+        glBindTexture(GL_TEXTURE_2D, shadowTiles.getTexture());
+        glActiveTexture(GL_TEXTURE20);
+        glBindTexture(GL_TEXTURE_2D, shadowMaskFramebuffer.getTexture());
+        glActiveTexture(GL_TEXTURE21);
+        glBindTexture(GL_TEXTURE_2D, contactShadowFramebuffer.getTexture());
     }
     glActiveTexture(GL_TEXTURE0);
-#if SHADOW_VSM
-    this->blurShader->use();
-    this->blurShader->setVec2("resolution", glm::vec2(lightManager.getTextureSize(), lightManager.getTextureSize()));
-#endif
+}
+
+void shadow::AppWindow::updateShadowMaps()
+{
+    // the maps were recreated or whatever they were rendered with has changed, so nothing kept from them is valid anymore
+    dirIncrementalShadowMap.invalidate();
+    spotIncrementalShadowMap.invalidate();
+    dirStaticShadowCache.invalidate();
+    spotStaticShadowCache.invalidate();
+    shadowRendererRevision = shadowRenderer->getRevision();
+    updateLightShadowSamplers();
+}
+
+void shadow::AppWindow::fitLights()
+{
+    BoundingBox sceneBounds = scene->getWorldBounds();
+    if (!sceneBounds.isValid())
+    {
+        return;
+    }
+    // there is no point in covering the part of the camera frustum that lies beyond the scene
+    glm::vec3 cameraPosition = camera->getPosition();
+    glm::vec3 cameraDirection = camera->getDirection();
+    float sceneFarZ = camera->getNearZ();
+    for (const glm::vec3& corner : sceneBounds.getCorners())
+    {
+        sceneFarZ = glm::max(sceneFarZ, dot(corner - cameraPosition, cameraDirection));
+    }
+    float farZ = glm::min(camera->getFarZ(), sceneFarZ);
+    BoundingBox receiverBounds = sceneBounds.intersection(BoundingBox::fromPoints(camera->getFrustumCorners(camera->getNearZ(), farZ)));
+    if (sdsm)
+    {
+        depthReduction.poll(dirReceiverViewBounds, spotReceiverViewBounds);
+    }
+    // the CPU-side bounds are used until the first depth reduction result arrives,
+    // the virtual shadow map covers the whole scene so that its cached pages survive camera movement
+    if (virtualShadowMap)
+    {
+        dirLight->fitToBounds(sceneBounds, sceneBounds);
+    }
+    else if (sdsm && dirReceiverViewBounds.isValid())
+    {
+        dirLight->fitToViewBounds(sceneBounds, dirReceiverViewBounds);
+    }
+    else if (receiverBounds.isValid())
+    {
+        dirLight->fitToBounds(sceneBounds, receiverBounds);
+    }
+    if (sdsm && spotReceiverViewBounds.isValid())
+    {
+        spotLight->fitToViewBounds(sceneBounds, spotReceiverViewBounds);
+    }
+    else if (receiverBounds.isValid())
+    {
+        spotLight->fitToBounds(sceneBounds, receiverBounds);
+    }
 }
@@ -6,11 +6,20 @@
 #include "Scene.h"
 #include "Framebuffer.h"
 #include "ResourceManager.h"
-#include "LightManager.h"
+#include "ShadowRenderer.h"
+#include "DepthReduction.h"
+#include "VirtualShadowMap.h"
+#include "IncrementalShadowMap.h"
+#include "StaticShadowCache.h"
+#include "LightClusters.h"
+#include "BlueNoise.h"
+#include "ShadowTileClassification.h"
+#include "ShadowDenoiser.h"
 
 #include "glad/glad.h"
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
@@ -35,15 +44,47 @@ namespace shadow
         void loop(double& timeDelta, F& guiProc);
         void setClearColor(const glm::vec4& clearColor);
         void resize(GLsizei width, GLsizei height);
-#if SHADOW_MASTER || SHADOW_CHSS
-        void resizeLights(GLsizei textureSize, unsigned int penumbraTextureSizeDivisor);
-#else
+        bool setShadowTechnique(ShadowTechnique technique);
+        ShadowTechnique getShadowTechnique() const;
+        ShadowRenderer& getShadowRenderer() const;
         void resizeLights(GLsizei textureSize);
-#endif
-#if SHADOW_VSM
-        void setBlurPasses(unsigned int blurPasses);
-        unsigned int getBlurPasses() const;
-#endif
+        void setLightAutoFit(bool lightAutoFit);
+        bool isLightAutoFit() const;
+        void setSdsm(bool sdsm);
+        bool isSdsm() const;
+        void setVirtualShadowMap(bool virtualShadowMap);
+        bool isVirtualShadowMap() const;
+        void setIncrementalShadowMaps(bool incrementalShadowMaps);
+        bool isIncrementalShadowMaps() const;
+        void setStaticShadowCache(bool staticShadowCache);
+        bool isStaticShadowCache() const;
+        void setAnimatedNoise(bool animatedNoise);
+        bool isAnimatedNoise() const;
+        void setShadowTileClassification(bool shadowTileClassification);
+        bool isShadowTileClassification() const;
+        void setShadowTileSize(GLsizei shadowTileSize);
+        GLsizei getShadowTileSize() const;
+        void setDeferredShadows(bool deferredShadows);
+        bool isDeferredShadows() const;
+        void setTemporalShadows(bool temporalShadows);
+        bool isTemporalShadows() const;
+        void setTemporalHistoryWeight(float temporalHistoryWeight);
+        float getTemporalHistoryWeight() const;
+        void setShadowDenoiseIterations(unsigned int shadowDenoiseIterations);
+        unsigned int getShadowDenoiseIterations() const;
+        void setShadowDenoiseKernelRadius(unsigned int shadowDenoiseKernelRadius);
+        unsigned int getShadowDenoiseKernelRadius() const;
+        // keeps the shadow mask resolved even when no option uses it, so that the options can be measured against the mask alone
+        void setShadowMaskForced(bool shadowMaskForced);
+        bool isShadowMaskForced() const;
+        void setDepthPrepass(bool depthPrepass);
+        bool isDepthPrepass() const;
+        void setDeferredRendering(bool deferredRendering);
+        bool isDeferredRendering() const;
+        void setContactShadows(bool contactShadows);
+        bool isContactShadows() const;
+        void setContactShadowLength(float contactShadowLength);
+        float getContactShadowLength() const;
         void takeScreenshot(const std::filesystem::path& filePath) const;
         double getTime() const;
         unsigned int getFps() const;
@@ -52,27 +93,50 @@ namespace shadow
     private:
         AppWindow();
         void updateLightShadowSamplers();
+        void updateShadowMaps();
+        void fitLights();
+        void updateShadowMaskUsage();
+        bool isShadowMaskResolved() const;
         const char* GLSL_VERSION{ "#version 430" };
+        static constexpr GLsizei VIRTUAL_PAGE_SIZE{ 256 };
+        static constexpr unsigned int VIRTUAL_PAGES{ 64U }, VIRTUAL_POOL_PAGES{ 16U }; // 16384x16384 virtual, 4096x4096 physical
+        static constexpr GLsizei BLUE_NOISE_SIZE{ 64 };
+        static constexpr GLsizei DEFAULT_SHADOW_TILE_SIZE{ 16 };
+        static constexpr float CONTACT_SHADOW_THICKNESS{ 0.05f };
         GLsizei width{}, height{};
+        bool lightAutoFit{ false }, sdsm{ false }, virtualShadowMap{ false }, incrementalShadowMaps{ false }, shadowTileClassification{ false }, deferredShadows{ false }, depthPrepass{ false }, deferredRendering{ false }, contactShadows{ false }, staticShadowCache{ false }, temporalShadows{ false }, shadowMaskForced{ false };
+        float contactShadowLength{ 0.1f }, temporalHistoryWeight{ 0.9f };
+        unsigned int shadowDenoiseIterations{ 0U }, shadowDenoiseKernelRadius{ 2U }; // no iterations disable the denoiser
         glm::vec4 clearColor{ 0.0f, 0.0f, 0.0f, 1.0f };
         double currentTime{ 0.0 }, lastTime{ 0.0 };
         unsigned int fpsCounter{ 0U }, fpsSecond{ 1U }, measuredFps{ 0U };
         GLFWwindow* glfwWindow{ nullptr };
         std::shared_ptr<Camera> camera{};
         std::shared_ptr<Scene> scene{};
-        std::shared_ptr<GLShader> ppShader{}, depthDirShader{}, depthSpotShader{};
-#if SHADOW_MASTER || SHADOW_CHSS
-        std::shared_ptr<GLShader> dirPenumbraShader{}, spotPenumbraShader{};
-#elif SHADOW_VSM
-        std::shared_ptr<GLShader> blurShader{};
-        unsigned int blurPasses{ 1U };
-#endif
+        std::shared_ptr<GLShader> ppShader{}, depthCameraShader{}, shadowMaskShader{}, deferredLightingShader{}, contactShadowShader{}, shadowTemporalShader{};
+        std::unique_ptr<ShadowRenderer> shadowRenderer{};
+        unsigned int shadowRendererRevision{};
         std::shared_ptr<UboMvp> uboMvp{};
         std::shared_ptr<UboLights> uboLights{};
         std::shared_ptr<UboWindow> uboWindow{};
+        std::shared_ptr<UboSampling> uboSampling{};
         std::shared_ptr<DirectionalLight> dirLight{};
         std::shared_ptr<SpotLight> spotLight{};
-        Framebuffer mainFramebuffer{};
+        Framebuffer mainFramebuffer{}, shadowMaskFramebuffer{}, gBufferFramebuffer{}, contactShadowFramebuffer{};
+        Framebuffer shadowHistoryFramebuffers[2]{}; // written and read in turns
+        unsigned int shadowHistoryIndex{};
+        bool shadowHistoryValid{};
+        glm::mat4 previousViewProjection{};
+        DepthReduction depthReduction{};
+        LightClusters lightClusters{};
+        BoundingBox dirReceiverViewBounds{}, spotReceiverViewBounds{};
+        BlueNoise blueNoise{};
+        ShadowTileClassification shadowTiles{};
+        ShadowDenoiser shadowDenoiser{};
+        VirtualShadowMap dirVirtualShadowMap{};
+        IncrementalShadowMap dirIncrementalShadowMap{}, spotIncrementalShadowMap{};
+        StaticShadowCache dirStaticShadowCache{}, spotStaticShadowCache{};
+        SceneChangeTracker shadowChangeTracker{};
     };
 
     inline void AppWindow::close() const {
@@ -90,7 +154,6 @@ namespace shadow
     {
         assert(glfwWindow);
         ResourceManager& resourceManager = ResourceManager::getInstance();
-        LightManager& lightManager = LightManager::getInstance();
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
@@ -107,99 +170,264 @@ namespace shadow
             ++fpsCounter;
         }
         lastTime = currentTime;
+        if (lightAutoFit || sdsm)
+        {
+            fitLights();
+        }
         uboLights->update();
+        if (blueNoise.isAnimated() || temporalShadows) // the accumulation needs a differently rotated kernel every frame
+        {
+            blueNoise.nextFrame();
+            uboSampling->setNoiseOffset(blueNoise.getOffset());
+        }
+        if (camera->isViewDirty())
+        {
+            glm::mat4 view = camera->getView();
+            glm::vec3 viewPosition = camera->getPosition();
+            uboMvp->setView(view);
+            uboMvp->setViewPosition(viewPosition);
+        }
+        if (camera->isProjectionDirty())
+        {
+            glm::mat4 projection = camera->getProjection();
+            uboMvp->setProjection(projection);
+        }
+        if (shadowRenderer->getRevision() != shadowRendererRevision)
+        {
+            updateShadowMaps();
+        }
         glEnable(GL_DEPTH_TEST);
         glCullFace(GL_FRONT);
 
+        std::vector<BoundingBox> shadowChanges{};
+        if (incrementalShadowMaps)
+        {
+            shadowChanges = shadowChangeTracker.update(*scene);
+        }
+        else if (staticShadowCache && !shadowChangeTracker.updateCasters(*scene, false).empty())
+        {
+            // a static caster has moved, appeared or disappeared, so the cached maps no longer hold it where it is
+            dirStaticShadowCache.invalidate();
+            spotStaticShadowCache.invalidate();
+        }
+
         GL_PUSH_DEBUG_GROUP("DirLight");
-        glViewport(0, 0, lightManager.getTextureSize(), lightManager.getTextureSize());
-        glBindFramebuffer(GL_FRAMEBUFFER, lightManager.getDirFbo());
-        glClear(GL_DEPTH_BUFFER_BIT);
-        depthDirShader->use();
-        scene->render(depthDirShader);
+        if (virtualShadowMap)
+        {
+            dirVirtualShadowMap.update(*scene, dirLight->getLightSpace());
+        }
+        else if (incrementalShadowMaps)
+        {
+            dirIncrementalShadowMap.update(*scene, shadowRenderer->getDirDepthShader(), shadowRenderer->getDirFbo(), shadowRenderer->getTextureSize(), dirLight->getLightSpace(), shadowChanges);
+        }
+        else if (staticShadowCache)
+        {
+            dirStaticShadowCache.update(*scene, shadowRenderer->getDirDepthShader(), shadowRenderer->getDirFbo(), shadowRenderer->getTextureSize(),
+                shadowRenderer->getColorFormat(), shadowRenderer->getClearColor(), dirLight->getLightSpace());
+        }
+        else
+        {
+            shadowRenderer->renderDirShadowMap(*scene);
+        }
         GL_POP_DEBUG_GROUP();
 
         GL_PUSH_DEBUG_GROUP("SpotLight");
-        glBindFramebuffer(GL_FRAMEBUFFER, lightManager.getSpotFbo());
-        glClear(GL_DEPTH_BUFFER_BIT);
-        depthSpotShader->use();
-        scene->render(depthSpotShader);
+        if (incrementalShadowMaps)
+        {
+            spotIncrementalShadowMap.update(*scene, shadowRenderer->getSpotDepthShader(), shadowRenderer->getSpotFbo(), shadowRenderer->getTextureSize(), spotLight->getLightSpace(), shadowChanges);
+        }
+        else if (staticShadowCache)
+        {
+            spotStaticShadowCache.update(*scene, shadowRenderer->getSpotDepthShader(), shadowRenderer->getSpotFbo(), shadowRenderer->getTextureSize(),
+                shadowRenderer->getColorFormat(), shadowRenderer->getClearColor(), spotLight->getLightSpace());
+        }
+        else
+        {
+            shadowRenderer->renderSpotShadowMap(*scene);
+        }
         GL_POP_DEBUG_GROUP();
 
-#if SHADOW_MASTER || SHADOW_CHSS
-        GL_PUSH_DEBUG_GROUP("DirLightPenumbra");
-        glViewport(0, 0, lightManager.getPenumbraTextureWidth(), lightManager.getPenumbraTextureHeight());
-        glBindFramebuffer(GL_FRAMEBUFFER, lightManager.getDirPenumbraFbo());
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        dirPenumbraShader->use();
-        scene->render(dirPenumbraShader);
-        GL_POP_DEBUG_GROUP();
+        shadowRenderer->renderShadowPasses(*scene, virtualShadowMap);
+
+        glCullFace(GL_BACK);
 
-        GL_PUSH_DEBUG_GROUP("SpotLightPenumbra");
-        glBindFramebuffer(GL_FRAMEBUFFER, lightManager.getSpotPenumbraFbo());
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        spotPenumbraShader->use();
-        scene->render(spotPenumbraShader);
+        // the classification and the shadow mask need the receivers of the frame, the main pass then reuses their depth
+        const bool classifyShadowTiles = shadowTileClassification && shadowRenderer->hasBlockerSearch();
+        const bool resolveShadowMask = isShadowMaskResolved();
+        const bool renderDepthPrepass = depthPrepass || classifyShadowTiles || resolveShadowMask || contactShadows;
+        if (renderDepthPrepass)
+        {
+            GL_PUSH_DEBUG_GROUP("DepthPrepass");
+            glViewport(0, 0, width, height);
+            glBindFramebuffer(GL_FRAMEBUFFER, mainFramebuffer.getFbo());
+            glClear(GL_DEPTH_BUFFER_BIT);
+            glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+            depthCameraShader->use();
+            scene->render(depthCameraShader);
+            glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+            GL_POP_DEBUG_GROUP();
+        }
+
+        if (classifyShadowTiles)
+        {
+            shadowRenderer->classifyTiles(shadowTiles, mainFramebuffer.getDepthTexture(), inverse(camera->getProjection() * camera->getView()), virtualShadowMap);
+        }
+
+        GL_PUSH_DEBUG_GROUP("LightClustering");
+        lightClusters.cull(inverse(camera->getProjection()));
         GL_POP_DEBUG_GROUP();
-#endif
 
-        glCullFace(GL_BACK);
+        if (resolveShadowMask)
+        {
+            // one pass per light, each resolving its own channel of the mask
+            glViewport(0, 0, width, height);
+            glBindFramebuffer(GL_FRAMEBUFFER, shadowMaskFramebuffer.getFbo());
+            glDisable(GL_DEPTH_TEST);
+            glActiveTexture(GL_TEXTURE14);
+            glBindTexture(GL_TEXTURE_2D, mainFramebuffer.getDepthTexture());
+            glActiveTexture(GL_TEXTURE0);
+            shadowMaskShader->use();
+            shadowMaskShader->setMat4("inverseViewProjection", inverse(camera->getProjection() * camera->getView()));
 
-#if SHADOW_VSM
-        GL_PUSH_DEBUG_GROUP("Gaussian blur (DirLight)");
-        glDisable(GL_DEPTH_TEST);
-        blurShader->use();
-        glActiveTexture(GL_TEXTURE12);
-        for (unsigned int i = 0; i < blurPasses; ++i) {
-            glBindFramebuffer(GL_FRAMEBUFFER, lightManager.getTempFbo());
-            blurShader->setVec2("direction", glm::vec2(1.0f, 0.0f));
-            glBindTexture(GL_TEXTURE_2D, lightManager.getDirTexture());
+            GL_PUSH_DEBUG_GROUP("DirShadowMask");
+            glColorMask(GL_TRUE, GL_FALSE, GL_TRUE, GL_FALSE);
+            shadowMaskShader->setInt("light", 0);
             resourceManager.renderQuad();
-            glBindFramebuffer(GL_FRAMEBUFFER, lightManager.getDirFbo());
-            blurShader->setVec2("direction", glm::vec2(0.0f, 1.0f));
-            glBindTexture(GL_TEXTURE_2D, lightManager.getTempTexture());
+            GL_POP_DEBUG_GROUP();
+
+            GL_PUSH_DEBUG_GROUP("SpotShadowMask");
+            glColorMask(GL_FALSE, GL_TRUE, GL_FALSE, GL_TRUE);
+            shadowMaskShader->setInt("light", 1);
             resourceManager.renderQuad();
+            GL_POP_DEBUG_GROUP();
+
+            glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+            GLuint shadowMaskTexture = shadowMaskFramebuffer.getTexture();
+            if (shadowDenoiseIterations > 0U && shadowRenderer->hasBlockerSearch())
+            {
+                // only the soft shadow techniques estimate the penumbra radius the filter footprint is bounded by
+                GL_PUSH_DEBUG_GROUP("ShadowDenoise");
+                shadowMaskTexture = shadowDenoiser.denoise(shadowMaskTexture, mainFramebuffer.getDepthTexture(), inverse(camera->getProjection()),
+                    shadowDenoiseIterations, shadowDenoiseKernelRadius);
+                GL_POP_DEBUG_GROUP();
+            }
+            if (temporalShadows)
+            {
+                // blends the mask with the reprojected history, the shading then reads the accumulated result
+                GL_PUSH_DEBUG_GROUP("ShadowTemporal");
+                const glm::mat4 viewProjection = camera->getProjection() * camera->getView();
+                Framebuffer& historyTarget = shadowHistoryFramebuffers[shadowHistoryIndex];
+                glBindFramebuffer(GL_FRAMEBUFFER, historyTarget.getFbo());
+                glActiveTexture(GL_TEXTURE0);
+                glBindTexture(GL_TEXTURE_2D, shadowMaskTexture);
+                glActiveTexture(GL_TEXTURE1);
+                glBindTexture(GL_TEXTURE_2D, shadowHistoryFramebuffers[1U - shadowHistoryIndex].getTexture());
+                glActiveTexture(GL_TEXTURE0);
+                shadowTemporalShader->use();
+                shadowTemporalShader->setMat4("inverseViewProjection", inverse(viewProjection));
+                shadowTemporalShader->setMat4("previousViewProjection", previousViewProjection);
+                shadowTemporalShader->setFloat("historyWeight", temporalHistoryWeight);
+                shadowTemporalShader->setBool("historyValid", shadowHistoryValid);
+                resourceManager.renderQuad();
+                shadowMaskTexture = historyTarget.getTexture();
+                shadowHistoryIndex = 1U - shadowHistoryIndex;
+                shadowHistoryValid = true;
+                previousViewProjection = viewProjection;
+                GL_POP_DEBUG_GROUP();
+            }
+            glActiveTexture(GL_TEXTURE20);
+            glBindTexture(GL_TEXTURE_2D, shadowMaskTexture);
+            glActiveTexture(GL_TEXTURE0);
+            glEnable(GL_DEPTH_TEST);
         }
-        GL_POP_DEBUG_GROUP();
 
-        GL_PUSH_DEBUG_GROUP("Gaussian blur (SpotLight)");
-        glDisable(GL_DEPTH_TEST);
-        blurShader->use();
-        glActiveTexture(GL_TEXTURE12);
-        for (unsigned int i = 0; i < blurPasses; ++i) {
-            glBindFramebuffer(GL_FRAMEBUFFER, lightManager.getTempFbo());
-            blurShader->setVec2("direction", glm::vec2(1.0f, 0.0f));
-            glBindTexture(GL_TEXTURE_2D, lightManager.getSpotTexture());
-            resourceManager.renderQuad();
-            glBindFramebuffer(GL_FRAMEBUFFER, lightManager.getSpotFbo());
-            blurShader->setVec2("direction", glm::vec2(0.0f, 1.0f));
-            glBindTexture(GL_TEXTURE_2D, lightManager.getTempTexture());
+        if (contactShadows)
+        {
+            GL_PUSH_DEBUG_GROUP("ContactShadows");
+            glViewport(0, 0, width, height);
+            glBindFramebuffer(GL_FRAMEBUFFER, contactShadowFramebuffer.getFbo());
+            glDisable(GL_DEPTH_TEST);
+            glActiveTexture(GL_TEXTURE14);
+            glBindTexture(GL_TEXTURE_2D, mainFramebuffer.getDepthTexture());
+            glActiveTexture(GL_TEXTURE18);
+            glBindTexture(GL_TEXTURE_2D, blueNoise.getTexture());
+            glActiveTexture(GL_TEXTURE0);
+            contactShadowShader->use();
+            contactShadowShader->setMat4("inverseViewProjection", inverse(camera->getProjection() * camera->getView()));
+            contactShadowShader->setFloat("rayLength", contactShadowLength);
+            contactShadowShader->setFloat("thickness", CONTACT_SHADOW_THICKNESS);
             resourceManager.renderQuad();
+            glEnable(GL_DEPTH_TEST);
+            GL_POP_DEBUG_GROUP();
         }
-        glActiveTexture(GL_TEXTURE0);
-        GL_POP_DEBUG_GROUP();
-        glEnable(GL_DEPTH_TEST);
-#endif
 
         GL_PUSH_DEBUG_GROUP("Main render");
         glViewport(0, 0, width, height);
-        glBindFramebuffer(GL_FRAMEBUFFER, mainFramebuffer.getFbo());
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        if (camera->isViewDirty())
+        glBindFramebuffer(GL_FRAMEBUFFER, deferredRendering ? gBufferFramebuffer.getFbo() : mainFramebuffer.getFbo());
+        if (renderDepthPrepass)
         {
-            glm::mat4 view = camera->getView();
-            glm::vec3 viewPosition = camera->getPosition();
-            uboMvp->setView(view);
-            uboMvp->setViewPosition(viewPosition);
+            // only the visible fragment of every pixel passes, so each one is shaded exactly once
+            glClear(GL_COLOR_BUFFER_BIT);
+            glDepthFunc(GL_EQUAL);
+            glDepthMask(GL_FALSE);
         }
-        if (camera->isProjectionDirty())
+        else
         {
-            glm::mat4 projection = camera->getProjection();
-            uboMvp->setProjection(projection);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        }
+        if (deferredRendering)
+        {
+            scene->renderSubstituted({
+                { ShaderType::Material, ShaderType::GBufferMaterial },
+                { ShaderType::Texture, ShaderType::GBufferTexture } });
+        }
+        else
+        {
+            scene->render();
         }
-        scene->render();
+        glDepthFunc(GL_LESS);
+        glDepthMask(GL_TRUE);
         GL_POP_DEBUG_GROUP();
 
+        if (deferredRendering)
+        {
+            // the depth is shared, so it stays in place for the passes reading it later on
+            GL_PUSH_DEBUG_GROUP("DeferredLighting");
+            glBindFramebuffer(GL_FRAMEBUFFER, mainFramebuffer.getFbo());
+            glClear(GL_COLOR_BUFFER_BIT);
+            glDisable(GL_DEPTH_TEST);
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, gBufferFramebuffer.getTexture(0U));
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, gBufferFramebuffer.getTexture(1U));
+            glActiveTexture(GL_TEXTURE2);
+            glBindTexture(GL_TEXTURE_2D, gBufferFramebuffer.getTexture(2U));
+            glActiveTexture(GL_TEXTURE14);
+            glBindTexture(GL_TEXTURE_2D, mainFramebuffer.getDepthTexture());
+            glActiveTexture(GL_TEXTURE0);
+            deferredLightingShader->use();
+            deferredLightingShader->setMat4("inverseViewProjection", inverse(camera->getProjection() * camera->getView()));
+            resourceManager.renderQuad();
+            glEnable(GL_DEPTH_TEST);
+            GL_POP_DEBUG_GROUP();
+        }
+
+        if (sdsm)
+        {
+            GL_PUSH_DEBUG_GROUP("DepthReduction");
+            depthReduction.reduce(mainFramebuffer.getDepthTexture(), width, height,
+                inverse(camera->getProjection() * camera->getView()), dirLight->getFittingView(), spotLight->getFittingView());
+            GL_POP_DEBUG_GROUP();
+        }
+
+        if (virtualShadowMap)
+        {
+            GL_PUSH_DEBUG_GROUP("PageMarking");
+            dirVirtualShadowMap.markPages(mainFramebuffer.getDepthTexture(), width, height,
+                inverse(camera->getProjection() * camera->getView()), dirLight->getLightSpace());
+            GL_POP_DEBUG_GROUP();
+        }
+
         GL_PUSH_DEBUG_GROUP("PostProcess");
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
         glDisable(GL_DEPTH_TEST);
@@ -1,33 +1,108 @@
 #pragma once
 #include "AppWindow.h"
+#include "DepthShadowRenderers.h"
+#include "MomentShadowRenderers.h"
+
+#include <random>
 
 static const inline std::vector<unsigned int> MAP_SIZES = { 256, 512, 768, 1024, 1280, 1536, 1792, 2048, 2560, 3072, 3584, 4096 };
 static const inline std::vector<unsigned int> FILTER_SIZES = { 1,3,5,7,9,11,15,19,23,27,31 };
 static const inline std::vector<unsigned int> BLUR_PASSES = { 1,2,3,4,5 };
+static const inline std::vector<unsigned int> BLUR_RADII = { 2,4,8,16 };
+static const inline std::vector<unsigned int> MOMENT_BITS = { 16,32 };
+static const inline std::vector<float> EVSM_POSITIVE_EXPONENTS = { 5.0f,10.0f,20.0f,40.0f };
+static const inline std::vector<float> EVSM_NEGATIVE_EXPONENTS = { 5.0f,10.0f };
+static const inline std::vector<float> EVSM_MIP_BIASES = { 0.0f,0.5f,1.0f,2.0f };
 static const inline std::vector<unsigned int> SHADOW_SAMPLES = { 4,8,12,16,32 };
 static const inline std::vector<unsigned int> PENUMBRA_SAMPLES = { 8,16,24,32 };
-static const inline std::vector<unsigned int> PENUMBRA_MAP_DIVISORS = { 1,2,4,8 };
+static const inline std::vector<unsigned int> PENUMBRA_MAP_DIVISORS = { 1,2,4,8,16 };
+static const inline std::vector<unsigned int> EARLY_OUT_SAMPLES = { 0,4,8 }; // 0 disables the early-out ring
+static const inline std::vector<float> SAMPLES_PER_TEXEL = { 0.0f,0.5f,2.0f }; // 0 always takes the full sample count, only the vogel disks are reduced
+static const inline std::vector<bool> ANIMATED_NOISE = { false,true };
+static const inline std::vector<unsigned int> DENOISE_ITERATIONS = { 0,1,2,3 }; // 0 disables the shadow denoiser
+static const inline std::vector<unsigned int> DENOISE_KERNEL_RADII = { 1,2 };
+static const inline std::vector<unsigned int> LIGHT_COUNTS = { 2,4,8,16,32,64,128,256,512,1024 }; // including the directional and spot light
 
 namespace shadow {
-    template<typename Params>
-    class ShadowConfigurator {
+    // technique independent part of a configurator, each shadow renderer owns the one of its technique
+    class TechniqueConfigurator {
     public:
-        ShadowConfigurator(AppWindow& appWindow, ResourceManager& resourceManager) : appWindow(appWindow), resourceManager(resourceManager) {}
-        virtual ~ShadowConfigurator() = default;
-        virtual void applyParams(const Params& params) = 0;
+        TechniqueConfigurator(const ShadowRenderer& shadowRenderer, AppWindow& appWindow, ResourceManager& resourceManager) : appWindow(appWindow), resourceManager(resourceManager), shadowRenderer(shadowRenderer) {}
+        virtual ~TechniqueConfigurator() = default;
+        ShadowTechnique getTechnique() const {
+            return shadowRenderer.getTechnique();
+        }
+        std::string getShadowName() const {
+            return getShadowTechniqueName(getTechnique());
+        }
         std::string getFullShadowName() const {
+            std::string name = getShadowName();
+            if (appWindow.isSdsm())
+            {
+                name += "_SDSM";
+            }
+            else if (appWindow.isLightAutoFit())
+            {
+                name += "_AutoFit";
+            }
+            if (appWindow.isVirtualShadowMap())
+            {
+                name += "_Virtual";
+            }
+            if (appWindow.isIncrementalShadowMaps())
+            {
+                name += "_Incremental";
+            }
+            else if (appWindow.isStaticShadowCache())
+            {
+                name += "_StaticCache";
+            }
+            if (appWindow.isShadowTileClassification() && shadowRenderer.hasBlockerSearch())
+            {
+                name += fmt::format("_Tiles{}", appWindow.getShadowTileSize());
+            }
+            if (appWindow.isDeferredShadows())
+            {
+                name += "_Deferred";
+            }
+            if (appWindow.isTemporalShadows())
+            {
+                name += "_Temporal";
+            }
+            if (appWindow.isDepthPrepass())
+            {
+                name += "_Prepass";
+            }
+            if (appWindow.isDeferredRendering())
+            {
+                name += "_GBuffer";
+            }
+            if (appWindow.isContactShadows())
+            {
+                name += "_Contact";
+            }
 #ifdef RENDER_SHADOW_ONLY
-            return getShadowName() + "_Shadows";
+            return name + "_Shadows";
 #else
-            return getShadowName();
+            return name;
 #endif
         }
-        virtual std::string getShadowName() const = 0;
+        // clipping planes tuned for the test scene, as every technique copes with depth precision differently
+        virtual void applyLightSetup(DirectionalLight& dirLight, SpotLight& spotLight) const {
+            dirLight.setLightSize(0.09f);
+            dirLight.setProjectionSize(1.45f);
+            dirLight.setNearZ(0.2f);
+            dirLight.setFarZ(1.5f);
+            spotLight.setLightSize(0.09f);
+            spotLight.setNearZ(0.95f);
+            spotLight.setFarZ(2.35f);
+        }
         virtual std::string getCsvHeader() const = 0;
-        virtual std::string formatCsv(const Params& params) const = 0;
-        virtual std::string formatParams(const Params& params) const = 0;
-        virtual std::vector<Params> getAllParams() const = 0;
-        virtual std::map<unsigned int, Params> getBestParams() const = 0;
+        // picks the parameter sets a benchmark or screenshot run iterates over and returns their count
+        virtual size_t selectParamSets(bool best) = 0;
+        virtual void applyParamSet(size_t index) = 0;
+        virtual std::string formatParamSetCsv(size_t index) const = 0;
+        virtual std::string formatParamSet(size_t index) const = 0;
         static std::string getCommonCsvHeader() {
             return "Avg. FPS\tTotal frames\tBenchmark time [s]";
         }
@@ -35,44 +110,144 @@ namespace shadow {
         {
             return fmt::format("{}\t{}\t{}", frames / benchmarkTime, frames, benchmarkTime);
         }
+        // scatters lightCount - 2 point lights around the furniture, the same seed keeps smaller sets a prefix of larger ones
+        void applyLightCount(unsigned int lightCount) {
+            std::vector<PointLightData> pointLights{};
+            std::mt19937 generator(1U);
+            std::uniform_real_distribution<float> horizontal(-1.2f, 1.2f), vertical(0.05f, 1.2f), radius(0.3f, 0.8f), color(0.2f, 1.0f);
+            for (unsigned int i = 2U; i < lightCount; ++i) {
+                PointLightData light{};
+                light.position = glm::vec3(horizontal(generator), vertical(generator), horizontal(generator));
+                light.radius = radius(generator);
+                light.color = glm::vec3(color(generator), color(generator), color(generator));
+                light.strength = 0.5f;
+                pointLights.push_back(light);
+            }
+            resourceManager.getSsboPointLights()->set(pointLights);
+        }
+        static std::string getLightSweepCsvHeader() {
+            return "Lights\t" + getCommonCsvHeader() + "\tFrame time [ms]\tMarginal cost per light [ms]";
+        }
+        // the marginal cost is relative to the two light baseline
+        static std::string formatLightSweepCsv(unsigned int lightCount, size_t frames, double benchmarkTime, double baseFrameTime)
+        {
+            double frameTime = benchmarkTime * 1000.0 / frames;
+            double marginalCost = lightCount > LIGHT_COUNTS.front() ? (frameTime - baseFrameTime) / (lightCount - LIGHT_COUNTS.front()) : 0.0;
+            return fmt::format("{}\t{}\t{}\t{}", lightCount, formatCommonCsv(frames, benchmarkTime), frameTime, marginalCost);
+        }
     protected:
+        void applyDenoiser(unsigned int denoiseIterations, unsigned int denoiseKernelRadius, bool shadowMask) {
+            appWindow.setShadowMaskForced(shadowMask);
+            appWindow.setShadowDenoiseIterations(denoiseIterations);
+            if (denoiseIterations > 0U) {
+                appWindow.setShadowDenoiseKernelRadius(denoiseKernelRadius);
+            }
+        }
         AppWindow& appWindow;
         ResourceManager& resourceManager;
+    private:
+        const ShadowRenderer& shadowRenderer;
+    };
+
+    template<typename Params>
+    class ShadowConfigurator : public TechniqueConfigurator {
+    public:
+        ShadowConfigurator(const ShadowRenderer& shadowRenderer, AppWindow& appWindow, ResourceManager& resourceManager) : TechniqueConfigurator(shadowRenderer, appWindow, resourceManager) {}
+        virtual void applyParams(const Params& params) = 0;
+        virtual std::string formatCsv(const Params& params) const = 0;
+        virtual std::string formatParams(const Params& params) const = 0;
+        virtual std::vector<Params> getAllParams() const = 0;
+        virtual std::map<unsigned int, Params> getBestParams() const = 0;
+        size_t selectParamSets(bool best) override {
+            if (best) {
+                paramSets.clear();
+                for (const auto& pair : getBestParams()) {
+                    SHADOW_INFO("For {} FPS -> {}", pair.first, formatParams(pair.second));
+                    paramSets.push_back(pair.second);
+                }
+            }
+            else {
+                paramSets = getAllParams();
+            }
+            return paramSets.size();
+        }
+        void applyParamSet(size_t index) override {
+            applyParams(paramSets.at(index));
+        }
+        std::string formatParamSetCsv(size_t index) const override {
+            return formatCsv(paramSets.at(index));
+        }
+        std::string formatParamSet(size_t index) const override {
+            return formatParams(paramSets.at(index));
+        }
+    private:
+        std::vector<Params> paramSets{};
     };
 
-#if SHADOW_MASTER || SHADOW_CHSS
+    // the denoiser dimensions shared by the soft shadow techniques, without iterations the kernel radius makes no difference
+    using DenoiserParams = std::pair<unsigned int, unsigned int>;
+    inline std::vector<DenoiserParams> getDenoiserParams() {
+        std::vector<DenoiserParams> result;
+        for (unsigned int denoiseIterations : DENOISE_ITERATIONS) {
+            for (unsigned int denoiseKernelRadius : DENOISE_KERNEL_RADII) {
+                result.emplace_back(denoiseIterations, denoiseKernelRadius);
+                if (denoiseIterations == 0U) {
+                    break;
+                }
+            }
+        }
+        return result;
+    }
+
+    // sweeps a single dimension against the shadow samples around a base set, which keeps it out of the full cross product
+    template<typename Params, typename Values, typename Setter>
+    void appendSideSweep(std::vector<Params>& result, const Params& base, const Values& values, Setter setter) {
+        for (const auto& value : values) {
+            for (unsigned int shadowSamples : SHADOW_SAMPLES) {
+                Params params = base;
+                params.shadowSamples = shadowSamples;
+                setter(params, value);
+                result.push_back(params);
+            }
+        }
+    }
+
     struct MasterCHSSParams {
         unsigned int mapSize{};
         unsigned int penumbraMapDivisor{};
         unsigned int shadowSamples{};
         unsigned int penumbraSamples{};
+        unsigned int earlyOutSamples{};
+        float samplesPerTexel{};
+        unsigned int denoiseIterations{};
+        unsigned int denoiseKernelRadius{};
+        bool animatedNoise{};
+        bool shadowMask{}; // resolves the shadow mask regardless of the denoiser, which isolates the cost of its passes
     };
-    using ShadowParams = MasterCHSSParams;
-    class Configurator : public ShadowConfigurator<ShadowParams> {
+    // both techniques share their parameters, they only differ in how the vogel disk is sampled
+    class MasterCHSSConfigurator : public ShadowConfigurator<MasterCHSSParams> {
     public:
-        Configurator(AppWindow& appWindow, ResourceManager& resourceManager) : ShadowConfigurator(appWindow, resourceManager) {}
-        void applyParams(const ShadowParams& params) override {
-            appWindow.resizeLights(params.mapSize, params.penumbraMapDivisor);
-            resourceManager.updateVogelDisk(params.shadowSamples, params.penumbraSamples);
-        }
-        std::string getShadowName() const override {
-#if SHADOW_MASTER
-            return "Master";
-#else
-            return "CHSS";
-#endif
+        MasterCHSSConfigurator(PenumbraShadowRenderer& renderer, AppWindow& appWindow, ResourceManager& resourceManager) : ShadowConfigurator(renderer, appWindow, resourceManager), renderer(renderer) {}
+        void applyParams(const MasterCHSSParams& params) override {
+            appWindow.resizeLights(params.mapSize);
+            renderer.setPenumbraTextureSizeDivisor(params.penumbraMapDivisor);
+            renderer.setSamples(params.shadowSamples, params.penumbraSamples);
+            renderer.setEarlyOutSamples(params.earlyOutSamples);
+            renderer.setSamplesPerTexel(params.samplesPerTexel);
+            applyDenoiser(params.denoiseIterations, params.denoiseKernelRadius, params.shadowMask);
+            appWindow.setAnimatedNoise(params.animatedNoise);
         }
         std::string getCsvHeader() const override {
-            return "Map size\tPenumbra texture size divisor\tShadow samples\tPenumbra samples";
+            return "Map size\tPenumbra texture size divisor\tShadow samples\tPenumbra samples\tEarly-out samples\tSamples per texel\tDenoise iterations\tDenoise kernel radius\tAnimated noise\tShadow mask";
         }
-        std::string formatCsv(const ShadowParams& params) const override {
-            return fmt::format("{}\t{}\t{}\t{}", params.mapSize, params.penumbraMapDivisor, params.shadowSamples, params.penumbraSamples);
+        std::string formatCsv(const MasterCHSSParams& params) const override {
+            return fmt::format("{}\t{}\t{}\t{}\t{}\t{}\t{}\t{}\t{}\t{}", params.mapSize, params.penumbraMapDivisor, params.shadowSamples, params.penumbraSamples, params.earlyOutSamples, params.samplesPerTexel, params.denoiseIterations, params.denoiseKernelRadius, params.animatedNoise, params.shadowMask);
         }
-        std::string formatParams(const ShadowParams& params) const override {
-            return fmt::format("{}_{}_{}_{}_{}", getShadowName(), params.mapSize, params.penumbraMapDivisor, params.shadowSamples, params.penumbraSamples);
+        std::string formatParams(const MasterCHSSParams& params) const override {
+            return fmt::format("{}_{}_{}_{}_{}_{}_{}_{}_{}_{}_{}", getShadowName(), params.mapSize, params.penumbraMapDivisor, params.shadowSamples, params.penumbraSamples, params.earlyOutSamples, params.samplesPerTexel, params.denoiseIterations, params.denoiseKernelRadius, params.animatedNoise, params.shadowMask);
         }
-        std::vector<ShadowParams> getAllParams() const override {
-            std::vector<ShadowParams> result;
+        std::vector<MasterCHSSParams> getAllParams() const override {
+            std::vector<MasterCHSSParams> result;
             for (unsigned int mapSize : MAP_SIZES) {
                 for (unsigned int penumbraMapDivisor : PENUMBRA_MAP_DIVISORS)
                 {
@@ -85,51 +260,69 @@ namespace shadow {
                     }
                 }
             }
+            // the adaptive sampling thresholds are swept one at a time around the middle best set
+            appendSideSweep(result, getBestParams().at(800U), EARLY_OUT_SAMPLES, [](MasterCHSSParams& params, unsigned int earlyOutSamples) { params.earlyOutSamples = earlyOutSamples; });
+            appendSideSweep(result, getBestParams().at(800U), SAMPLES_PER_TEXEL, [](MasterCHSSParams& params, float samplesPerTexel) { params.samplesPerTexel = samplesPerTexel; });
+            // the animated noise only pays off with temporal accumulation, so it is swept around the middle best set as well
+            appendSideSweep(result, getBestParams().at(800U), ANIMATED_NOISE, [](MasterCHSSParams& params, bool animatedNoise) { params.animatedNoise = animatedNoise; });
+            // every denoiser set resolves the mask, so the sets without iterations are the baseline of its own passes
+            appendSideSweep(result, getBestParams().at(800U), getDenoiserParams(), [](MasterCHSSParams& params, const DenoiserParams& denoiser) {
+                params.denoiseIterations = denoiser.first;
+                params.denoiseKernelRadius = denoiser.second;
+                params.shadowMask = true;
+            });
             return result;
         }
-        std::map<unsigned int, ShadowParams> getBestParams() const override {
-            std::map<unsigned int, ShadowParams> result{
-#if SHADOW_MASTER
-                {1200, {896,2,14,14}},
-                {800, {2048,4,18,18}},
-                {400, {3776,4,20,20}}
-#else
+        std::map<unsigned int, MasterCHSSParams> getBestParams() const override {
+            if (getTechnique() == ShadowTechnique::Master) {
+                return {
+                    {1200, {896,2,14,14}},
+                    {800, {2048,4,18,18}},
+                    {400, {3776,4,20,20}}
+                };
+            }
+            return {
                 {1200, {832,2,12,14}},
                 {800, {2048,4,16,16}},
                 {400, {3776,4,20,20}}
-#endif
             };
-            return result;
         }
+    private:
+        PenumbraShadowRenderer& renderer;
     };
-#elif SHADOW_PCSS
+
     struct PCSSParams {
         unsigned int mapSize{};
         unsigned int shadowSamples{};
         unsigned int penumbraSamples{};
+        unsigned int earlyOutSamples{};
+        unsigned int denoiseIterations{};
+        unsigned int denoiseKernelRadius{};
+        bool animatedNoise{};
+        bool shadowMask{};
     };
-    using ShadowParams = PCSSParams;
-    class Configurator : public ShadowConfigurator<ShadowParams> {
+    // the samples of the fixed Poisson disk are not reduced per texel, a prefix of it would not cover the kernel evenly
+    class PCSSConfigurator : public ShadowConfigurator<PCSSParams> {
     public:
-        Configurator(AppWindow& appWindow, ResourceManager& resourceManager) : ShadowConfigurator(appWindow, resourceManager) {}
-        void applyParams(const ShadowParams& params) override {
+        PCSSConfigurator(PCSSShadowRenderer& renderer, AppWindow& appWindow, ResourceManager& resourceManager) : ShadowConfigurator(renderer, appWindow, resourceManager), renderer(renderer) {}
+        void applyParams(const PCSSParams& params) override {
             appWindow.resizeLights(params.mapSize);
-            resourceManager.updatePoisson(params.shadowSamples, params.penumbraSamples);
-        }
-        std::string getShadowName() const override {
-            return "PCSS";
+            renderer.setSamples(params.shadowSamples, params.penumbraSamples);
+            renderer.setEarlyOutSamples(params.earlyOutSamples);
+            applyDenoiser(params.denoiseIterations, params.denoiseKernelRadius, params.shadowMask);
+            appWindow.setAnimatedNoise(params.animatedNoise);
         }
         std::string getCsvHeader() const override {
-            return "Map size\tShadow samples\tPenumbra samples";
+            return "Map size\tShadow samples\tPenumbra samples\tEarly-out samples\tDenoise iterations\tDenoise kernel radius\tAnimated noise\tShadow mask";
         }
-        std::string formatCsv(const ShadowParams& params) const override {
-            return fmt::format("{}\t{}\t{}", params.mapSize, params.shadowSamples, params.penumbraSamples);
+        std::string formatCsv(const PCSSParams& params) const override {
+            return fmt::format("{}\t{}\t{}\t{}\t{}\t{}\t{}\t{}", params.mapSize, params.shadowSamples, params.penumbraSamples, params.earlyOutSamples, params.denoiseIterations, params.denoiseKernelRadius, params.animatedNoise, params.shadowMask);
         }
-        std::string formatParams(const ShadowParams& params) const override {
-            return fmt::format("{}_{}_{}_{}", getShadowName(), params.mapSize, params.shadowSamples, params.penumbraSamples);
+        std::string formatParams(const PCSSParams& params) const override {
+            return fmt::format("{}_{}_{}_{}_{}_{}_{}_{}_{}", getShadowName(), params.mapSize, params.shadowSamples, params.penumbraSamples, params.earlyOutSamples, params.denoiseIterations, params.denoiseKernelRadius, params.animatedNoise, params.shadowMask);
         }
-        std::vector<ShadowParams> getAllParams() const override {
-            std::vector<ShadowParams> result;
+        std::vector<PCSSParams> getAllParams() const override {
+            std::vector<PCSSParams> result;
             for (unsigned int mapSize : MAP_SIZES) {
                 for (unsigned int shadowSamples : SHADOW_SAMPLES)
                 {
@@ -139,88 +332,213 @@ namespace shadow {
                     }
                 }
             }
+            appendSideSweep(result, getBestParams().at(800U), EARLY_OUT_SAMPLES, [](PCSSParams& params, unsigned int earlyOutSamples) { params.earlyOutSamples = earlyOutSamples; });
+            appendSideSweep(result, getBestParams().at(800U), ANIMATED_NOISE, [](PCSSParams& params, bool animatedNoise) { params.animatedNoise = animatedNoise; });
+            appendSideSweep(result, getBestParams().at(800U), getDenoiserParams(), [](PCSSParams& params, const DenoiserParams& denoiser) {
+                params.denoiseIterations = denoiser.first;
+                params.denoiseKernelRadius = denoiser.second;
+                params.shadowMask = true;
+            });
             return result;
         }
-        std::map<unsigned int, ShadowParams> getBestParams() const override {
-            std::map<unsigned int, ShadowParams> result{
+        std::map<unsigned int, PCSSParams> getBestParams() const override {
+            std::map<unsigned int, PCSSParams> result{
                 {1200, {768,12,12}},
                 {800, {1728,16,16}},
                 {400, {3072,20,20}}
             };
             return result;
         }
+    private:
+        PCSSShadowRenderer& renderer;
     };
-#elif SHADOW_VSM
+
     struct VSMParams {
         unsigned int mapSize{};
         unsigned int blurPasses{};
+        unsigned int blurRadius{};
     };
-    using ShadowParams = VSMParams;
-    class Configurator : public ShadowConfigurator<ShadowParams> {
+    class VSMConfigurator : public ShadowConfigurator<VSMParams> {
     public:
-        Configurator(AppWindow& appWindow, ResourceManager& resourceManager) : ShadowConfigurator(appWindow, resourceManager) {}
-        void applyParams(const ShadowParams& params) override {
+        VSMConfigurator(VSMShadowRenderer& renderer, AppWindow& appWindow, ResourceManager& resourceManager) : ShadowConfigurator(renderer, appWindow, resourceManager), renderer(renderer) {}
+        void applyLightSetup(DirectionalLight& dirLight, SpotLight& spotLight) const override {
+            TechniqueConfigurator::applyLightSetup(dirLight, spotLight);
+            dirLight.setNearZ(0.3f);
+            dirLight.setFarZ(2.0f);
+            spotLight.setNearZ(1.45f);
+            spotLight.setFarZ(2.5f);
+        }
+        void applyParams(const VSMParams& params) override {
             appWindow.resizeLights(params.mapSize);
-            appWindow.setBlurPasses(params.blurPasses);
+            renderer.setBlurPasses(params.blurPasses);
+            renderer.setBlurRadius(params.blurRadius);
+        }
+        std::string getCsvHeader() const override {
+            return "Map size\tBlur passes\tBlur radius";
+        }
+        std::string formatCsv(const VSMParams& params) const override {
+            return fmt::format("{}\t{}\t{}", params.mapSize, params.blurPasses, params.blurRadius);
+        }
+        std::string formatParams(const VSMParams& params) const override {
+            return fmt::format("{}_{}_{}_{}", getShadowName(), params.mapSize, params.blurPasses, params.blurRadius);
+        }
+        std::vector<VSMParams> getAllParams() const override {
+            std::vector<VSMParams> result;
+            for (unsigned int mapSize : MAP_SIZES) {
+                for (unsigned int blurPasses : BLUR_PASSES)
+                {
+                    for (unsigned int blurRadius : BLUR_RADII)
+                    {
+                        result.push_back({ mapSize, blurPasses, blurRadius });
+                    }
+                }
+            }
+            return result;
         }
-        std::string getShadowName() const override {
-            return "VSM";
+        std::map<unsigned int, VSMParams> getBestParams() const override {
+            std::map<unsigned int, VSMParams> result{
+                {1200, {1728,1,2}},
+                {800, {2496,1,2}},
+                {400, {4032,1,2}}
+            };
+            return result;
+        }
+    private:
+        VSMShadowRenderer& renderer;
+    };
+
+    struct MSMParams {
+        unsigned int mapSize{};
+        unsigned int blurPasses{};
+        unsigned int blurRadius{};
+        unsigned int momentBits{};
+    };
+    class MSMConfigurator : public ShadowConfigurator<MSMParams> {
+    public:
+        MSMConfigurator(MSMShadowRenderer& renderer, AppWindow& appWindow, ResourceManager& resourceManager) : ShadowConfigurator(renderer, appWindow, resourceManager), renderer(renderer) {}
+        void applyParams(const MSMParams& params) override {
+            appWindow.resizeLights(params.mapSize);
+            renderer.setBlurPasses(params.blurPasses);
+            renderer.setBlurRadius(params.blurRadius);
+            renderer.setMomentBits(params.momentBits);
         }
         std::string getCsvHeader() const override {
-            return "Map size\tBlur passes";
+            return "Map size\tBlur passes\tBlur radius\tMoment bits";
         }
-        std::string formatCsv(const ShadowParams& params) const override {
-            return fmt::format("{}\t{}", params.mapSize, params.blurPasses);
+        std::string formatCsv(const MSMParams& params) const override {
+            return fmt::format("{}\t{}\t{}\t{}", params.mapSize, params.blurPasses, params.blurRadius, params.momentBits);
         }
-        std::string formatParams(const ShadowParams& params) const override {
-            return fmt::format("{}_{}_{}", getShadowName(), params.mapSize, params.blurPasses);
+        std::string formatParams(const MSMParams& params) const override {
+            return fmt::format("{}_{}_{}_{}_{}", getShadowName(), params.mapSize, params.blurPasses, params.blurRadius, params.momentBits);
         }
-        std::vector<ShadowParams> getAllParams() const override {
-            std::vector<ShadowParams> result;
+        std::vector<MSMParams> getAllParams() const override {
+            std::vector<MSMParams> result;
             for (unsigned int mapSize : MAP_SIZES) {
                 for (unsigned int blurPasses : BLUR_PASSES)
                 {
-                    result.push_back({ mapSize, blurPasses });
+                    for (unsigned int blurRadius : BLUR_RADII)
+                    {
+                        for (unsigned int momentBits : MOMENT_BITS)
+                        {
+                            result.push_back({ mapSize, blurPasses, blurRadius, momentBits });
+                        }
+                    }
+                }
+            }
+            return result;
+        }
+        std::map<unsigned int, MSMParams> getBestParams() const override {
+            std::map<unsigned int, MSMParams> result{
+                {1200, {1280,1,2,16}},
+                {800, {2048,1,2,16}},
+                {400, {3072,1,4,32}}
+            };
+            return result;
+        }
+    private:
+        MSMShadowRenderer& renderer;
+    };
+
+    struct EVSMParams {
+        unsigned int mapSize{};
+        float positiveExponent{};
+        float negativeExponent{};
+        float mipBias{};
+    };
+    class EVSMConfigurator : public ShadowConfigurator<EVSMParams> {
+    public:
+        EVSMConfigurator(EVSMShadowRenderer& renderer, AppWindow& appWindow, ResourceManager& resourceManager) : ShadowConfigurator(renderer, appWindow, resourceManager), renderer(renderer) {}
+        void applyParams(const EVSMParams& params) override {
+            appWindow.resizeLights(params.mapSize);
+            renderer.setExponents(params.positiveExponent, params.negativeExponent);
+            renderer.setMipBias(params.mipBias);
+        }
+        std::string getCsvHeader() const override {
+            return "Map size\tPositive exponent\tNegative exponent\tMip bias";
+        }
+        std::string formatCsv(const EVSMParams& params) const override {
+            return fmt::format("{}\t{}\t{}\t{}", params.mapSize, params.positiveExponent, params.negativeExponent, params.mipBias);
+        }
+        std::string formatParams(const EVSMParams& params) const override {
+            return fmt::format("{}_{}_{}_{}_{}", getShadowName(), params.mapSize, params.positiveExponent, params.negativeExponent, params.mipBias);
+        }
+        std::vector<EVSMParams> getAllParams() const override {
+            std::vector<EVSMParams> result;
+            for (unsigned int mapSize : MAP_SIZES) {
+                for (float positiveExponent : EVSM_POSITIVE_EXPONENTS)
+                {
+                    for (float negativeExponent : EVSM_NEGATIVE_EXPONENTS)
+                    {
+                        for (float mipBias : EVSM_MIP_BIASES)
+                        {
+                            result.push_back({ mapSize, positiveExponent, negativeExponent, mipBias });
+                        }
+                    }
                 }
             }
             return result;
         }
-        std::map<unsigned int, ShadowParams> getBestParams() const override {
-            std::map<unsigned int, ShadowParams> result{
-                {1200, {1728,1}},
-                {800, {2496,1}},
-                {400, {4032,1}}
+        std::map<unsigned int, EVSMParams> getBestParams() const override {
+            std::map<unsigned int, EVSMParams> result{
+                {1200, {1024,40.0f,5.0f,0.5f}},
+                {800, {2048,40.0f,5.0f,1.0f}},
+                {400, {3072,40.0f,10.0f,1.0f}}
             };
             return result;
         }
+    private:
+        EVSMShadowRenderer& renderer;
     };
-#elif SHADOW_PCF
+
     struct PCFParams {
         unsigned int mapSize{};
         unsigned int filterSize{};
     };
-    using ShadowParams = PCFParams;
-    class Configurator : public ShadowConfigurator<ShadowParams> {
+    class PCFConfigurator : public ShadowConfigurator<PCFParams> {
     public:
-        Configurator(AppWindow& appWindow, ResourceManager& resourceManager) : ShadowConfigurator(appWindow, resourceManager) {}
-        void applyParams(const ShadowParams& params) override {
+        PCFConfigurator(PCFShadowRenderer& renderer, AppWindow& appWindow, ResourceManager& resourceManager) : ShadowConfigurator(renderer, appWindow, resourceManager), renderer(renderer) {}
+        void applyLightSetup(DirectionalLight& dirLight, SpotLight& spotLight) const override {
+            TechniqueConfigurator::applyLightSetup(dirLight, spotLight);
+            dirLight.setProjectionSize(1.8f);
+            dirLight.setFarZ(2.0f);
+            spotLight.setNearZ(1.2f);
+            spotLight.setFarZ(4.0f);
+        }
+        void applyParams(const PCFParams& params) override {
             appWindow.resizeLights(params.mapSize);
-            resourceManager.updateFilterSize(params.filterSize);
-        }
-        std::string getShadowName() const override {
-            return "PCF";
+            renderer.setFilterSize(params.filterSize);
         }
         std::string getCsvHeader() const override {
             return "Map size\tFilter size";
         }
-        std::string formatCsv(const ShadowParams& params) const override {
+        std::string formatCsv(const PCFParams& params) const override {
             return fmt::format("{}\t{}", params.mapSize, params.filterSize);
         }
-        std::string formatParams(const ShadowParams& params) const override {
+        std::string formatParams(const PCFParams& params) const override {
             return fmt::format("{}_{}_{}", getShadowName(), params.mapSize, params.filterSize);
         }
-        std::vector<ShadowParams> getAllParams() const override {
-            std::vector<ShadowParams> result;
+        std::vector<PCFParams> getAllParams() const override {
+            std::vector<PCFParams> result;
             for (unsigned int mapSize : MAP_SIZES) {
                 for (unsigned int filterSize : FILTER_SIZES)
                 {
@@ -229,47 +547,50 @@ namespace shadow {
             }
             return result;
         }
-        std::map<unsigned int, ShadowParams> getBestParams() const override {
-            std::map<unsigned int, ShadowParams> result{
+        std::map<unsigned int, PCFParams> getBestParams() const override {
+            std::map<unsigned int, PCFParams> result{
                 {1200, {1728,3}},
                 {800, {2112,5}},
                 {400, {2496,9}}
             };
             return result;
         }
+    private:
+        PCFShadowRenderer& renderer;
     };
-#else
+
     struct BasicParams {
         unsigned int mapSize{};
     };
-    using ShadowParams = BasicParams;
-    class Configurator : public ShadowConfigurator<ShadowParams> {
+    class BasicConfigurator : public ShadowConfigurator<BasicParams> {
     public:
-        Configurator(AppWindow& appWindow, ResourceManager& resourceManager) : ShadowConfigurator(appWindow, resourceManager) {}
-        void applyParams(const ShadowParams& params) override {
-            appWindow.resizeLights(params.mapSize);
+        BasicConfigurator(const BasicShadowRenderer& renderer, AppWindow& appWindow, ResourceManager& resourceManager) : ShadowConfigurator(renderer, appWindow, resourceManager) {}
+        void applyLightSetup(DirectionalLight& dirLight, SpotLight& spotLight) const override {
+            TechniqueConfigurator::applyLightSetup(dirLight, spotLight);
+            dirLight.setFarZ(8.0f);
+            spotLight.setNearZ(0.2f);
         }
-        std::string getShadowName() const override {
-            return "Basic";
+        void applyParams(const BasicParams& params) override {
+            appWindow.resizeLights(params.mapSize);
         }
         std::string getCsvHeader() const override {
             return "Map size";
         }
-        std::string formatCsv(const ShadowParams& params) const override {
+        std::string formatCsv(const BasicParams& params) const override {
             return fmt::format("{}", params.mapSize);
         }
-        std::string formatParams(const ShadowParams& params) const override {
+        std::string formatParams(const BasicParams& params) const override {
             return fmt::format("{}_{}", getShadowName(), params.mapSize);
         }
-        std::vector<ShadowParams> getAllParams() const override {
-            std::vector<ShadowParams> result;
+        std::vector<BasicParams> getAllParams() const override {
+            std::vector<BasicParams> result;
             for (unsigned int mapSize : MAP_SIZES) {
                 result.push_back({ mapSize });
             }
             return result;
         }
-        std::map<unsigned int, ShadowParams> getBestParams() const override {
-            std::map<unsigned int, ShadowParams> result{
+        std::map<unsigned int, BasicParams> getBestParams() const override {
+            std::map<unsigned int, BasicParams> result{
                 {1200, {1984}},
                 {800, {2880}},
                 {400, {4608}}
@@ -277,5 +598,4 @@ namespace shadow {
             return result;
         }
     };
-#endif
 }
\ No newline at end of file
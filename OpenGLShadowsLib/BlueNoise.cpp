@@ -0,0 +1,184 @@
+#include "BlueNoise.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <random>
+
+shadow::BlueNoise::~BlueNoise()
+{
+    if (texture)
+    {
+        glDeleteTextures(1, &texture);
+    }
+}
+
+bool shadow::BlueNoise::initialize(GLsizei size)
+{
+    if (size < 4 || (size & (size - 1)) != 0)
+    {
+        SHADOW_ERROR("Invalid blue noise size ({}), it has to be a power of two!", size);
+        return false;
+    }
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const std::vector<unsigned int> ranks = generateRanks(size);
+    const size_t count = ranks.size();
+    std::vector<GLushort> values(count);
+    for (size_t i = 0U; i < count; ++i)
+    {
+        values[i] = static_cast<GLushort>(ranks[i] * 65536U / count);
+    }
+    this->size = size;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R16, size, size, 0, GL_RED, GL_UNSIGNED_SHORT, values.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    SHADOW_DEBUG("Generated {}x{} blue noise in {} ms.", size, size,
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+    return true;
+}
+
+void shadow::BlueNoise::nextFrame()
+{
+    if (!animated)
+    {
+        return;
+    }
+    // R2 sequence, consecutive frames get well spread offsets into the tile
+    ++frame;
+    offset = glm::ivec2(
+        static_cast<int>(std::fmod(frame * 0.7548776662, 1.0) * size),
+        static_cast<int>(std::fmod(frame * 0.5698402910, 1.0) * size));
+}
+
+void shadow::BlueNoise::setAnimated(bool animated)
+{
+    this->animated = animated;
+    if (!animated)
+    {
+        frame = 0U;
+        offset = glm::ivec2(0);
+    }
+}
+
+bool shadow::BlueNoise::isAnimated() const
+{
+    return animated;
+}
+
+glm::ivec2 shadow::BlueNoise::getOffset() const
+{
+    return offset;
+}
+
+// Ulichney's void-and-cluster on a torus: ranks an initial binary pattern by removing its tightest clusters,
+// then fills the largest voids. Once half of the pixels are set, filling the largest void of the ones equals
+// removing the tightest cluster of the zeros, so the last phase keeps the same energy.
+std::vector<unsigned int> shadow::BlueNoise::generateRanks(GLsizei size)
+{
+    const size_t count = static_cast<size_t>(size) * size;
+    std::vector<float> kernel(count);
+    for (GLsizei y = 0; y < size; ++y)
+    {
+        for (GLsizei x = 0; x < size; ++x)
+        {
+            const float dx = static_cast<float>(std::min(x, size - x)), dy = static_cast<float>(std::min(y, size - y));
+            kernel[static_cast<size_t>(y) * size + x] = std::exp(-(dx * dx + dy * dy) / (2.0f * SIGMA * SIGMA));
+        }
+    }
+    auto splat = [&](std::vector<float>& energy, size_t index, float sign)
+    {
+        const GLsizei px = static_cast<GLsizei>(index % size), py = static_cast<GLsizei>(index / size);
+        for (GLsizei y = 0; y < size; ++y)
+        {
+            const size_t kernelRow = static_cast<size_t>((y - py + size) & (size - 1)) * size;
+            for (GLsizei x = 0; x < size; ++x)
+            {
+                energy[static_cast<size_t>(y) * size + x] += sign * kernel[kernelRow + ((x - px + size) & (size - 1))];
+            }
+        }
+    };
+    auto findTightestCluster = [&](const std::vector<bool>& pattern, const std::vector<float>& energy)
+    {
+        size_t result{};
+        float maxEnergy = -1.0f;
+        for (size_t i = 0U; i < count; ++i)
+        {
+            if (pattern[i] && energy[i] > maxEnergy)
+            {
+                maxEnergy = energy[i];
+                result = i;
+            }
+        }
+        return result;
+    };
+    auto findLargestVoid = [&](const std::vector<bool>& pattern, const std::vector<float>& energy)
+    {
+        size_t result{};
+        float minEnergy = std::numeric_limits<float>::max();
+        for (size_t i = 0U; i < count; ++i)
+        {
+            if (!pattern[i] && energy[i] < minEnergy)
+            {
+                minEnergy = energy[i];
+                result = i;
+            }
+        }
+        return result;
+    };
+
+    // initial pattern, fixed seed so every run ranks the same texture
+    std::mt19937 generator{ 0x5EED5EEDU };
+    std::vector<size_t> indices(count);
+    for (size_t i = 0U; i < count; ++i)
+    {
+        indices[i] = i;
+    }
+    std::shuffle(indices.begin(), indices.end(), generator);
+    const size_t initialOnes = std::max(static_cast<size_t>(count * INITIAL_DENSITY), static_cast<size_t>(1U));
+    std::vector<bool> pattern(count, false);
+    std::vector<float> energy(count, 0.0f);
+    for (size_t i = 0U; i < initialOnes; ++i)
+    {
+        pattern[indices[i]] = true;
+        splat(energy, indices[i], 1.0f);
+    }
+    // spread the initial pattern until moving its tightest cluster would fill the same void
+    for (;;)
+    {
+        const size_t cluster = findTightestCluster(pattern, energy);
+        pattern[cluster] = false;
+        splat(energy, cluster, -1.0f);
+        const size_t emptiestVoid = findLargestVoid(pattern, energy);
+        pattern[emptiestVoid] = true;
+        splat(energy, emptiestVoid, 1.0f);
+        if (emptiestVoid == cluster)
+        {
+            break;
+        }
+    }
+
+    std::vector<unsigned int> ranks(count);
+    std::vector<bool> rankingPattern = pattern;
+    std::vector<float> rankingEnergy = energy;
+    for (size_t rank = initialOnes; rank-- > 0U;)
+    {
+        const size_t cluster = findTightestCluster(rankingPattern, rankingEnergy);
+        rankingPattern[cluster] = false;
+        splat(rankingEnergy, cluster, -1.0f);
+        ranks[cluster] = static_cast<unsigned int>(rank);
+    }
+    for (size_t rank = initialOnes; rank < count; ++rank)
+    {
+        const size_t emptiestVoid = findLargestVoid(pattern, energy);
+        pattern[emptiestVoid] = true;
+        splat(energy, emptiestVoid, 1.0f);
+        ranks[emptiestVoid] = static_cast<unsigned int>(rank);
+    }
+    return ranks;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "ShadowLog.h"
+
+#include "glad/glad.h"
+#include <glm/glm.hpp>
+#include <cassert>
+#include <vector>
+
+namespace shadow
+{
+    // tileable blue noise generated once with void-and-cluster, rotates the soft shadow kernels per pixel
+    class BlueNoise final
+    {
+    public:
+        BlueNoise() = default;
+        ~BlueNoise();
+        BlueNoise(BlueNoise&) = delete;
+        BlueNoise(BlueNoise&&) = delete;
+        BlueNoise& operator=(BlueNoise&) = delete;
+        BlueNoise& operator=(BlueNoise&&) = delete;
+        bool initialize(GLsizei size);
+        void nextFrame();
+        void setAnimated(bool animated);
+        bool isAnimated() const;
+        glm::ivec2 getOffset() const;
+        inline GLuint getTexture() const;
+        static std::vector<unsigned int> generateRanks(GLsizei size);
+    private:
+        static constexpr float SIGMA{ 1.5f };
+        static constexpr float INITIAL_DENSITY{ 0.1f };
+        GLsizei size{};
+        GLuint texture{};
+        bool animated{};
+        unsigned int frame{};
+        glm::ivec2 offset{};
+    };
+
+    inline GLuint BlueNoise::getTexture() const
+    {
+        assert(texture);
+        return texture;
+    }
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <array>
+#include <limits>
+
+namespace shadow
+{
+    struct BoundingBox final
+    {
+        glm::vec3 min{ std::numeric_limits<float>::max() };
+        glm::vec3 max{ std::numeric_limits<float>::lowest() };
+        inline bool isValid() const;
+        inline void extend(const glm::vec3& point);
+        inline void extend(const BoundingBox& box);
+        inline std::array<glm::vec3, 8> getCorners() const;
+        inline BoundingBox transformed(const glm::mat4& transform) const;
+        inline BoundingBox intersection(const BoundingBox& box) const;
+        inline bool intersectsFrustum(const glm::mat4& viewProjection) const;
+        template<size_t N> static BoundingBox fromPoints(const std::array<glm::vec3, N>& points);
+    };
+
+    inline bool BoundingBox::isValid() const
+    {
+        return min.x <= max.x && min.y <= max.y && min.z <= max.z;
+    }
+
+    inline void BoundingBox::extend(const glm::vec3& point)
+    {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    inline void BoundingBox::extend(const BoundingBox& box)
+    {
+        if (box.isValid())
+        {
+            extend(box.min);
+            extend(box.max);
+        }
+    }
+
+    inline std::array<glm::vec3, 8> BoundingBox::getCorners() const
+    {
+        return {
+            glm::vec3(min.x, min.y, min.z),
+            glm::vec3(max.x, min.y, min.z),
+            glm::vec3(min.x, max.y, min.z),
+            glm::vec3(max.x, max.y, min.z),
+            glm::vec3(min.x, min.y, max.z),
+            glm::vec3(max.x, min.y, max.z),
+            glm::vec3(min.x, max.y, max.z),
+            glm::vec3(max.x, max.y, max.z)
+        };
+    }
+
+    inline BoundingBox BoundingBox::transformed(const glm::mat4& transform) const
+    {
+        BoundingBox result{};
+        if (isValid())
+        {
+            for (const glm::vec3& corner : getCorners())
+            {
+                glm::vec4 point = transform * glm::vec4(corner, 1.0f);
+                result.extend(glm::vec3(point) / point.w);
+            }
+        }
+        return result;
+    }
+
+    inline BoundingBox BoundingBox::intersection(const BoundingBox& box) const
+    {
+        BoundingBox result{};
+        result.min = glm::max(min, box.min);
+        result.max = glm::min(max, box.max);
+        return result;
+    }
+
+    inline bool BoundingBox::intersectsFrustum(const glm::mat4& viewProjection) const
+    {
+        if (!isValid())
+        {
+            return false;
+        }
+        std::array<glm::vec4, 8> clipCorners{};
+        std::array<glm::vec3, 8> corners = getCorners();
+        for (size_t i = 0; i < corners.size(); ++i)
+        {
+            clipCorners[i] = viewProjection * glm::vec4(corners[i], 1.0f);
+        }
+        // conservative test, the box is rejected only when all of its corners lie outside the same clip plane
+        for (glm::length_t axis = 0; axis < 3; ++axis)
+        {
+            bool allBelow = true, allAbove = true;
+            for (const glm::vec4& corner : clipCorners)
+            {
+                allBelow = allBelow && corner[axis] < -corner.w;
+                allAbove = allAbove && corner[axis] > corner.w;
+            }
+            if (allBelow || allAbove)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<size_t N> BoundingBox BoundingBox::fromPoints(const std::array<glm::vec3, N>& points)
+    {
+        BoundingBox result{};
+        for (const glm::vec3& point : points)
+        {
+            result.extend(point);
+        }
+        return result;
+    }
+}
@@ -33,6 +33,37 @@ glm::vec3 shadow::Camera::getPosition() const
     return position;
 }
 
+glm::vec3 shadow::Camera::getDirection() const
+{
+    return direction;
+}
+
+float shadow::Camera::getNearZ() const
+{
+    return nearZ;
+}
+
+float shadow::Camera::getFarZ() const
+{
+    return farZ;
+}
+
+std::array<glm::vec3, 8> shadow::Camera::getFrustumCorners(float nearZ, float farZ) const
+{
+    const glm::mat4 inverseViewProjection = inverse(glm::perspective(fov, aspectRatio, nearZ, farZ) * lookAt(position, position + direction, up));
+    std::array<glm::vec3, 8> result{};
+    for (unsigned int i = 0U; i < 8U; ++i)
+    {
+        glm::vec4 corner = inverseViewProjection * glm::vec4(
+            (i & 1U) ? 1.0f : -1.0f,
+            (i & 2U) ? 1.0f : -1.0f,
+            (i & 4U) ? 1.0f : -1.0f,
+            1.0f);
+        result[i] = glm::vec3(corner) / corner.w;
+    }
+    return result;
+}
+
 bool shadow::Camera::isViewDirty() const
 {
     return viewDirty;
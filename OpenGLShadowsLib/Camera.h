@@ -1,6 +1,7 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <array>
 
 namespace shadow
 {
@@ -16,6 +17,10 @@ namespace shadow
         glm::mat4 getView();
         glm::mat4 getProjection();
         glm::vec3 getPosition() const;
+        glm::vec3 getDirection() const;
+        float getNearZ() const;
+        float getFarZ() const;
+        std::array<glm::vec3, 8> getFrustumCorners(float nearZ, float farZ) const;
         bool isViewDirty() const;
         bool isProjectionDirty() const;
         void setAspectRatio(float aspectRatio);
@@ -0,0 +1,62 @@
+#include "DepthReduction.h"
+
+#include <cstring>
+
+bool shadow::DepthReduction::initialize(std::shared_ptr<GLShader> shader)
+{
+    if (!shader)
+    {
+        SHADOW_ERROR("Depth reduction requires a compute shader!");
+        return false;
+    }
+    this->shader = shader;
+    return readback.initialize(sizeof(DepthBoundsData));
+}
+
+void shadow::DepthReduction::reduce(GLuint depthTexture, GLsizei width, GLsizei height, const glm::mat4& inverseViewProjection, const glm::mat4& dirView, const glm::mat4& spotView)
+{
+    assert(shader);
+    DepthBoundsData initialData{ glm::uvec3(UINT32_MAX), glm::uvec3(0U), glm::uvec3(UINT32_MAX), glm::uvec3(0U) };
+    readback.bindForWrite(BUFFER_BINDING, &initialData);
+    shader->use();
+    shader->setMat4("inverseViewProjection", inverseViewProjection);
+    shader->setMat4("dirLightView", dirView);
+    shader->setMat4("spotLightView", spotView);
+    glActiveTexture(GL_TEXTURE14);
+    glBindTexture(GL_TEXTURE_2D, depthTexture);
+    glDispatchCompute((width + LOCAL_SIZE - 1U) / LOCAL_SIZE, (height + LOCAL_SIZE - 1U) / LOCAL_SIZE, 1U);
+    glActiveTexture(GL_TEXTURE0);
+    readback.finishWrite();
+}
+
+bool shadow::DepthReduction::poll(BoundingBox& dirBounds, BoundingBox& spotBounds)
+{
+    DepthBoundsData data{};
+    if (!readback.readLatest(&data))
+    {
+        return false;
+    }
+    dirBounds = decodeBounds(data.dirMin, data.dirMax);
+    spotBounds = decodeBounds(data.spotMin, data.spotMax);
+    return true;
+}
+
+shadow::BoundingBox shadow::DepthReduction::decodeBounds(const glm::uvec3& min, const glm::uvec3& max)
+{
+    BoundingBox result{};
+    if (min.x == UINT32_MAX)
+    {
+        return result; // no receivers were visible
+    }
+    result.min = glm::vec3(decodeFloat(min.x), decodeFloat(min.y), decodeFloat(min.z));
+    result.max = glm::vec3(decodeFloat(max.x), decodeFloat(max.y), decodeFloat(max.z));
+    return result;
+}
+
+float shadow::DepthReduction::decodeFloat(GLuint value)
+{
+    GLuint bits = (value & 0x80000000U) ? value & 0x7FFFFFFFU : ~value;
+    float result;
+    std::memcpy(&result, &bits, sizeof(float));
+    return result;
+}
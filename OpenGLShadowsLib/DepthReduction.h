@@ -0,0 +1,39 @@
+#pragma once
+
+#include "GLShader.h"
+#include "BoundingBox.h"
+#include "ReadbackBuffer.h"
+
+#include <memory>
+
+namespace shadow
+{
+    // mirrors the DepthBounds buffer, floats are stored as order-preserving uints
+    struct DepthBoundsData final
+    {
+        glm::uvec3 dirMin{}, dirMax{}, spotMin{}, spotMax{};
+    };
+
+    // reduces the main depth buffer to the light view space bounds of the visible receivers (SDSM),
+    // the results are read back a few frames later without stalling the pipeline
+    class DepthReduction final
+    {
+    public:
+        DepthReduction() = default;
+        ~DepthReduction() = default;
+        DepthReduction(DepthReduction&) = delete;
+        DepthReduction(DepthReduction&&) = delete;
+        DepthReduction& operator=(DepthReduction&) = delete;
+        DepthReduction& operator=(DepthReduction&&) = delete;
+        bool initialize(std::shared_ptr<GLShader> shader);
+        void reduce(GLuint depthTexture, GLsizei width, GLsizei height, const glm::mat4& inverseViewProjection, const glm::mat4& dirView, const glm::mat4& spotView);
+        bool poll(BoundingBox& dirBounds, BoundingBox& spotBounds);
+    private:
+        static constexpr GLuint BUFFER_BINDING{ 0U };
+        static constexpr GLuint LOCAL_SIZE{ 16U };
+        static BoundingBox decodeBounds(const glm::uvec3& min, const glm::uvec3& max);
+        static float decodeFloat(GLuint value);
+        std::shared_ptr<GLShader> shader{};
+        ReadbackBuffer readback{};
+    };
+}
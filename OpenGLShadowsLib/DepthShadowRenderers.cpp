@@ -0,0 +1,364 @@
+#include "DepthShadowRenderers.h"
+#include "ResourceManager.h"
+#include "ShadowTileClassification.h"
+#include "Benchmark.h"
+#include "GLDebug.h"
+
+#include <glm/gtc/type_ptr.hpp>
+#include "imgui.h"
+#include <cmath>
+#include <string>
+
+bool shadow::DepthShadowRenderer::initialize(GLsizei textureSize, GLsizei windowWidth, GLsizei windowHeight)
+{
+    if (!ShadowRenderer::initialize(textureSize, windowWidth, windowHeight))
+    {
+        return false;
+    }
+    ResourceManager& resourceManager = ResourceManager::getInstance();
+    dirDepthShader = resourceManager.getShader(ShaderType::DepthDir);
+    spotDepthShader = resourceManager.getShader(ShaderType::DepthSpot);
+    if (!dirFbo.initialize(false, GL_DEPTH_ATTACHMENT, GL_DEPTH_COMPONENT,
+        textureSize, textureSize, GL_DEPTH_COMPONENT, GL_FLOAT, GL_NEAREST, GL_CLAMP_TO_BORDER, glm::vec4(1.0f)))
+    {
+        return false;
+    }
+    return spotFbo.initialize(false, GL_DEPTH_ATTACHMENT, GL_DEPTH_COMPONENT,
+        textureSize, textureSize, GL_DEPTH_COMPONENT, GL_FLOAT, GL_NEAREST, GL_CLAMP_TO_BORDER, glm::vec4(1.0f));
+}
+
+void shadow::DepthShadowRenderer::resize(GLsizei textureSize)
+{
+    assert(textureSize > 0);
+    if (this->textureSize == textureSize)
+    {
+        return;
+    }
+    dirFbo.resize(textureSize, textureSize);
+    spotFbo.resize(textureSize, textureSize);
+    this->textureSize = textureSize;
+    markModified();
+}
+
+GLuint shadow::DepthShadowRenderer::getDirFbo() const
+{
+    return dirFbo.getFbo();
+}
+
+GLuint shadow::DepthShadowRenderer::getSpotFbo() const
+{
+    return spotFbo.getFbo();
+}
+
+GLuint shadow::DepthShadowRenderer::getDirTexture() const
+{
+    return dirFbo.getTexture();
+}
+
+GLuint shadow::DepthShadowRenderer::getSpotTexture() const
+{
+    return spotFbo.getTexture();
+}
+
+shadow::ShadowTechnique shadow::BasicShadowRenderer::getTechnique() const
+{
+    return ShadowTechnique::Basic;
+}
+
+std::unique_ptr<shadow::TechniqueConfigurator> shadow::BasicShadowRenderer::createConfigurator()
+{
+    return std::make_unique<BasicConfigurator>(*this, AppWindow::getInstance(), ResourceManager::getInstance());
+}
+
+shadow::ShadowTechnique shadow::PCFShadowRenderer::getTechnique() const
+{
+    return ShadowTechnique::PCF;
+}
+
+void shadow::PCFShadowRenderer::activate() const
+{
+    DepthShadowRenderer::activate();
+    ResourceManager::getInstance().updateFilterSize(filterSize);
+}
+
+void shadow::PCFShadowRenderer::drawSettings()
+{
+    int filterRadius = static_cast<int>(filterSize / 2U);
+    if (ImGui::SliderInt("Filter size", &filterRadius, 0, static_cast<int>(MAX_FILTER_SIZE / 2U), std::to_string(filterRadius * 2 + 1).c_str()))
+    {
+        setFilterSize(static_cast<unsigned int>(filterRadius) * 2U + 1U);
+    }
+}
+
+void shadow::PCFShadowRenderer::setFilterSize(unsigned int filterSize)
+{
+    assert(filterSize % 2U == 1U);
+    this->filterSize = filterSize;
+    ResourceManager::getInstance().updateFilterSize(filterSize);
+}
+
+unsigned int shadow::PCFShadowRenderer::getFilterSize() const
+{
+    return filterSize;
+}
+
+std::unique_ptr<shadow::TechniqueConfigurator> shadow::PCFShadowRenderer::createConfigurator()
+{
+    return std::make_unique<PCFConfigurator>(*this, AppWindow::getInstance(), ResourceManager::getInstance());
+}
+
+bool shadow::BlockerSearchShadowRenderer::initialize(GLsizei textureSize, GLsizei windowWidth, GLsizei windowHeight)
+{
+    if (!DepthShadowRenderer::initialize(textureSize, windowWidth, windowHeight))
+    {
+        return false;
+    }
+    std::shared_ptr<GLShader> pyramidShader = ResourceManager::getInstance().getShader(ShaderType::DepthPyramid);
+    return dirDepthPyramid.initialize(pyramidShader, textureSize) && spotDepthPyramid.initialize(pyramidShader, textureSize);
+}
+
+void shadow::BlockerSearchShadowRenderer::resize(GLsizei textureSize)
+{
+    DepthShadowRenderer::resize(textureSize);
+    dirDepthPyramid.resize(textureSize);
+    spotDepthPyramid.resize(textureSize);
+}
+
+void shadow::BlockerSearchShadowRenderer::activate() const
+{
+    DepthShadowRenderer::activate();
+    updateSampling();
+}
+
+bool shadow::BlockerSearchShadowRenderer::hasBlockerSearch() const
+{
+    return true;
+}
+
+void shadow::BlockerSearchShadowRenderer::renderShadowPasses(Scene& scene, bool dirPaged)
+{
+    GL_PUSH_DEBUG_GROUP("DepthPyramids");
+    // the virtual map is sampled through its page table, its lookups skip the pyramid
+    if (!dirPaged)
+    {
+        dirDepthPyramid.build(getDirTexture());
+    }
+    spotDepthPyramid.build(getSpotTexture());
+    GL_POP_DEBUG_GROUP();
+}
+
+void shadow::BlockerSearchShadowRenderer::classifyTiles(const ShadowTileClassification& shadowTiles, GLuint depthTexture, const glm::mat4& inverseViewProjection, bool dirPaged) const
+{
+    GL_PUSH_DEBUG_GROUP("ShadowTiles");
+    shadowTiles.classify(depthTexture, inverseViewProjection, dirDepthPyramid.getTexture(), spotDepthPyramid.getTexture(), dirPaged);
+    GL_POP_DEBUG_GROUP();
+}
+
+void shadow::BlockerSearchShadowRenderer::bindShadowTextures(GLuint dirShadowTexture) const
+{
+    DepthShadowRenderer::bindShadowTextures(dirShadowTexture);
+    bindDepthPyramids();
+}
+
+void shadow::BlockerSearchShadowRenderer::drawSettings()
+{
+    int shadowSamples = static_cast<int>(this->shadowSamples), penumbraSamples = static_cast<int>(this->penumbraSamples), earlyOutSamples = static_cast<int>(this->earlyOutSamples);
+    bool samplesChanged = ImGui::SliderInt("Shadow samples", &shadowSamples, 1, 64);
+    samplesChanged = ImGui::SliderInt("Penumbra samples", &penumbraSamples, 1, 64) || samplesChanged;
+    if (samplesChanged)
+    {
+        setSamples(static_cast<unsigned int>(shadowSamples), static_cast<unsigned int>(penumbraSamples));
+    }
+    if (ImGui::SliderInt("Early-out samples", &earlyOutSamples, 0, 16))
+    {
+        setEarlyOutSamples(static_cast<unsigned int>(earlyOutSamples));
+    }
+}
+
+void shadow::BlockerSearchShadowRenderer::setSamples(unsigned int shadowSamples, unsigned int penumbraSamples)
+{
+    assert(shadowSamples);
+    assert(penumbraSamples);
+    this->shadowSamples = shadowSamples;
+    this->penumbraSamples = penumbraSamples;
+    updateSampling();
+}
+
+void shadow::BlockerSearchShadowRenderer::setEarlyOutSamples(unsigned int earlyOutSamples)
+{
+    this->earlyOutSamples = earlyOutSamples;
+    updateSampling();
+}
+
+unsigned int shadow::BlockerSearchShadowRenderer::getShadowSamples() const
+{
+    return shadowSamples;
+}
+
+unsigned int shadow::BlockerSearchShadowRenderer::getPenumbraSamples() const
+{
+    return penumbraSamples;
+}
+
+unsigned int shadow::BlockerSearchShadowRenderer::getEarlyOutSamples() const
+{
+    return earlyOutSamples;
+}
+
+void shadow::BlockerSearchShadowRenderer::bindDepthPyramids() const
+{
+    glActiveTexture(GL_TEXTURE16);
+    glBindTexture(GL_TEXTURE_2D, dirDepthPyramid.getTexture());
+    glActiveTexture(GL_TEXTURE17);
+    glBindTexture(GL_TEXTURE_2D, spotDepthPyramid.getTexture());
+}
+
+shadow::ShadowTechnique shadow::PCSSShadowRenderer::getTechnique() const
+{
+    return ShadowTechnique::PCSS;
+}
+
+std::unique_ptr<shadow::TechniqueConfigurator> shadow::PCSSShadowRenderer::createConfigurator()
+{
+    return std::make_unique<PCSSConfigurator>(*this, AppWindow::getInstance(), ResourceManager::getInstance());
+}
+
+void shadow::PCSSShadowRenderer::updateSampling() const
+{
+    ResourceManager& resourceManager = ResourceManager::getInstance();
+    resourceManager.updatePoisson(shadowSamples, penumbraSamples);
+    resourceManager.updateAdaptiveSampling(earlyOutSamples, 0.0f);
+}
+
+bool shadow::PenumbraShadowRenderer::initialize(GLsizei textureSize, GLsizei windowWidth, GLsizei windowHeight)
+{
+    if (!BlockerSearchShadowRenderer::initialize(textureSize, windowWidth, windowHeight))
+    {
+        return false;
+    }
+    ResourceManager& resourceManager = ResourceManager::getInstance();
+    dirPenumbraShader = resourceManager.getShader(ShaderType::DirPenumbra);
+    spotPenumbraShader = resourceManager.getShader(ShaderType::SpotPenumbra);
+    // penumbra ratio, view depth and octahedral normal, the latter two guide the upsampling in the main pass
+    GLsizei penumbraTextureWidth = windowWidth / penumbraTextureSizeDivisor, penumbraTextureHeight = windowHeight / penumbraTextureSizeDivisor;
+    if (!dirPenumbraFbo.initialize(true, GL_COLOR_ATTACHMENT0, GL_RGBA16F,
+        penumbraTextureWidth, penumbraTextureHeight, GL_RGBA, GL_FLOAT, GL_NEAREST, GL_CLAMP_TO_EDGE))
+    {
+        return false;
+    }
+    return spotPenumbraFbo.initialize(true, GL_COLOR_ATTACHMENT0, GL_RGBA16F,
+        penumbraTextureWidth, penumbraTextureHeight, GL_RGBA, GL_FLOAT, GL_NEAREST, GL_CLAMP_TO_EDGE);
+}
+
+void shadow::PenumbraShadowRenderer::resizeWindow(GLsizei windowWidth, GLsizei windowHeight)
+{
+    BlockerSearchShadowRenderer::resizeWindow(windowWidth, windowHeight);
+    resizePenumbraMaps();
+}
+
+void shadow::PenumbraShadowRenderer::renderShadowPasses(Scene& scene, bool dirPaged)
+{
+    BlockerSearchShadowRenderer::renderShadowPasses(scene, dirPaged);
+
+    GL_PUSH_DEBUG_GROUP("DirLightPenumbra");
+    glViewport(0, 0, windowWidth / penumbraTextureSizeDivisor, windowHeight / penumbraTextureSizeDivisor);
+    glBindFramebuffer(GL_FRAMEBUFFER, dirPenumbraFbo.getFbo());
+    glClearBufferfv(GL_COLOR, 0, value_ptr(glm::vec4(0.0f)));
+    glClear(GL_DEPTH_BUFFER_BIT);
+    dirPenumbraShader->use();
+    scene.render(dirPenumbraShader);
+    GL_POP_DEBUG_GROUP();
+
+    GL_PUSH_DEBUG_GROUP("SpotLightPenumbra");
+    glBindFramebuffer(GL_FRAMEBUFFER, spotPenumbraFbo.getFbo());
+    glClearBufferfv(GL_COLOR, 0, value_ptr(glm::vec4(0.0f)));
+    glClear(GL_DEPTH_BUFFER_BIT);
+    spotPenumbraShader->use();
+    scene.render(spotPenumbraShader);
+    GL_POP_DEBUG_GROUP();
+}
+
+void shadow::PenumbraShadowRenderer::bindShadowTextures(GLuint dirShadowTexture) const
+{
+    glActiveTexture(GL_TEXTURE10);
+    glBindTexture(GL_TEXTURE_2D, dirShadowTexture);
+    glActiveTexture(GL_TEXTURE11);
+    glBindTexture(GL_TEXTURE_2D, dirPenumbraFbo.getTexture());
+    glActiveTexture(GL_TEXTURE12);
+    glBindTexture(GL_TEXTURE_2D, getSpotTexture());
+    glActiveTexture(GL_TEXTURE13);
+    glBindTexture(GL_TEXTURE_2D, spotPenumbraFbo.getTexture());
+    bindDepthPyramids();
+}
+
+void shadow::PenumbraShadowRenderer::drawSettings()
+{
+    int divisorExponent = static_cast<int>(std::log2(penumbraTextureSizeDivisor));
+    if (ImGui::SliderInt("Penumbra map size divisor", &divisorExponent, 0, static_cast<int>(std::log2(MAX_PENUMBRA_TEXTURE_SIZE_DIVISOR)), std::to_string(1U << divisorExponent).c_str()))
+    {
+        setPenumbraTextureSizeDivisor(1U << divisorExponent);
+    }
+    BlockerSearchShadowRenderer::drawSettings();
+    float samplesPerTexel = this->samplesPerTexel;
+    if (ImGui::DragFloat("Samples per texel", &samplesPerTexel, 0.05f, 0.0f, 8.0f))
+    {
+        setSamplesPerTexel(samplesPerTexel);
+    }
+}
+
+void shadow::PenumbraShadowRenderer::setPenumbraTextureSizeDivisor(unsigned int penumbraTextureSizeDivisor)
+{
+    assert(penumbraTextureSizeDivisor && penumbraTextureSizeDivisor <= MAX_PENUMBRA_TEXTURE_SIZE_DIVISOR);
+    if (this->penumbraTextureSizeDivisor == penumbraTextureSizeDivisor)
+    {
+        return;
+    }
+    this->penumbraTextureSizeDivisor = penumbraTextureSizeDivisor;
+    resizePenumbraMaps();
+    markModified(); // the resized penumbra maps have to be bound again
+}
+
+unsigned int shadow::PenumbraShadowRenderer::getPenumbraTextureSizeDivisor() const
+{
+    return penumbraTextureSizeDivisor;
+}
+
+void shadow::PenumbraShadowRenderer::setSamplesPerTexel(float samplesPerTexel)
+{
+    assert(samplesPerTexel >= 0.0f);
+    this->samplesPerTexel = samplesPerTexel;
+    updateSampling();
+}
+
+float shadow::PenumbraShadowRenderer::getSamplesPerTexel() const
+{
+    return samplesPerTexel;
+}
+
+std::unique_ptr<shadow::TechniqueConfigurator> shadow::PenumbraShadowRenderer::createConfigurator()
+{
+    return std::make_unique<MasterCHSSConfigurator>(*this, AppWindow::getInstance(), ResourceManager::getInstance());
+}
+
+void shadow::PenumbraShadowRenderer::updateSampling() const
+{
+    ResourceManager& resourceManager = ResourceManager::getInstance();
+    resourceManager.updateVogelDisk(shadowSamples, penumbraSamples);
+    resourceManager.updateAdaptiveSampling(earlyOutSamples, samplesPerTexel);
+}
+
+void shadow::PenumbraShadowRenderer::resizePenumbraMaps()
+{
+    dirPenumbraFbo.resize(windowWidth / penumbraTextureSizeDivisor, windowHeight / penumbraTextureSizeDivisor);
+    spotPenumbraFbo.resize(windowWidth / penumbraTextureSizeDivisor, windowHeight / penumbraTextureSizeDivisor);
+}
+
+shadow::ShadowTechnique shadow::MasterShadowRenderer::getTechnique() const
+{
+    return ShadowTechnique::Master;
+}
+
+shadow::ShadowTechnique shadow::CHSSShadowRenderer::getTechnique() const
+{
+    return ShadowTechnique::CHSS;
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "ShadowRenderer.h"
+#include "Framebuffer.h"
+#include "MinMaxDepthPyramid.h"
+
+namespace shadow
+{
+    // techniques sampling plain depth maps
+    class DepthShadowRenderer abstract : public ShadowRenderer
+    {
+    public:
+        bool initialize(GLsizei textureSize, GLsizei windowWidth, GLsizei windowHeight) override;
+        void resize(GLsizei textureSize) override;
+        GLuint getDirFbo() const override;
+        GLuint getSpotFbo() const override;
+        GLuint getDirTexture() const override;
+        GLuint getSpotTexture() const override;
+    protected:
+        DepthShadowRenderer() = default;
+    private:
+        Framebuffer dirFbo{}, spotFbo{};
+    };
+
+    class BasicShadowRenderer final : public DepthShadowRenderer
+    {
+    public:
+        BasicShadowRenderer() = default;
+        ShadowTechnique getTechnique() const override;
+    protected:
+        std::unique_ptr<TechniqueConfigurator> createConfigurator() override;
+    };
+
+    class PCFShadowRenderer final : public DepthShadowRenderer
+    {
+    public:
+        PCFShadowRenderer() = default;
+        ShadowTechnique getTechnique() const override;
+        void activate() const override;
+        void drawSettings() override;
+        void setFilterSize(unsigned int filterSize);
+        unsigned int getFilterSize() const;
+    protected:
+        std::unique_ptr<TechniqueConfigurator> createConfigurator() override;
+    private:
+        unsigned int filterSize{ 1U };
+    };
+
+    // searches the blockers in min-max pyramids of the maps to estimate the penumbra
+    class BlockerSearchShadowRenderer abstract : public DepthShadowRenderer
+    {
+    public:
+        bool initialize(GLsizei textureSize, GLsizei windowWidth, GLsizei windowHeight) override;
+        void resize(GLsizei textureSize) override;
+        void activate() const override;
+        bool hasBlockerSearch() const override;
+        void renderShadowPasses(Scene& scene, bool dirPaged) override;
+        void classifyTiles(const ShadowTileClassification& shadowTiles, GLuint depthTexture, const glm::mat4& inverseViewProjection, bool dirPaged) const override;
+        void bindShadowTextures(GLuint dirShadowTexture) const override;
+        void drawSettings() override;
+        void setSamples(unsigned int shadowSamples, unsigned int penumbraSamples);
+        // 0 disables the early-out ring
+        void setEarlyOutSamples(unsigned int earlyOutSamples);
+        unsigned int getShadowSamples() const;
+        unsigned int getPenumbraSamples() const;
+        unsigned int getEarlyOutSamples() const;
+    protected:
+        BlockerSearchShadowRenderer() = default;
+        virtual void updateSampling() const = 0;
+        void bindDepthPyramids() const;
+        unsigned int shadowSamples{ 32U }, penumbraSamples{ 16U }, earlyOutSamples{ 0U };
+    private:
+        MinMaxDepthPyramid dirDepthPyramid{}, spotDepthPyramid{};
+    };
+
+    // the samples of the fixed Poisson disk are not reduced per texel, a prefix of it would not cover the kernel evenly
+    class PCSSShadowRenderer final : public BlockerSearchShadowRenderer
+    {
+    public:
+        PCSSShadowRenderer() = default;
+        ShadowTechnique getTechnique() const override;
+    protected:
+        std::unique_ptr<TechniqueConfigurator> createConfigurator() override;
+        void updateSampling() const override;
+    };
+
+    // estimates the penumbra in separate screen-space passes, which the main pass then upsamples
+    class PenumbraShadowRenderer abstract : public BlockerSearchShadowRenderer
+    {
+    public:
+        bool initialize(GLsizei textureSize, GLsizei windowWidth, GLsizei windowHeight) override;
+        void resizeWindow(GLsizei windowWidth, GLsizei windowHeight) override;
+        void renderShadowPasses(Scene& scene, bool dirPaged) override;
+        void bindShadowTextures(GLuint dirShadowTexture) const override;
+        void drawSettings() override;
+        void setPenumbraTextureSizeDivisor(unsigned int penumbraTextureSizeDivisor);
+        unsigned int getPenumbraTextureSizeDivisor() const;
+        // 0 always takes the full sample count
+        void setSamplesPerTexel(float samplesPerTexel);
+        float getSamplesPerTexel() const;
+    protected:
+        PenumbraShadowRenderer() = default;
+        std::unique_ptr<TechniqueConfigurator> createConfigurator() override;
+        void updateSampling() const override;
+    private:
+        static constexpr unsigned int MAX_PENUMBRA_TEXTURE_SIZE_DIVISOR{ 256U };
+        void resizePenumbraMaps();
+        Framebuffer dirPenumbraFbo{}, spotPenumbraFbo{};
+        std::shared_ptr<GLShader> dirPenumbraShader{}, spotPenumbraShader{};
+        unsigned int penumbraTextureSizeDivisor{ 1U };
+        float samplesPerTexel{ 0.0f };
+    };
+
+    class MasterShadowRenderer final : public PenumbraShadowRenderer
+    {
+    public:
+        MasterShadowRenderer() = default;
+        ShadowTechnique getTechnique() const override;
+    };
+
+    class CHSSShadowRenderer final : public PenumbraShadowRenderer
+    {
+    public:
+        CHSSShadowRenderer() = default;
+        ShadowTechnique getTechnique() const override;
+    };
+}
@@ -13,10 +13,20 @@ glm::mat4 shadow::DirectionalLight::getLightSpace()
 
 void shadow::DirectionalLight::updateLightSpace()
 {
-    float projSizeHalf = projectionSize * 0.5f;
-    lightData.lightSpace =
-        glm::ortho(-projSizeHalf, projSizeHalf, -projSizeHalf, projSizeHalf, lightData.nearZ, lightData.farZ)
-        * lookAt(position, position + lightData.direction, glm::vec3(0.0f, 1.0f, 0.0f));
+    // the manual projection stays in use until the first successful fit
+    if (autoFit && hasFit)
+    {
+        lightData.lightSpace =
+            glm::ortho(fittedProjection.x, fittedProjection.y, fittedProjection.z, fittedProjection.w, lightData.nearZ, lightData.farZ)
+            * lookAt(fittedPosition, fittedPosition + lightData.direction, glm::vec3(0.0f, 1.0f, 0.0f));
+    }
+    else
+    {
+        float projSizeHalf = projectionSize * 0.5f;
+        lightData.lightSpace =
+            glm::ortho(-projSizeHalf, projSizeHalf, -projSizeHalf, projSizeHalf, lightData.nearZ, lightData.farZ)
+            * lookAt(position, position + lightData.direction, glm::vec3(0.0f, 1.0f, 0.0f));
+    }
     lightSpaceDirty = false;
 }
 
@@ -45,8 +55,6 @@ void shadow::DirectionalLight::setDirection(glm::vec3 direction)
     lightSpaceDirty = true;
 }
 
-
-
 void shadow::DirectionalLight::setNearZ(float nearZ)
 {
     lightData.nearZ = nearZ;
@@ -65,6 +73,46 @@ void shadow::DirectionalLight::setLightSize(float lightSize)
     dirty = true;
 }
 
+glm::mat4 shadow::DirectionalLight::getFittingView() const
+{
+    return lookAt(position, position + lightData.direction, glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
+void shadow::DirectionalLight::fitToViewBounds(const BoundingBox& casterBounds, const BoundingBox& receiverViewBounds)
+{
+    if (!casterBounds.isValid() || !receiverViewBounds.isValid())
+    {
+        return;
+    }
+    BoundingBox casters = casterBounds.transformed(getFittingView());
+    // the ortho extents only need to cover the visible receivers, depth has to include every caster in front of them
+    glm::vec4 projection(receiverViewBounds.min.x, receiverViewBounds.max.x, receiverViewBounds.min.y, receiverViewBounds.max.y);
+    glm::vec3 eye = position;
+    float nearZ = -casters.max.z;
+    float farZ = -receiverViewBounds.min.z;
+    if (nearZ < FIT_MIN_NEAR_Z)
+    {
+        // moving the eye along the light direction keeps the ortho extents intact
+        float shift = FIT_MIN_NEAR_Z - nearZ;
+        eye -= lightData.direction * shift;
+        nearZ += shift;
+        farZ += shift;
+    }
+    if (farZ <= nearZ)
+    {
+        return;
+    }
+    hasFit = true;
+    if (projection != fittedProjection || eye != fittedPosition || nearZ != lightData.nearZ || farZ != lightData.farZ)
+    {
+        fittedProjection = projection;
+        fittedPosition = eye;
+        lightData.nearZ = nearZ;
+        lightData.farZ = farZ;
+        dirty = lightSpaceDirty = true;
+    }
+}
+
 void shadow::DirectionalLight::setProjectionSize(float projectionSize)
 {
     this->projectionSize = projectionSize;
@@ -29,11 +29,16 @@ namespace shadow
         void setNearZ(float nearZ) override;
         void setFarZ(float farZ) override;
         void setLightSize(float lightSize) override;
+        glm::mat4 getFittingView() const override;
+        void fitToViewBounds(const BoundingBox& casterBounds, const BoundingBox& receiverViewBounds) override;
         void setProjectionSize(float projectionSize);
         float getProjectionSize() const;
     private:
         float projectionSize{ 10.0f };
         glm::vec3 position{};
+        glm::vec4 fittedProjection{}; // left, right, bottom, top
+        glm::vec3 fittedPosition{};
+        bool hasFit{ false };
         float angleX{}, angleY{}, angleZ{};
     };
 }
@@ -1,14 +1,14 @@
 #include "Framebuffer.h"
 #include <glm/gtc/type_ptr.hpp>
 
-bool shadow::Framebuffer::initialize(bool addDepthRenderbuffer, GLenum attachment, GLint internalFormat, GLsizei width, GLsizei height, GLenum format, GLenum type, GLint filter, GLint wrappingTechnique, glm::vec4 border)
+bool shadow::Framebuffer::initialize(bool addDepthTexture, GLenum attachment, GLint internalFormat, GLsizei width, GLsizei height, GLenum format, GLenum type, GLint filter, GLint wrappingTechnique, glm::vec4 border)
 {
     if (width <= 0 || height <= 0)
     {
         SHADOW_ERROR("Invalid framebuffer size ({}x{})!", width, height);
         return false;
     }
-    SHADOW_DEBUG("Creating {}x{} framebuffer ({}, {}, {}, {}, {}, {}, {})...", width, height, addDepthRenderbuffer, attachment, internalFormat, format, type, filter, wrappingTechnique);
+    SHADOW_DEBUG("Creating {}x{} framebuffer ({}, {}, {}, {}, {}, {}, {})...", width, height, addDepthTexture, attachment, internalFormat, format, type, filter, wrappingTechnique);
     this->attachment = attachment;
     this->internalFormat = internalFormat;
     this->width = width;
@@ -23,9 +23,9 @@ bool shadow::Framebuffer::initialize(bool addDepthRenderbuffer, GLenum attachmen
     glGenFramebuffers(1, &framebuffer);
     glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
     texture = createTexture(attachment, internalFormat, width, height, format, type, filter, wrappingTechnique, border);
-    if (addDepthRenderbuffer)
+    if (addDepthTexture)
     {
-        depthRenderbuffer = createDepthRenderbuffer(width, height);
+        depthTexture = createDepthTexture(width, height);
     }
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
     {
@@ -37,6 +37,44 @@ bool shadow::Framebuffer::initialize(bool addDepthRenderbuffer, GLenum attachmen
     return true;
 }
 
+bool shadow::Framebuffer::addColorTexture(GLint internalFormat, GLenum format, GLenum type)
+{
+    assert(framebuffer);
+    assert(attachment != GL_DEPTH_ATTACHMENT);
+    GLint maxDrawBuffers;
+    glGetIntegerv(GL_MAX_DRAW_BUFFERS, &maxDrawBuffers);
+    if (colorTextures.size() + 2U > static_cast<size_t>(maxDrawBuffers))
+    {
+        SHADOW_ERROR("Unable to add color texture, only {} draw buffers are supported!", maxDrawBuffers);
+        return false;
+    }
+    SHADOW_DEBUG("Adding color texture ({}, {}, {}) to framebuffer...", internalFormat, format, type);
+    GLint previousFramebuffer;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    const GLenum colorAttachment = attachment + static_cast<GLenum>(colorTextures.size()) + 1U;
+    colorTextures.push_back({ createTexture(colorAttachment, internalFormat, width, height, format, type, filter, wrappingTechnique, border), internalFormat, format, type });
+    updateDrawBuffers();
+    const bool isComplete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    if (!isComplete)
+    {
+        SHADOW_ERROR("Framebuffer is incomplete after adding a color texture!");
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+    return isComplete;
+}
+
+void shadow::Framebuffer::attachDepthTexture(GLuint depthTexture)
+{
+    assert(framebuffer);
+    assert(!this->depthTexture);
+    GLint previousFramebuffer;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTexture, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+}
+
 void shadow::Framebuffer::resize(GLsizei width, GLsizei height)
 {
     assert(framebuffer);
@@ -56,11 +94,22 @@ void shadow::Framebuffer::resize(GLsizei width, GLsizei height)
     GLuint oldTexture = texture;
     texture = createTexture(attachment, internalFormat, width, height, format, type, filter, wrappingTechnique, border);
     glDeleteTextures(1, &oldTexture);
-    if (depthRenderbuffer)
+    if (depthTexture)
+    {
+        GLuint oldDepthTexture = depthTexture;
+        depthTexture = createDepthTexture(width, height);
+        glDeleteTextures(1, &oldDepthTexture);
+    }
+    for (size_t i = 0U; i < colorTextures.size(); ++i)
+    {
+        ColorTexture& colorTexture = colorTextures[i];
+        GLuint oldColorTexture = colorTexture.texture;
+        colorTexture.texture = createTexture(attachment + static_cast<GLenum>(i) + 1U, colorTexture.internalFormat, width, height, colorTexture.format, colorTexture.type, filter, wrappingTechnique, border);
+        glDeleteTextures(1, &oldColorTexture);
+    }
+    if (!colorTextures.empty())
     {
-        GLuint oldDepthRenderbuffer = depthRenderbuffer;
-        depthRenderbuffer = createDepthRenderbuffer(width, height);
-        glDeleteRenderbuffers(1, &oldDepthRenderbuffer);
+        updateDrawBuffers();
     }
     this->width = width;
     this->height = height;
@@ -97,21 +146,42 @@ GLuint shadow::Framebuffer::createTexture(GLenum attachment, GLint internalForma
     return texture;
 }
 
-GLuint shadow::Framebuffer::createDepthRenderbuffer(GLsizei width, GLsizei height)
+GLuint shadow::Framebuffer::createDepthTexture(GLsizei width, GLsizei height)
 {
-    GLuint depthRenderbuffer;
-    glGenRenderbuffers(1, &depthRenderbuffer);
-    glBindRenderbuffer(GL_RENDERBUFFER, depthRenderbuffer);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, width, height);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthRenderbuffer);
-    return depthRenderbuffer;
+    // a texture rather than a renderbuffer so that later passes can sample the depth
+    GLuint depthTexture;
+    glGenTextures(1, &depthTexture);
+    glBindTexture(GL_TEXTURE_2D, depthTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTexture, 0);
+    return depthTexture;
+}
+
+void shadow::Framebuffer::updateDrawBuffers() const
+{
+    // createTexture only selects the attachment it has just created
+    std::vector<GLenum> drawBuffers{ attachment };
+    for (size_t i = 0U; i < colorTextures.size(); ++i)
+    {
+        drawBuffers.push_back(attachment + static_cast<GLenum>(i) + 1U);
+    }
+    glDrawBuffers(static_cast<GLsizei>(drawBuffers.size()), drawBuffers.data());
 }
 
 shadow::Framebuffer::~Framebuffer()
 {
-    if (depthRenderbuffer)
+    for (const ColorTexture& colorTexture : colorTextures)
+    {
+        glDeleteTextures(1, &colorTexture.texture);
+    }
+    if (depthTexture)
     {
-        glDeleteRenderbuffers(1, &depthRenderbuffer);
+        glDeleteTextures(1, &depthTexture);
     }
     glDeleteTextures(1, &texture);
     glDeleteFramebuffers(1, &framebuffer);
@@ -4,6 +4,7 @@
 
 #include "glad/glad.h"
 #include <glm/glm.hpp>
+#include <vector>
 
 namespace shadow
 {
@@ -16,14 +17,26 @@ namespace shadow
         Framebuffer(Framebuffer&&) = delete;
         Framebuffer& operator=(Framebuffer&) = delete;
         Framebuffer& operator=(Framebuffer&&) = delete;
-        bool initialize(bool addDepthRenderbuffer, GLenum attachment, GLint internalFormat, GLsizei width, GLsizei height, GLenum format, GLenum type, GLint filter, GLint wrappingTechnique, glm::vec4 border = glm::vec4(0.0f));
+        bool initialize(bool addDepthTexture, GLenum attachment, GLint internalFormat, GLsizei width, GLsizei height, GLenum format, GLenum type, GLint filter, GLint wrappingTechnique, glm::vec4 border = glm::vec4(0.0f));
+        bool addColorTexture(GLint internalFormat, GLenum format, GLenum type); // attached after the existing ones, all of them are drawn to
+        void attachDepthTexture(GLuint depthTexture); // shares the depth of another framebuffer, which keeps its ownership and has to be reattached after resizing
         void resize(GLsizei width, GLsizei height);
         inline GLuint getTexture() const;
+        inline GLuint getTexture(size_t index) const;
         inline GLuint getFbo() const;
+        inline GLuint getDepthTexture() const;
     private:
         static GLuint createTexture(GLenum attachment, GLint internalFormat, GLsizei width, GLsizei height, GLenum format, GLenum type, GLint filter, GLint wrappingTechnique, glm::vec4 border);
-        static GLuint createDepthRenderbuffer(GLsizei width, GLsizei height);
-        GLuint framebuffer{}, texture{}, depthRenderbuffer{};
+        static GLuint createDepthTexture(GLsizei width, GLsizei height);
+        void updateDrawBuffers() const;
+        struct ColorTexture
+        {
+            GLuint texture;
+            GLint internalFormat;
+            GLenum format, type;
+        };
+        std::vector<ColorTexture> colorTextures{};
+        GLuint framebuffer{}, texture{}, depthTexture{};
         GLint internalFormat{}, filter{}, wrappingTechnique{};
         GLsizei width{}, height{};
         GLenum attachment{}, format{}, type{};
@@ -36,9 +49,25 @@ namespace shadow
         return texture;
     }
 
+    inline GLuint shadow::Framebuffer::getTexture(size_t index) const
+    {
+        if (index == 0U)
+        {
+            return getTexture();
+        }
+        assert(index <= colorTextures.size());
+        return colorTextures[index - 1U].texture;
+    }
+
     inline GLuint shadow::Framebuffer::getFbo() const
     {
         assert(framebuffer);
         return framebuffer;
     }
+
+    inline GLuint shadow::Framebuffer::getDepthTexture() const
+    {
+        assert(depthTexture);
+        return depthTexture;
+    }
 }
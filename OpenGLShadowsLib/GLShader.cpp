@@ -6,11 +6,19 @@
 #include <fstream>
 
 shadow::GLShader::GLShader(std::filesystem::path shaderPath, gsl::cstring_span commonFileName)
-    : vertexFile(shaderPath / (to_string(commonFileName) + ".vert")), fragmentFile(shaderPath / (to_string(commonFileName) + ".frag"))
+    : stages{
+        { GL_VERTEX_SHADER, shaderPath / (to_string(commonFileName) + ".vert") },
+        { GL_FRAGMENT_SHADER, shaderPath / (to_string(commonFileName) + ".frag") } }
 {}
 
 shadow::GLShader::GLShader(std::filesystem::path shaderPath, gsl::cstring_span vertexFile, gsl::cstring_span fragmentFile)
-    : vertexFile(shaderPath / to_string(vertexFile)), fragmentFile(shaderPath / to_string(fragmentFile))
+    : stages{
+        { GL_VERTEX_SHADER, shaderPath / to_string(vertexFile) },
+        { GL_FRAGMENT_SHADER, shaderPath / to_string(fragmentFile) } }
+{}
+
+shadow::GLShader::GLShader(std::filesystem::path shaderPath, gsl::cstring_span shaderFile, GLenum shaderType)
+    : stages{ { shaderType, shaderPath / to_string(shaderFile) } }
 {}
 
 shadow::GLShader::~GLShader()
@@ -21,24 +29,15 @@ shadow::GLShader::~GLShader()
 bool shadow::GLShader::createProgram()
 {
     assert(!programId);
-    SHADOW_DEBUG("Creating program using '{}' and '{}'...", vertexFile.generic_string(), fragmentFile.generic_string());
-    if (buildShader(vertexShader, GL_VERTEX_SHADER, vertexFile) != ShaderBuildStatus::Success)
+    SHADOW_DEBUG("Creating program using {}...", getFileNames());
+    const ResourceManager& resourceManager = ResourceManager::getInstance();
+    for (GLShaderStage& stage : stages)
     {
-        SHADOW_ERROR("Failed to build vertex shader '{}'!", vertexFile.generic_string());
-        return false;
+        stage.revision = resourceManager.getShaderFileRevision(stage.file);
     }
-    vertexTimestamp = last_write_time(vertexFile);
-    if (buildShader(fragmentShader, GL_FRAGMENT_SHADER, fragmentFile) != ShaderBuildStatus::Success)
-    {
-        SHADOW_ERROR("Failed to build fragment shader '{}'!", fragmentFile.generic_string());
-        deleteProgram();
-        return false;
-    }
-    fragmentTimestamp = last_write_time(fragmentFile);
-    if (!buildProgram(programId, vertexShader, fragmentShader))
+    if (!buildProgram(programId))
     {
         SHADOW_ERROR("Failed to build shader program!");
-        deleteProgram();
         return false;
     }
     return true;
@@ -47,98 +46,62 @@ bool shadow::GLShader::createProgram()
 void shadow::GLShader::update()
 {
     assert(programId);
-    if (exists(vertexFile))
+    // the expanded sources live in memory, so checking for changes involves no file access
+    const ResourceManager& resourceManager = ResourceManager::getInstance();
+    bool modified = false;
+    for (GLShaderStage& stage : stages)
     {
-        std::filesystem::file_time_type timestamp = last_write_time(vertexFile);
-        if (timestamp != vertexTimestamp)
+        const unsigned int revision = resourceManager.getShaderFileRevision(stage.file);
+        if (revision != stage.revision)
         {
-            SHADOW_DEBUG("Vertex shader '{}' was modified! Rebuilding...", vertexFile.generic_string());
-            GLuint shader;
-            switch (buildShader(shader, GL_VERTEX_SHADER, vertexFile))
-            {
-            case ShaderBuildStatus::Failed:
-                vertexTimestamp = timestamp;
-                SHADOW_ERROR("Failed to rebuild vertex shader, using the old build.");
-                break;
-            case ShaderBuildStatus::Success:
-            {
-                vertexTimestamp = timestamp;
-                GLuint program;
-                SHADOW_DEBUG("Shader rebuilt! Rebuilding program...");
-                if (buildProgram(program, shader, fragmentShader))
-                {
-                    GLuint oldShader = vertexShader, oldProgram = programId;
-                    programId = program;
-                    vertexShader = shader;
-                    glDeleteShader(oldShader);
-                    glDeleteProgram(oldProgram);
-                    SHADOW_DEBUG("Program rebuilt and replaced successfully!");
-                }
-                else
-                {
-                    glDeleteShader(shader);
-                    SHADOW_ERROR("Failed to rebuild shader program, using the old build.");
-                }
-                break;
-            }
-            default:
-                break;
-            }
+            stage.revision = revision;
+            modified = true;
         }
     }
-    if (exists(fragmentFile))
+    if (!modified)
     {
-        std::filesystem::file_time_type timestamp = last_write_time(fragmentFile);
-        if (timestamp != fragmentTimestamp)
-        {
-            SHADOW_DEBUG("Fragment shader '{}' was modified! Rebuilding...", fragmentFile.generic_string());
-            GLuint shader;
-            switch (buildShader(shader, GL_FRAGMENT_SHADER, fragmentFile))
-            {
-            case ShaderBuildStatus::Failed:
-                fragmentTimestamp = timestamp;
-                SHADOW_ERROR("Failed to rebuild fragment shader, using the old build.");
-                break;
-            case ShaderBuildStatus::Success:
-            {
-                fragmentTimestamp = timestamp;
-                GLuint program;
-                SHADOW_DEBUG("Shader rebuilt! Rebuilding program...");
-                if (buildProgram(program, vertexShader, shader))
-                {
-                    GLuint oldShader = fragmentShader, oldProgram = programId;
-                    programId = program;
-                    fragmentShader = shader;
-                    glDeleteShader(oldShader);
-                    glDeleteProgram(oldProgram);
-                    SHADOW_DEBUG("Program rebuilt as {} and replaced successfully!", programId);
-                }
-                else
-                {
-                    glDeleteShader(shader);
-                    SHADOW_ERROR("Failed to rebuild shader program, using the old build.");
-                }
-                break;
-            }
-            default:
-                break;
-            }
-        }
+        return;
+    }
+    // the program is rebuilt as a whole, so that an unchanged permutation can come straight from the binary cache
+    SHADOW_DEBUG("Shaders of {} were modified! Rebuilding program...", getFileNames());
+    GLuint program;
+    if (buildProgram(program))
+    {
+        glDeleteProgram(programId);
+        programId = program;
+        SHADOW_DEBUG("Program rebuilt as {} and replaced successfully!", programId);
+    }
+    else
+    {
+        SHADOW_ERROR("Failed to rebuild shader program, using the old build.");
     }
 }
 
-void shadow::GLShader::deleteProgram()
+// compiles the current sources into the binary cache without replacing the program in use, false if there was nothing to compile
+bool shadow::GLShader::prewarm() const
 {
-    if (vertexShader)
+    ProgramBinaryCache& binaryCache = ResourceManager::getInstance().getProgramBinaryCache();
+    std::vector<std::pair<GLenum, std::string>> stageSources{};
+    if (!binaryCache.isAvailable() || !getStageSources(stageSources))
+    {
+        return false;
+    }
+    if (binaryCache.contains(binaryCache.getKey(stageSources)))
     {
-        glDeleteShader(vertexShader);
-        vertexShader = 0U;
+        return false;
     }
-    if (fragmentShader)
+    SHADOW_DEBUG("Prewarming program using {}...", getFileNames());
+    GLuint program;
+    if (!linkProgram(program, stageSources))
     {
-        glDeleteShader(fragmentShader);
-        fragmentShader = 0U;
+        return false;
     }
+    glDeleteProgram(program);
+    return true;
+}
+
+void shadow::GLShader::deleteProgram()
+{
     if (programId)
     {
         glDeleteProgram(programId);
@@ -152,8 +115,7 @@ GLint shadow::GLShader::getUniformLocation(gsl::cstring_span name) const
     GLint result = glGetUniformLocation(programId, name.cbegin());
     if (result == -1)
     {
-        SHADOW_ERROR("Uniform '{}' was not found in program {} ('{}', '{}')!",
-            name.cbegin(), programId, vertexFile.generic_string(), fragmentFile.generic_string());
+        SHADOW_ERROR("Uniform '{}' was not found in program {} ({})!", name.cbegin(), programId, getFileNames());
     }
     return result;
 }
@@ -230,15 +192,67 @@ void shadow::GLShader::setMat4(gsl::cstring_span name, glm::mat4 value) const
     }
 }
 
-bool shadow::GLShader::buildProgram(GLuint& programId, GLuint vertexShader, GLuint fragmentShader) const
+bool shadow::GLShader::getStageSources(std::vector<std::pair<GLenum, std::string>>& stageSources) const
+{
+    stageSources.clear();
+    for (const GLShaderStage& stage : stages)
+    {
+        std::string source = ResourceManager::getInstance().getShaderFileContent(stage.file);
+        if (source.empty())
+        {
+            SHADOW_ERROR("Provided shader file '{}' content was empty!", stage.file.generic_string());
+            return false;
+        }
+        stageSources.emplace_back(stage.type, std::move(source));
+    }
+    return true;
+}
+
+bool shadow::GLShader::buildProgram(GLuint& programId) const
 {
-    assert(vertexShader);
-    assert(fragmentShader);
-    SHADOW_DEBUG("Building program using '{}' and '{}'...", vertexFile.generic_string(), fragmentFile.generic_string());
+    std::vector<std::pair<GLenum, std::string>> stageSources{};
+    if (!getStageSources(stageSources))
+    {
+        return false;
+    }
+    ProgramBinaryCache& binaryCache = ResourceManager::getInstance().getProgramBinaryCache();
+    if (binaryCache.load(programId, binaryCache.getKey(stageSources)))
+    {
+        return true;
+    }
+    return linkProgram(programId, stageSources);
+}
+
+bool shadow::GLShader::linkProgram(GLuint& programId, const std::vector<std::pair<GLenum, std::string>>& stageSources) const
+{
+    SHADOW_DEBUG("Building program using {}...", getFileNames());
+    std::vector<GLuint> shaders{};
+    for (size_t i = 0U; i < stageSources.size(); ++i)
+    {
+        GLuint shader;
+        if (buildShader(shader, stageSources[i].first, stages[i].file, stageSources[i].second) != ShaderBuildStatus::Success)
+        {
+            SHADOW_ERROR("Failed to build shader '{}'!", stages[i].file.generic_string());
+            for (GLuint built : shaders)
+            {
+                glDeleteShader(built);
+            }
+            return false;
+        }
+        shaders.push_back(shader);
+    }
     programId = glCreateProgram();
-    glAttachShader(programId, vertexShader);
-    glAttachShader(programId, fragmentShader);
+    glProgramParameteri(programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    for (GLuint shader : shaders)
+    {
+        glAttachShader(programId, shader);
+    }
     glLinkProgram(programId);
+    for (GLuint shader : shaders)
+    {
+        glDetachShader(programId, shader);
+        glDeleteShader(shader);
+    }
     GLint isFine;
     glGetProgramiv(programId, GL_LINK_STATUS, &isFine);
     if (!isFine)
@@ -254,21 +268,22 @@ bool shadow::GLShader::buildProgram(GLuint& programId, GLuint vertexShader, GLui
         return false;
     }
     SHADOW_DEBUG("Program built as {}!", programId);
+    ProgramBinaryCache& binaryCache = ResourceManager::getInstance().getProgramBinaryCache();
+    binaryCache.store(programId, binaryCache.getKey(stageSources));
     return true;
 }
 
-shadow::ShaderBuildStatus shadow::GLShader::buildShader(GLuint& shaderId, GLuint shaderType, const std::filesystem::path& path) const
+shadow::ShaderBuildStatus shadow::GLShader::buildShader(GLuint& shaderId, GLuint shaderType, const std::filesystem::path& path, const std::string& source) const
 {
     SHADOW_DEBUG("Building shader '{}' of type '{}'...", path.generic_string(), shaderType);
-    std::string shaderTextString = ResourceManager::getInstance().getShaderFileContent(path);
-    if (shaderTextString.empty())
+    if (source.empty())
     {
         SHADOW_ERROR("Provided shader file '{}' content was empty!", path.generic_string());
         return ShaderBuildStatus::Unavailable;
     }
     shaderId = glCreateShader(shaderType);
-    const GLchar* shaderText{ shaderTextString.c_str() };
-    GLint shaderTextSize = static_cast<GLint>(shaderTextString.length());
+    const GLchar* shaderText{ source.c_str() };
+    GLint shaderTextSize = static_cast<GLint>(source.length());
     glShaderSource(shaderId, 1, &shaderText, &shaderTextSize);
     glCompileShader(shaderId);
     GLint isFine;
@@ -287,3 +302,17 @@ shadow::ShaderBuildStatus shadow::GLShader::buildShader(GLuint& shaderId, GLuint
     }
     return ShaderBuildStatus::Success;
 }
+
+std::string shadow::GLShader::getFileNames() const
+{
+    std::string result{};
+    for (const GLShaderStage& stage : stages)
+    {
+        if (!result.empty())
+        {
+            result += ", ";
+        }
+        result += "'" + stage.file.generic_string() + "'";
+    }
+    return result;
+}
@@ -6,6 +6,7 @@
 #include <glm/glm.hpp>
 #include <gsl/gsl-lite.hpp>
 #include <filesystem>
+#include <vector>
 #include <cassert>
 
 namespace shadow
@@ -17,6 +18,13 @@ namespace shadow
         Unavailable
     };
 
+    struct GLShaderStage final
+    {
+        GLenum type{};
+        std::filesystem::path file{};
+        unsigned int revision{}; // of the expanded source held by the shader manager
+    };
+
     class GLShader final
     {
     public:
@@ -27,6 +35,7 @@ namespace shadow
         GLShader& operator=(GLShader&&) = delete;
         bool createProgram();
         void update();
+        bool prewarm() const;
         void deleteProgram();
         inline void use() const;
         inline GLuint getProgramId() const;
@@ -46,11 +55,14 @@ namespace shadow
         friend class ShaderManager;
         GLShader(std::filesystem::path shaderPath, gsl::cstring_span commonFileName);
         GLShader(std::filesystem::path shaderPath, gsl::cstring_span vertexFile, gsl::cstring_span fragmentFile);
-        bool buildProgram(GLuint& programId, GLuint vertexShader, GLuint fragmentShader) const;
-        ShaderBuildStatus buildShader(GLuint& shaderId, GLuint shaderType, const std::filesystem::path& path) const;
-        std::filesystem::path vertexFile{}, fragmentFile{};
-        std::filesystem::file_time_type vertexTimestamp{}, fragmentTimestamp{};
-        GLuint programId{ 0U }, vertexShader{ 0U }, fragmentShader{ 0U };
+        GLShader(std::filesystem::path shaderPath, gsl::cstring_span shaderFile, GLenum shaderType); // single-stage program, e.g. compute
+        bool getStageSources(std::vector<std::pair<GLenum, std::string>>& stageSources) const;
+        bool buildProgram(GLuint& programId) const;
+        bool linkProgram(GLuint& programId, const std::vector<std::pair<GLenum, std::string>>& stageSources) const;
+        ShaderBuildStatus buildShader(GLuint& shaderId, GLuint shaderType, const std::filesystem::path& path, const std::string& source) const;
+        std::string getFileNames() const;
+        std::vector<GLShaderStage> stages{};
+        GLuint programId{ 0U };
     };
 
     inline void GLShader::use() const
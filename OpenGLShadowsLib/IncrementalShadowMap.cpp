@@ -0,0 +1,106 @@
+#include "IncrementalShadowMap.h"
+
+#include <glm/gtx/transform.hpp>
+#include <algorithm>
+
+void shadow::IncrementalShadowMap::invalidate()
+{
+    valid = false;
+}
+
+void shadow::IncrementalShadowMap::update(Scene& scene, std::shared_ptr<GLShader> depthShader, GLuint fbo, GLsizei textureSize, const glm::mat4& lightSpace, const std::vector<BoundingBox>& changes)
+{
+    assert(depthShader);
+    if (!valid || textureSize != lastTextureSize || lightSpace != lastLightSpace)
+    {
+        std::fill(dirtyTiles.begin(), dirtyTiles.end(), true);
+        valid = true;
+        lastTextureSize = textureSize;
+        lastLightSpace = lightSpace;
+    }
+    else
+    {
+        for (const BoundingBox& bounds : changes)
+        {
+            invalidateBounds(bounds, lightSpace);
+        }
+    }
+    if (std::find(dirtyTiles.begin(), dirtyTiles.end(), true) == dirtyTiles.end())
+    {
+        return;
+    }
+    glViewport(0, 0, textureSize, textureSize);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    depthShader->use();
+    if (std::find(dirtyTiles.begin(), dirtyTiles.end(), false) == dirtyTiles.end())
+    {
+        glClear(GL_DEPTH_BUFFER_BIT);
+        scene.render(depthShader);
+    }
+    else
+    {
+        // adjacent dirty tiles of a row are drawn together to save draw calls
+        glEnable(GL_SCISSOR_TEST);
+        for (int y = 0; y < TILES; ++y)
+        {
+            for (int x = 0; x < TILES; ++x)
+            {
+                if (dirtyTiles[y * TILES + x])
+                {
+                    int last = x;
+                    while (last + 1 < TILES && dirtyTiles[y * TILES + last + 1])
+                    {
+                        ++last;
+                    }
+                    renderTiles(scene, depthShader, textureSize, lightSpace, y, x, last);
+                    x = last;
+                }
+            }
+        }
+        glDisable(GL_SCISSOR_TEST);
+    }
+    std::fill(dirtyTiles.begin(), dirtyTiles.end(), false);
+}
+
+void shadow::IncrementalShadowMap::invalidateBounds(const BoundingBox& bounds, const glm::mat4& lightSpace)
+{
+    if (!bounds.isValid())
+    {
+        return;
+    }
+    BoundingBox lightBounds{};
+    for (const glm::vec3& corner : bounds.getCorners())
+    {
+        glm::vec4 point = lightSpace * glm::vec4(corner, 1.0f);
+        if (point.w <= 0.0f)
+        {
+            // the box reaches behind a perspective light, its projection is unbounded
+            std::fill(dirtyTiles.begin(), dirtyTiles.end(), true);
+            return;
+        }
+        lightBounds.extend(glm::vec3(point) / point.w);
+    }
+    glm::ivec2 minTile(glm::floor((glm::vec2(lightBounds.min) * 0.5f + 0.5f) * static_cast<float>(TILES)));
+    glm::ivec2 maxTile(glm::floor((glm::vec2(lightBounds.max) * 0.5f + 0.5f) * static_cast<float>(TILES)));
+    minTile = glm::max(minTile, glm::ivec2(0));
+    maxTile = glm::min(maxTile, glm::ivec2(TILES - 1));
+    for (int y = minTile.y; y <= maxTile.y; ++y)
+    {
+        for (int x = minTile.x; x <= maxTile.x; ++x)
+        {
+            dirtyTiles[y * TILES + x] = true;
+        }
+    }
+}
+
+void shadow::IncrementalShadowMap::renderTiles(Scene& scene, std::shared_ptr<GLShader> depthShader, GLsizei textureSize, const glm::mat4& lightSpace, int row, int firstTile, int lastTile) const
+{
+    const GLint x = firstTile * textureSize / TILES;
+    const GLint y = row * textureSize / TILES;
+    glScissor(x, y, (lastTile + 1) * textureSize / TILES - x, (row + 1) * textureSize / TILES - y);
+    glClear(GL_DEPTH_BUFFER_BIT);
+    // crops the light projection to the tiles, it is only used to skip the casters outside of them
+    const glm::vec2 scale(static_cast<float>(TILES) / static_cast<float>(lastTile - firstTile + 1), static_cast<float>(TILES));
+    const glm::vec2 center = glm::vec2(static_cast<float>(firstTile + lastTile + 1) * 0.5f, static_cast<float>(row) + 0.5f) / static_cast<float>(TILES) * 2.0f - 1.0f;
+    scene.render(depthShader, glm::scale(glm::vec3(scale, 1.0f)) * glm::translate(glm::vec3(-center, 0.0f)) * lightSpace);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "GLShader.h"
+#include "Scene.h"
+
+#include <memory>
+#include <vector>
+
+namespace shadow
+{
+    // keeps a rendered shadow map between frames and redraws only the light space tiles covered by changed casters,
+    // the whole map is redrawn when the light space or the map size changes
+    class IncrementalShadowMap final
+    {
+    public:
+        IncrementalShadowMap() = default;
+        ~IncrementalShadowMap() = default;
+        IncrementalShadowMap(IncrementalShadowMap&) = delete;
+        IncrementalShadowMap(IncrementalShadowMap&&) = delete;
+        IncrementalShadowMap& operator=(IncrementalShadowMap&) = delete;
+        IncrementalShadowMap& operator=(IncrementalShadowMap&&) = delete;
+        void invalidate();
+        void update(Scene& scene, std::shared_ptr<GLShader> depthShader, GLuint fbo, GLsizei textureSize, const glm::mat4& lightSpace, const std::vector<BoundingBox>& changes);
+    private:
+        static constexpr int TILES{ 16 };
+        void invalidateBounds(const BoundingBox& bounds, const glm::mat4& lightSpace);
+        void renderTiles(Scene& scene, std::shared_ptr<GLShader> depthShader, GLsizei textureSize, const glm::mat4& lightSpace, int row, int firstTile, int lastTile) const;
+        bool valid{};
+        GLsizei lastTextureSize{};
+        glm::mat4 lastLightSpace{};
+        std::vector<bool> dirtyTiles = std::vector<bool>(TILES * TILES, true);
+    };
+}
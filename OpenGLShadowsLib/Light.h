@@ -1,5 +1,7 @@
 #pragma once
 
+#include "BoundingBox.h"
+
 #include <glm/glm.hpp>
 
 namespace shadow
@@ -22,8 +24,16 @@ namespace shadow
         virtual void setNearZ(float nearZ) = 0;
         virtual void setFarZ(float farZ) = 0;
         virtual void setLightSize(float lightSize) = 0;
+        // view used for fitting, receiver view bounds passed to fitToViewBounds are expected in this space
+        virtual glm::mat4 getFittingView() const = 0;
+        // fits the projection to the casters and to the visible receivers, used only in auto-fit mode
+        virtual void fitToViewBounds(const BoundingBox& casterBounds, const BoundingBox& receiverViewBounds) = 0;
+        void fitToBounds(const BoundingBox& casterBounds, const BoundingBox& receiverBounds);
+        void setAutoFit(bool autoFit);
+        bool isAutoFit() const;
     protected:
-        bool dirty{ true }, lightSpaceDirty{ true };
+        static constexpr float FIT_MIN_NEAR_Z{ 0.05f };
+        bool dirty{ true }, lightSpaceDirty{ true }, autoFit{ false };
         T lightData{};
     };
     template<typename T>
@@ -49,6 +59,22 @@ namespace shadow
         return lightSpaceDirty;
     }
     template<typename T>
+    inline void Light<T>::fitToBounds(const BoundingBox& casterBounds, const BoundingBox& receiverBounds)
+    {
+        fitToViewBounds(casterBounds, receiverBounds.transformed(getFittingView()));
+    }
+    template<typename T>
+    inline void Light<T>::setAutoFit(bool autoFit)
+    {
+        this->autoFit = autoFit;
+        lightSpaceDirty = true;
+    }
+    template<typename T>
+    inline bool Light<T>::isAutoFit() const
+    {
+        return autoFit;
+    }
+    template<typename T>
     inline Light<T>::Light(T& t) : lightData(t)
     {}
 }
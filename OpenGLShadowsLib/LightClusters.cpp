@@ -0,0 +1,36 @@
+#include "LightClusters.h"
+
+shadow::LightClusters::~LightClusters()
+{
+    if (clusterBuffer)
+    {
+        glDeleteBuffers(1, &clusterBuffer);
+    }
+}
+
+bool shadow::LightClusters::initialize(std::shared_ptr<GLShader> shader)
+{
+    if (!shader)
+    {
+        SHADOW_ERROR("Light clustering requires a compute shader!");
+        return false;
+    }
+    this->shader = shader;
+    // per-cluster light counts followed by fixed-size index lists
+    GLsizeiptr size = static_cast<GLsizeiptr>(CLUSTER_COUNT) * (1 + MAX_CLUSTER_LIGHTS) * sizeof(GLuint);
+    glGenBuffers(1, &clusterBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, clusterBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, size, nullptr, GL_DYNAMIC_COPY);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BUFFER_BINDING, clusterBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    return true;
+}
+
+void shadow::LightClusters::cull(const glm::mat4& inverseProjection)
+{
+    assert(shader);
+    shader->use();
+    shader->setMat4("inverseProjection", inverseProjection);
+    glDispatchCompute(1U, 1U, CLUSTER_Z);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "GLShader.h"
+#include "SsboPointLights.h"
+
+#include <memory>
+
+namespace shadow
+{
+    // bins the lights into view space froxels (screen tiles split into exponential depth slices),
+    // so the main pass only evaluates the lights that can reach the cluster of a fragment
+    class LightClusters final
+    {
+    public:
+        static constexpr unsigned int CLUSTER_X{ 16U }, CLUSTER_Y{ 9U }, CLUSTER_Z{ 24U };
+        static constexpr unsigned int CLUSTER_COUNT{ CLUSTER_X * CLUSTER_Y * CLUSTER_Z };
+        // every point light may end up in a single cluster, a shorter list would silently drop the rest
+        static constexpr unsigned int MAX_CLUSTER_LIGHTS{ SsboPointLights::MAX_POINT_LIGHTS };
+        LightClusters() = default;
+        ~LightClusters();
+        LightClusters(LightClusters&) = delete;
+        LightClusters(LightClusters&&) = delete;
+        LightClusters& operator=(LightClusters&) = delete;
+        LightClusters& operator=(LightClusters&&) = delete;
+        bool initialize(std::shared_ptr<GLShader> shader);
+        void cull(const glm::mat4& inverseProjection);
+    private:
+        static constexpr GLuint BUFFER_BINDING{ 2U };
+        std::shared_ptr<GLShader> shader{};
+        GLuint clusterBuffer{};
+    };
+}
@@ -4,6 +4,10 @@
 shadow::MaterialMesh::MaterialMesh(const std::vector<Vertex>& vertices, const std::vector<GLuint>& indices, std::shared_ptr<Material> material)
     : material(material), uboMaterial(ResourceManager::getInstance().getUboMaterial()), indexCount(static_cast<GLsizei>(indices.size()))
 {
+    for (const Vertex& vertex : vertices)
+    {
+        bounds.extend(vertex.position);
+    }
     glGenVertexArrays(1, &vao);
     glGenBuffers(1, &vbo);
     glGenBuffers(1, &ebo);
@@ -30,6 +30,7 @@ bool shadow::MaterialModelMesh::load()
             vertices.push_back(Vertex{ meshData.vertices[i], meshData.normals[i] });
         }
         meshes.push_back(std::make_shared<MaterialMesh>(vertices, meshData.indices, material));
+        bounds.extend(meshes.back()->getBounds());
     }
     return true;
 }
@@ -2,6 +2,7 @@
 
 #include "ShaderType.h"
 #include "GLShader.h"
+#include "BoundingBox.h"
 
 #include <memory>
 
@@ -13,8 +14,15 @@ namespace shadow
         virtual ~Mesh() = default;
         virtual void draw(std::shared_ptr<GLShader> shader) const = 0;
         virtual ShaderType getShaderType() const = 0;
+        const BoundingBox& getBounds() const;
     protected:
         Mesh() = default;
+        BoundingBox bounds{}; // local space, filled by the derived meshes
     };
+
+    inline const BoundingBox& Mesh::getBounds() const
+    {
+        return bounds;
+    }
 }
 
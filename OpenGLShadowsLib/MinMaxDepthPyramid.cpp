@@ -0,0 +1,89 @@
+#include "MinMaxDepthPyramid.h"
+
+#include <algorithm>
+
+shadow::MinMaxDepthPyramid::~MinMaxDepthPyramid()
+{
+    deleteTexture();
+}
+
+bool shadow::MinMaxDepthPyramid::initialize(std::shared_ptr<GLShader> shader, GLsizei sourceSize)
+{
+    if (!shader)
+    {
+        SHADOW_ERROR("Min/max depth pyramid requires a compute shader!");
+        return false;
+    }
+    if (sourceSize <= 0)
+    {
+        SHADOW_ERROR("Invalid min/max depth pyramid source size ({})!", sourceSize);
+        return false;
+    }
+    this->shader = shader;
+    this->sourceSize = sourceSize;
+    createTexture();
+    return true;
+}
+
+void shadow::MinMaxDepthPyramid::resize(GLsizei sourceSize)
+{
+    assert(texture);
+    assert(sourceSize > 0);
+    if (this->sourceSize == sourceSize)
+    {
+        return;
+    }
+    deleteTexture();
+    this->sourceSize = sourceSize;
+    createTexture();
+}
+
+void shadow::MinMaxDepthPyramid::build(GLuint depthTexture) const
+{
+    assert(shader);
+    assert(texture);
+    shader->use();
+    glActiveTexture(GL_TEXTURE14);
+    GLsizei levelSize = size;
+    for (GLsizei level = 0; level < levels; ++level)
+    {
+        // the first level reduces the shadow map itself, every other one the level above it
+        glBindTexture(GL_TEXTURE_2D, level == 0 ? depthTexture : texture);
+        shader->setInt("sourceLevel", level - 1);
+        glBindImageTexture(0, texture, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_RG32F);
+        glDispatchCompute((levelSize + LOCAL_SIZE - 1U) / LOCAL_SIZE, (levelSize + LOCAL_SIZE - 1U) / LOCAL_SIZE, 1U);
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+        levelSize = std::max(levelSize / 2, 1);
+    }
+    glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RG32F);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void shadow::MinMaxDepthPyramid::createTexture()
+{
+    size = std::max(sourceSize / 2, 1);
+    levels = 1;
+    for (GLsizei levelSize = size; levelSize > 1; levelSize /= 2)
+    {
+        ++levels;
+    }
+    SHADOW_DEBUG("Creating {}x{} min/max depth pyramid with {} levels...", size, size, levels);
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexStorage2D(GL_TEXTURE_2D, levels, GL_RG32F, size, size);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void shadow::MinMaxDepthPyramid::deleteTexture()
+{
+    if (texture)
+    {
+        glDeleteTextures(1, &texture);
+        texture = 0;
+    }
+}
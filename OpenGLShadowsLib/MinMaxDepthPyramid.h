@@ -0,0 +1,38 @@
+#pragma once
+
+#include "GLShader.h"
+
+#include <memory>
+
+namespace shadow
+{
+    // mip chain of the minimum and maximum depth of a shadow map, its first level halves the map,
+    // lets the blocker search classify a whole region with a few texel fetches
+    class MinMaxDepthPyramid final
+    {
+    public:
+        MinMaxDepthPyramid() = default;
+        ~MinMaxDepthPyramid();
+        MinMaxDepthPyramid(MinMaxDepthPyramid&) = delete;
+        MinMaxDepthPyramid(MinMaxDepthPyramid&&) = delete;
+        MinMaxDepthPyramid& operator=(MinMaxDepthPyramid&) = delete;
+        MinMaxDepthPyramid& operator=(MinMaxDepthPyramid&&) = delete;
+        bool initialize(std::shared_ptr<GLShader> shader, GLsizei sourceSize);
+        void resize(GLsizei sourceSize);
+        void build(GLuint depthTexture) const;
+        inline GLuint getTexture() const;
+    private:
+        static constexpr GLuint LOCAL_SIZE{ 8U };
+        void createTexture();
+        void deleteTexture();
+        std::shared_ptr<GLShader> shader{};
+        GLsizei sourceSize{}, size{}, levels{};
+        GLuint texture{};
+    };
+
+    inline GLuint MinMaxDepthPyramid::getTexture() const
+    {
+        assert(texture);
+        return texture;
+    }
+}
@@ -26,6 +26,7 @@ bool shadow::ModelMesh::load()
             vertices.push_back(TextureVertex{ meshData.vertices[i], meshData.normals[i], meshData.texCoords[i], meshData.tangents[i], meshData.bitangents[i] });
         }
         meshes.push_back(std::make_shared<TextureMesh>(vertices, meshData.indices, meshData.textures));
+        bounds.extend(meshes.back()->getBounds());
     }
     return true;
 }
@@ -0,0 +1,331 @@
+#include "MomentShadowRenderers.h"
+#include "ResourceManager.h"
+#include "Benchmark.h"
+#include "GLDebug.h"
+
+#include <glm/gtc/type_ptr.hpp>
+#include "imgui.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+bool shadow::MomentShadowRenderer::initialize(GLsizei textureSize, GLsizei windowWidth, GLsizei windowHeight)
+{
+    if (!ShadowRenderer::initialize(textureSize, windowWidth, windowHeight))
+    {
+        return false;
+    }
+    ResourceManager& resourceManager = ResourceManager::getInstance();
+    dirDepthShader = resourceManager.getShader(dirDepthShaderType);
+    spotDepthShader = resourceManager.getShader(spotDepthShaderType);
+    if (!shadowMaps.initialize(format, textureSize, mipmapped))
+    {
+        return false;
+    }
+    updateClearColor();
+    return true;
+}
+
+void shadow::MomentShadowRenderer::resize(GLsizei textureSize)
+{
+    assert(textureSize > 0);
+    if (this->textureSize == textureSize)
+    {
+        return;
+    }
+    shadowMaps.resize(textureSize);
+    this->textureSize = textureSize;
+    markModified();
+}
+
+shadow::ShaderIncludes shadow::MomentShadowRenderer::getShaderIncludes() const
+{
+    ShaderIncludes includes = ShadowRenderer::getShaderIncludes();
+    includes[SHADOW_MAP_FORMAT_INCLUDE_TEXT] = getShadowMapFormatIncludeContent(format, false);
+    return includes;
+}
+
+bool shadow::MomentShadowRenderer::hasDepthMaps() const
+{
+    return false;
+}
+
+GLuint shadow::MomentShadowRenderer::getDirFbo() const
+{
+    return shadowMaps.getLayerFbo(DIR_LAYER);
+}
+
+GLuint shadow::MomentShadowRenderer::getSpotFbo() const
+{
+    return shadowMaps.getLayerFbo(SPOT_LAYER);
+}
+
+GLuint shadow::MomentShadowRenderer::getDirTexture() const
+{
+    return shadowMaps.getLayerTexture(DIR_LAYER);
+}
+
+GLuint shadow::MomentShadowRenderer::getSpotTexture() const
+{
+    return shadowMaps.getLayerTexture(SPOT_LAYER);
+}
+
+GLenum shadow::MomentShadowRenderer::getColorFormat() const
+{
+    return format;
+}
+
+glm::vec4 shadow::MomentShadowRenderer::getClearColor() const
+{
+    return glm::vec4(1.0f, 1.0f, 0.0f, 0.0f);
+}
+
+shadow::MomentShadowRenderer::MomentShadowRenderer(GLenum format, bool mipmapped, ShaderType dirDepthShaderType, ShaderType spotDepthShaderType)
+    : format(format), mipmapped(mipmapped), dirDepthShaderType(dirDepthShaderType), spotDepthShaderType(spotDepthShaderType)
+{
+}
+
+void shadow::MomentShadowRenderer::setFormat(GLenum format)
+{
+    if (this->format == format)
+    {
+        return;
+    }
+    this->format = format;
+    shadowMaps.setInternalFormat(format);
+    updateClearColor();
+    updateShaderIncludes();
+    markModified();
+}
+
+void shadow::MomentShadowRenderer::updateClearColor()
+{
+    shadowMaps.setBorderColor(getClearColor());
+}
+
+const shadow::ShadowMapArray& shadow::MomentShadowRenderer::getShadowMaps() const
+{
+    return shadowMaps;
+}
+
+bool shadow::BlurredShadowRenderer::initialize(GLsizei textureSize, GLsizei windowWidth, GLsizei windowHeight)
+{
+    return MomentShadowRenderer::initialize(textureSize, windowWidth, windowHeight)
+        && gaussianBlur.initialize(ResourceManager::getInstance().getShader(ShaderType::GaussianBlur));
+}
+
+void shadow::BlurredShadowRenderer::renderShadowPasses(Scene& scene, bool dirPaged)
+{
+    GL_PUSH_DEBUG_GROUP("Gaussian blur");
+    gaussianBlur.blur(getShadowMaps(), blurRadius, blurPasses);
+    GL_POP_DEBUG_GROUP();
+}
+
+void shadow::BlurredShadowRenderer::drawSettings()
+{
+    int blurPasses = static_cast<int>(this->blurPasses), blurRadius = static_cast<int>(this->blurRadius);
+    if (ImGui::SliderInt("Blur passes", &blurPasses, 0, 100))
+    {
+        setBlurPasses(static_cast<unsigned int>(blurPasses));
+    }
+    if (ImGui::SliderInt("Blur radius", &blurRadius, 1, static_cast<int>(SeparableBlur::MAX_RADIUS)))
+    {
+        setBlurRadius(static_cast<unsigned int>(blurRadius));
+    }
+}
+
+void shadow::BlurredShadowRenderer::setBlurPasses(unsigned int blurPasses)
+{
+    this->blurPasses = blurPasses;
+}
+
+unsigned int shadow::BlurredShadowRenderer::getBlurPasses() const
+{
+    return blurPasses;
+}
+
+void shadow::BlurredShadowRenderer::setBlurRadius(unsigned int blurRadius)
+{
+    this->blurRadius = std::min(blurRadius, SeparableBlur::MAX_RADIUS);
+}
+
+unsigned int shadow::BlurredShadowRenderer::getBlurRadius() const
+{
+    return blurRadius;
+}
+
+shadow::BlurredShadowRenderer::BlurredShadowRenderer(GLenum format, ShaderType dirDepthShaderType, ShaderType spotDepthShaderType)
+    : MomentShadowRenderer(format, false, dirDepthShaderType, spotDepthShaderType)
+{
+}
+
+shadow::VSMShadowRenderer::VSMShadowRenderer() : BlurredShadowRenderer(FORMAT, ShaderType::DepthDirVSM, ShaderType::DepthSpotVSM)
+{
+}
+
+shadow::ShadowTechnique shadow::VSMShadowRenderer::getTechnique() const
+{
+    return ShadowTechnique::VSM;
+}
+
+std::unique_ptr<shadow::TechniqueConfigurator> shadow::VSMShadowRenderer::createConfigurator()
+{
+    return std::make_unique<VSMConfigurator>(*this, AppWindow::getInstance(), ResourceManager::getInstance());
+}
+
+shadow::MSMShadowRenderer::MSMShadowRenderer() : BlurredShadowRenderer(FORMAT_16, ShaderType::DepthDirMSM, ShaderType::DepthSpotMSM)
+{
+}
+
+shadow::ShadowTechnique shadow::MSMShadowRenderer::getTechnique() const
+{
+    return ShadowTechnique::MSM;
+}
+
+shadow::ShaderIncludes shadow::MSMShadowRenderer::getShaderIncludes() const
+{
+    ShaderIncludes includes = BlurredShadowRenderer::getShaderIncludes();
+    includes[SHADOW_MAP_FORMAT_INCLUDE_TEXT] = getShadowMapFormatIncludeContent(getColorFormat(), getColorFormat() == FORMAT_16);
+    return includes;
+}
+
+glm::vec4 shadow::MSMShadowRenderer::getClearColor() const
+{
+    if (getColorFormat() == FORMAT_16)
+    {
+        return glm::vec4(1.0f, 0.99755993f, 0.89343751f, 0.0f); // same moments in the quantized basis
+    }
+    return glm::vec4(1.0f);
+}
+
+void shadow::MSMShadowRenderer::drawSettings()
+{
+    BlurredShadowRenderer::drawSettings();
+    bool fullPrecision = getMomentBits() == 32U;
+    if (ImGui::Checkbox("32-bit moments", &fullPrecision))
+    {
+        setMomentBits(fullPrecision ? 32U : 16U);
+    }
+}
+
+void shadow::MSMShadowRenderer::setMomentBits(unsigned int momentBits)
+{
+    assert(momentBits == 16U || momentBits == 32U);
+    setFormat(momentBits == 16U ? FORMAT_16 : FORMAT_32);
+}
+
+unsigned int shadow::MSMShadowRenderer::getMomentBits() const
+{
+    return getColorFormat() == FORMAT_32 ? 32U : 16U;
+}
+
+std::unique_ptr<shadow::TechniqueConfigurator> shadow::MSMShadowRenderer::createConfigurator()
+{
+    return std::make_unique<MSMConfigurator>(*this, AppWindow::getInstance(), ResourceManager::getInstance());
+}
+
+std::string shadow::EVSMShadowRenderer::getEvsmIncludeContent(float positiveExponent, float negativeExponent, float mipBias)
+{
+    assert(positiveExponent > 0.0f);
+    assert(negativeExponent > 0.0f);
+    std::stringstream ss{};
+    ss << std::showpoint;
+    ss << "#define EVSM_POSITIVE_EXPONENT " << positiveExponent << std::endl;
+    ss << "#define EVSM_NEGATIVE_EXPONENT " << negativeExponent << std::endl;
+    ss << "#define EVSM_MIP_BIAS " << mipBias << std::endl;
+    return ss.str();
+}
+
+shadow::EVSMShadowRenderer::EVSMShadowRenderer() : MomentShadowRenderer(FORMAT_32, true, ShaderType::DepthDirEVSM, ShaderType::DepthSpotEVSM)
+{
+}
+
+shadow::ShadowTechnique shadow::EVSMShadowRenderer::getTechnique() const
+{
+    return ShadowTechnique::EVSM;
+}
+
+shadow::ShaderIncludes shadow::EVSMShadowRenderer::getShaderIncludes() const
+{
+    ShaderIncludes includes = MomentShadowRenderer::getShaderIncludes();
+    glm::vec2 exponents = getExponents();
+    includes[EVSM_INCLUDE_TEXT] = getEvsmIncludeContent(exponents.x, exponents.y, mipBias);
+    return includes;
+}
+
+glm::vec4 shadow::EVSMShadowRenderer::getClearColor() const
+{
+    glm::vec2 exponents = getExponents();
+    float positive = std::exp(exponents.x), negative = std::exp(-exponents.y);
+    return glm::vec4(positive, positive * positive, -negative, negative * negative);
+}
+
+void shadow::EVSMShadowRenderer::renderShadowPasses(Scene& scene, bool dirPaged)
+{
+    GL_PUSH_DEBUG_GROUP("Shadow map mipmaps");
+    getShadowMaps().generateMipmaps();
+    GL_POP_DEBUG_GROUP();
+}
+
+void shadow::EVSMShadowRenderer::drawSettings()
+{
+    glm::vec2 exponents = getExponents();
+    if (ImGui::DragFloat2("EVSM exponents", value_ptr(exponents), 0.1f, 0.5f, MAX_EXPONENT_32))
+    {
+        setExponents(exponents.x, exponents.y);
+    }
+    float mipBias = this->mipBias;
+    if (ImGui::DragFloat("EVSM mip bias", &mipBias, 0.05f, -2.0f, 4.0f))
+    {
+        setMipBias(mipBias);
+    }
+    bool fullPrecision = getMomentBits() == 32U;
+    if (ImGui::Checkbox("32-bit moments", &fullPrecision))
+    {
+        setMomentBits(fullPrecision ? 32U : 16U);
+    }
+}
+
+void shadow::EVSMShadowRenderer::setMomentBits(unsigned int momentBits)
+{
+    assert(momentBits == 16U || momentBits == 32U);
+    setFormat(momentBits == 16U ? FORMAT_16 : FORMAT_32); // the exponents are clamped to the format
+}
+
+unsigned int shadow::EVSMShadowRenderer::getMomentBits() const
+{
+    return getColorFormat() == FORMAT_32 ? 32U : 16U;
+}
+
+void shadow::EVSMShadowRenderer::setExponents(float positiveExponent, float negativeExponent)
+{
+    assert(positiveExponent > 0.0f);
+    assert(negativeExponent > 0.0f);
+    this->positiveExponent = positiveExponent;
+    this->negativeExponent = negativeExponent;
+    updateClearColor();
+    updateShaderIncludes();
+    markModified(); // the cached moments were warped with the previous exponents
+}
+
+glm::vec2 shadow::EVSMShadowRenderer::getExponents() const
+{
+    float maxExponent = getColorFormat() == FORMAT_16 ? MAX_EXPONENT_16 : MAX_EXPONENT_32;
+    return glm::min(glm::vec2(positiveExponent, negativeExponent), glm::vec2(maxExponent));
+}
+
+void shadow::EVSMShadowRenderer::setMipBias(float mipBias)
+{
+    this->mipBias = mipBias;
+    updateShaderIncludes();
+}
+
+float shadow::EVSMShadowRenderer::getMipBias() const
+{
+    return mipBias;
+}
+
+std::unique_ptr<shadow::TechniqueConfigurator> shadow::EVSMShadowRenderer::createConfigurator()
+{
+    return std::make_unique<EVSMConfigurator>(*this, AppWindow::getInstance(), ResourceManager::getInstance());
+}
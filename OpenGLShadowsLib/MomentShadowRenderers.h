@@ -0,0 +1,105 @@
+#pragma once
+
+#include "ShadowRenderer.h"
+#include "ShaderType.h"
+#include "ShadowMapArray.h"
+#include "SeparableBlur.h"
+
+namespace shadow
+{
+    // techniques storing prefilterable moments instead of plain depth, both lights share a single map array
+    class MomentShadowRenderer abstract : public ShadowRenderer
+    {
+    public:
+        bool initialize(GLsizei textureSize, GLsizei windowWidth, GLsizei windowHeight) override;
+        void resize(GLsizei textureSize) override;
+        ShaderIncludes getShaderIncludes() const override;
+        bool hasDepthMaps() const override;
+        GLuint getDirFbo() const override;
+        GLuint getSpotFbo() const override;
+        GLuint getDirTexture() const override;
+        GLuint getSpotTexture() const override;
+        GLenum getColorFormat() const override;
+        glm::vec4 getClearColor() const override; // moments of the far plane, so that texels without any caster never shadow
+    protected:
+        MomentShadowRenderer(GLenum format, bool mipmapped, ShaderType dirDepthShaderType, ShaderType spotDepthShaderType);
+        void setFormat(GLenum format);
+        // whatever the clear color depends on has changed, which the border of the maps has to follow
+        void updateClearColor();
+        const ShadowMapArray& getShadowMaps() const;
+    private:
+        static constexpr GLsizei DIR_LAYER{ 0 }, SPOT_LAYER{ 1 };
+        ShadowMapArray shadowMaps{};
+        GLenum format{};
+        bool mipmapped{};
+        ShaderType dirDepthShaderType{}, spotDepthShaderType{};
+    };
+
+    class BlurredShadowRenderer abstract : public MomentShadowRenderer
+    {
+    public:
+        bool initialize(GLsizei textureSize, GLsizei windowWidth, GLsizei windowHeight) override;
+        void renderShadowPasses(Scene& scene, bool dirPaged) override;
+        void drawSettings() override;
+        void setBlurPasses(unsigned int blurPasses);
+        unsigned int getBlurPasses() const;
+        void setBlurRadius(unsigned int blurRadius);
+        unsigned int getBlurRadius() const;
+    protected:
+        BlurredShadowRenderer(GLenum format, ShaderType dirDepthShaderType, ShaderType spotDepthShaderType);
+    private:
+        SeparableBlur gaussianBlur{};
+        unsigned int blurPasses{ 1U }, blurRadius{ 2U };
+    };
+
+    class VSMShadowRenderer final : public BlurredShadowRenderer
+    {
+    public:
+        static constexpr GLenum FORMAT{ GL_RG32F };
+        VSMShadowRenderer();
+        ShadowTechnique getTechnique() const override;
+    protected:
+        std::unique_ptr<TechniqueConfigurator> createConfigurator() override;
+    };
+
+    class MSMShadowRenderer final : public BlurredShadowRenderer
+    {
+    public:
+        static constexpr GLenum FORMAT_16{ GL_RGBA16 }, FORMAT_32{ GL_RGBA32F };
+        MSMShadowRenderer();
+        ShadowTechnique getTechnique() const override;
+        ShaderIncludes getShaderIncludes() const override;
+        glm::vec4 getClearColor() const override;
+        void drawSettings() override;
+        void setMomentBits(unsigned int momentBits);
+        unsigned int getMomentBits() const;
+    protected:
+        std::unique_ptr<TechniqueConfigurator> createConfigurator() override;
+    };
+
+    // prefiltered with mipmaps instead of a blur
+    class EVSMShadowRenderer final : public MomentShadowRenderer
+    {
+    public:
+        static constexpr GLenum FORMAT_16{ GL_RGBA16F }, FORMAT_32{ GL_RGBA32F };
+        static constexpr float DEFAULT_POSITIVE_EXPONENT{ 40.0f }, DEFAULT_NEGATIVE_EXPONENT{ 5.0f };
+        static constexpr float MAX_EXPONENT_16{ 5.54f }, MAX_EXPONENT_32{ 42.0f }; // the squared warped far plane has to fit the format
+        static std::string getEvsmIncludeContent(float positiveExponent, float negativeExponent, float mipBias);
+        EVSMShadowRenderer();
+        ShadowTechnique getTechnique() const override;
+        ShaderIncludes getShaderIncludes() const override;
+        glm::vec4 getClearColor() const override;
+        void renderShadowPasses(Scene& scene, bool dirPaged) override;
+        void drawSettings() override;
+        void setMomentBits(unsigned int momentBits);
+        unsigned int getMomentBits() const;
+        void setExponents(float positiveExponent, float negativeExponent);
+        glm::vec2 getExponents() const; // clamped to the format
+        void setMipBias(float mipBias);
+        float getMipBias() const;
+    protected:
+        std::unique_ptr<TechniqueConfigurator> createConfigurator() override;
+    private:
+        float positiveExponent{ DEFAULT_POSITIVE_EXPONENT }, negativeExponent{ DEFAULT_NEGATIVE_EXPONENT }, mipBias{ 0.0f };
+    };
+}
@@ -0,0 +1,170 @@
+#include "ProgramBinaryCache.h"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+bool shadow::ProgramBinaryCache::initialize(const std::filesystem::path& cacheDirectory)
+{
+    GLint formatCount{};
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    if (formatCount <= 0)
+    {
+        SHADOW_WARN("The driver does not support any program binary formats, shaders will always be compiled.");
+        return false;
+    }
+    std::error_code error{};
+    create_directories(cacheDirectory, error);
+    if (error || !is_directory(cacheDirectory))
+    {
+        SHADOW_WARN("Unable to create program binary cache directory '{}', shaders will always be compiled.", cacheDirectory.generic_string());
+        return false;
+    }
+    this->cacheDirectory = cacheDirectory;
+    std::stringstream ss{};
+    ss << reinterpret_cast<const char*>(glGetString(GL_VENDOR)) << '|' << reinterpret_cast<const char*>(glGetString(GL_RENDERER)) << '|' << reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    driverId = ss.str();
+    available = true;
+    SHADOW_DEBUG("Program binary cache initialized in '{}' for '{}'.", cacheDirectory.generic_string(), driverId);
+    return true;
+}
+
+bool shadow::ProgramBinaryCache::isAvailable() const
+{
+    return available;
+}
+
+std::string shadow::ProgramBinaryCache::getKey(const std::vector<std::pair<GLenum, std::string>>& stageSources) const
+{
+    // 64-bit FNV-1a
+    uint64_t hash{ 14695981039346656037ULL };
+    auto hashBytes = [&hash](const void* data, size_t size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0U; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    };
+    hashBytes(driverId.data(), driverId.size());
+    for (const std::pair<GLenum, std::string>& stage : stageSources)
+    {
+        hashBytes(&stage.first, sizeof(stage.first));
+        hashBytes(stage.second.data(), stage.second.size() + 1U); // the terminator separates the stages
+    }
+    std::stringstream ss{};
+    ss << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return ss.str();
+}
+
+bool shadow::ProgramBinaryCache::contains(const std::string& key) const
+{
+    return available && exists(getFilePath(key));
+}
+
+bool shadow::ProgramBinaryCache::load(GLuint& programId, const std::string& key)
+{
+    if (!available)
+    {
+        ++missCount;
+        return false;
+    }
+    const std::filesystem::path path = getFilePath(key);
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream)
+    {
+        ++missCount;
+        return false;
+    }
+    std::string magic(FILE_MAGIC_LENGTH, '\0'), fileDriverId{};
+    uint32_t driverIdLength{};
+    GLenum binaryFormat{};
+    std::vector<char> binary{};
+    stream.read(magic.data(), FILE_MAGIC_LENGTH);
+    stream.read(reinterpret_cast<char*>(&driverIdLength), sizeof(driverIdLength));
+    if (stream && magic == FILE_MAGIC && driverIdLength == driverId.size())
+    {
+        fileDriverId.resize(driverIdLength);
+        stream.read(fileDriverId.data(), driverIdLength);
+        stream.read(reinterpret_cast<char*>(&binaryFormat), sizeof(binaryFormat));
+        binary.assign(std::istreambuf_iterator<char>(stream), {});
+    }
+    stream.close();
+    if (fileDriverId != driverId || binary.empty())
+    {
+        SHADOW_WARN("Program binary '{}' is invalid or was built by a different driver, discarding it.", path.generic_string());
+        std::error_code error{};
+        remove(path, error);
+        ++missCount;
+        return false;
+    }
+    programId = glCreateProgram();
+    glProgramBinary(programId, binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+    GLint isFine;
+    glGetProgramiv(programId, GL_LINK_STATUS, &isFine);
+    if (!isFine)
+    {
+        // drivers may reject their own binaries, e.g. after an update that kept the version string
+        SHADOW_WARN("Program binary '{}' was rejected by the driver, discarding it.", path.generic_string());
+        glDeleteProgram(programId);
+        programId = 0U;
+        std::error_code error{};
+        remove(path, error);
+        ++missCount;
+        return false;
+    }
+    ++hitCount;
+    SHADOW_DEBUG("Program loaded from binary '{}' as {}!", path.generic_string(), programId);
+    return true;
+}
+
+void shadow::ProgramBinaryCache::store(GLuint programId, const std::string& key)
+{
+    if (!available)
+    {
+        return;
+    }
+    GLint binaryLength{};
+    glGetProgramiv(programId, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+    if (binaryLength <= 0)
+    {
+        SHADOW_WARN("Program {} has no retrievable binary!", programId);
+        return;
+    }
+    std::vector<char> binary(binaryLength);
+    GLenum binaryFormat{};
+    glGetProgramBinary(programId, binaryLength, &binaryLength, &binaryFormat, binary.data());
+    const std::filesystem::path path = getFilePath(key);
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    const uint32_t driverIdLength = static_cast<uint32_t>(driverId.size());
+    stream.write(FILE_MAGIC, FILE_MAGIC_LENGTH);
+    stream.write(reinterpret_cast<const char*>(&driverIdLength), sizeof(driverIdLength));
+    stream.write(driverId.data(), driverId.size());
+    stream.write(reinterpret_cast<const char*>(&binaryFormat), sizeof(binaryFormat));
+    stream.write(binary.data(), binaryLength);
+    if (!stream)
+    {
+        SHADOW_WARN("Failed to write program binary '{}'!", path.generic_string());
+        stream.close();
+        std::error_code error{};
+        remove(path, error);
+        return;
+    }
+    SHADOW_DEBUG("Program {} stored as binary '{}' ({} bytes).", programId, path.generic_string(), binaryLength);
+}
+
+unsigned int shadow::ProgramBinaryCache::getHitCount() const
+{
+    return hitCount;
+}
+
+unsigned int shadow::ProgramBinaryCache::getMissCount() const
+{
+    return missCount;
+}
+
+std::filesystem::path shadow::ProgramBinaryCache::getFilePath(const std::string& key) const
+{
+    return cacheDirectory / (key + ".bin");
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "ShadowLog.h"
+
+#include "glad/glad.h"
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace shadow
+{
+    // on-disk cache of linked program binaries, keyed by the preprocessed stage sources and the driver they were built with
+    class ProgramBinaryCache final
+    {
+    public:
+        ProgramBinaryCache() = default;
+        ~ProgramBinaryCache() = default;
+        ProgramBinaryCache(ProgramBinaryCache&) = delete;
+        ProgramBinaryCache(ProgramBinaryCache&&) = delete;
+        ProgramBinaryCache& operator=(ProgramBinaryCache&) = delete;
+        ProgramBinaryCache& operator=(ProgramBinaryCache&&) = delete;
+        bool initialize(const std::filesystem::path& cacheDirectory);
+        bool isAvailable() const;
+        std::string getKey(const std::vector<std::pair<GLenum, std::string>>& stageSources) const;
+        bool contains(const std::string& key) const;
+        bool load(GLuint& programId, const std::string& key);
+        void store(GLuint programId, const std::string& key);
+        unsigned int getHitCount() const;
+        unsigned int getMissCount() const;
+    private:
+        std::filesystem::path getFilePath(const std::string& key) const;
+        const char* FILE_MAGIC = "SHPB";
+        const size_t FILE_MAGIC_LENGTH = strlen(FILE_MAGIC);
+        std::filesystem::path cacheDirectory{};
+        std::string driverId{};
+        bool available{};
+        unsigned int hitCount{}, missCount{};
+    };
+}
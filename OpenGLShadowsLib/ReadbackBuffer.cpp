@@ -0,0 +1,83 @@
+#include "ReadbackBuffer.h"
+
+shadow::ReadbackBuffer::~ReadbackBuffer()
+{
+    for (GLsync& fence : fences)
+    {
+        if (fence)
+        {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    if (buffers[0])
+    {
+        glDeleteBuffers(static_cast<GLsizei>(BUFFER_COUNT), buffers.data());
+    }
+}
+
+bool shadow::ReadbackBuffer::initialize(GLsizeiptr size)
+{
+    if (size <= 0)
+    {
+        SHADOW_ERROR("Invalid readback buffer size ({})!", size);
+        return false;
+    }
+    this->size = size;
+    glGenBuffers(static_cast<GLsizei>(BUFFER_COUNT), buffers.data());
+    for (GLuint buffer : buffers)
+    {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, size, nullptr, GL_DYNAMIC_READ);
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    return true;
+}
+
+void shadow::ReadbackBuffer::bindForWrite(GLuint binding, const void* initialData)
+{
+    assert(buffers[0]);
+    if (fences[writeIndex])
+    {
+        // all buffers are in flight, the oldest result gets dropped
+        glDeleteSync(fences[writeIndex]);
+        fences[writeIndex] = nullptr;
+        readIndex = (writeIndex + 1U) % BUFFER_COUNT;
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[writeIndex]);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, initialData);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, buffers[writeIndex]);
+}
+
+void shadow::ReadbackBuffer::finishWrite()
+{
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    fences[writeIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    writeIndex = (writeIndex + 1U) % BUFFER_COUNT;
+}
+
+bool shadow::ReadbackBuffer::readLatest(void* data)
+{
+    size_t latestIndex = BUFFER_COUNT;
+    while (fences[readIndex])
+    {
+        GLenum status = glClientWaitSync(fences[readIndex], 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+        {
+            break;
+        }
+        glDeleteSync(fences[readIndex]);
+        fences[readIndex] = nullptr;
+        latestIndex = readIndex;
+        readIndex = (readIndex + 1U) % BUFFER_COUNT;
+    }
+    if (latestIndex == BUFFER_COUNT)
+    {
+        return false;
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[latestIndex]);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, data);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    return true;
+}
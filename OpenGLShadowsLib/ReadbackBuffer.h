@@ -0,0 +1,31 @@
+#pragma once
+
+#include "ShadowLog.h"
+
+#include "glad/glad.h"
+#include <array>
+
+namespace shadow
+{
+    // ring of storage buffers written by the GPU and read back once their fences are signaled, so reading never stalls
+    class ReadbackBuffer final
+    {
+    public:
+        ReadbackBuffer() = default;
+        ~ReadbackBuffer();
+        ReadbackBuffer(ReadbackBuffer&) = delete;
+        ReadbackBuffer(ReadbackBuffer&&) = delete;
+        ReadbackBuffer& operator=(ReadbackBuffer&) = delete;
+        ReadbackBuffer& operator=(ReadbackBuffer&&) = delete;
+        bool initialize(GLsizeiptr size);
+        void bindForWrite(GLuint binding, const void* initialData);
+        void finishWrite();
+        bool readLatest(void* data);
+    private:
+        static constexpr size_t BUFFER_COUNT{ 3U };
+        GLsizeiptr size{};
+        std::array<GLuint, BUFFER_COUNT> buffers{};
+        std::array<GLsync, BUFFER_COUNT> fences{};
+        size_t writeIndex{}, readIndex{};
+    };
+}
@@ -14,7 +14,7 @@ shadow::ResourceManager& shadow::ResourceManager::getInstance()
     return resourceManager;
 }
 
-bool shadow::ResourceManager::initialize(std::filesystem::path resourceDirectory, GLsizei windowWidth, GLsizei windowHeight)
+bool shadow::ResourceManager::initialize(std::filesystem::path resourceDirectory, GLsizei windowWidth, GLsizei windowHeight, const ShaderIncludes& shadowIncludes)
 {
     assert(!initialised);
     if (!exists(resourceDirectory))
@@ -75,9 +75,9 @@ bool shadow::ResourceManager::initialize(std::filesystem::path resourceDirectory
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex2D), reinterpret_cast<void*>(offsetof(Vertex2D, texCoords)));
     glBindVertexArray(0);
     this->resourceDirectory = resourceDirectory;
-    shaderManager.reset(new ShaderManager(shadersDirectory));
+    shaderManager.reset(new ShaderManager(shadersDirectory, resourceDirectory / SHADER_CACHE_DIR));
     initialised = true;
-    shaderManager->loadShaders(windowWidth, windowHeight);
+    shaderManager->loadShaders(windowWidth, windowHeight, shadowIncludes);
     return true;
 }
 
@@ -91,28 +91,51 @@ void shadow::ResourceManager::updateShaders() const
     shaderManager->updateShaders();
 }
 
-#if SHADOW_MASTER || SHADOW_CHSS
+unsigned int shadow::ResourceManager::prewarmShaders() const
+{
+    return shaderManager->prewarmShaders();
+}
+
 void shadow::ResourceManager::updateVogelDisk(unsigned int shadowSamples, unsigned int penumbraSamples)
 {
     shaderManager->updateVogelDisk(shadowSamples, penumbraSamples);
 }
-#elif SHADOW_PCSS
+
 void shadow::ResourceManager::updatePoisson(unsigned int shadowSamples, unsigned int penumbraSamples)
 {
     shaderManager->updatePoisson(shadowSamples, penumbraSamples);
 }
-#elif SHADOW_PCF
+
 void shadow::ResourceManager::updateFilterSize(unsigned int filterSize)
 {
     shaderManager->updateFilterSize(filterSize);
 }
-#endif
+
+void shadow::ResourceManager::updateAdaptiveSampling(unsigned int earlyOutSamples, float samplesPerTexel)
+{
+    shaderManager->updateAdaptiveSampling(earlyOutSamples, samplesPerTexel);
+}
+
+void shadow::ResourceManager::updateShaderIncludes(const ShaderIncludes& includes)
+{
+    shaderManager->updateShaderIncludes(includes);
+}
+
+void shadow::ResourceManager::updateVirtualShadowMap(bool enabled, unsigned int virtualPages, unsigned int poolPages)
+{
+    shaderManager->updateVirtualShadowMap(enabled, virtualPages, poolPages);
+}
 
 std::string shadow::ResourceManager::getShaderFileContent(const std::filesystem::path& path)
 {
     return shaderManager->getShaderFileContent(path);
 }
 
+unsigned int shadow::ResourceManager::getShaderFileRevision(const std::filesystem::path& path) const
+{
+    return shaderManager->getShaderFileRevision(path);
+}
+
 std::shared_ptr<shadow::Texture> shadow::ResourceManager::getTexture(const std::filesystem::path& path)
 {
     return getTexture(path, true);
@@ -157,6 +180,11 @@ std::shared_ptr<shadow::GLShader> shadow::ResourceManager::getShader(ShaderType
     return shaderManager->getShader(shaderType);
 }
 
+shadow::ProgramBinaryCache& shadow::ResourceManager::getProgramBinaryCache()
+{
+    return shaderManager->getProgramBinaryCache();
+}
+
 std::shared_ptr<shadow::UboMvp> shadow::ResourceManager::getUboMvp() const
 {
     return shaderManager->getUboMvp();
@@ -177,6 +205,16 @@ std::shared_ptr<shadow::UboWindow> shadow::ResourceManager::getUboWindow() const
     return shaderManager->getUboWindow();
 }
 
+std::shared_ptr<shadow::UboSampling> shadow::ResourceManager::getUboSampling() const
+{
+    return shaderManager->getUboSampling();
+}
+
+std::shared_ptr<shadow::SsboPointLights> shadow::ResourceManager::getSsboPointLights() const
+{
+    return shaderManager->getSsboPointLights();
+}
+
 void shadow::ResourceManager::renderQuad() const
 {
     glBindVertexArray(quadVao);
@@ -22,25 +22,29 @@ namespace shadow
         ResourceManager& operator=(ResourceManager&) = delete;
         ResourceManager& operator=(ResourceManager&&) = delete;
         static ResourceManager& getInstance();
-        bool initialize(std::filesystem::path resourceDirectory, GLsizei windowWidth, GLsizei windowHeight);
+        bool initialize(std::filesystem::path resourceDirectory, GLsizei windowWidth, GLsizei windowHeight, const ShaderIncludes& shadowIncludes);
         bool reworkShaderFiles();
         void updateShaders() const;
-#if SHADOW_MASTER || SHADOW_CHSS
+        unsigned int prewarmShaders() const;
         void updateVogelDisk(unsigned int shadowSamples, unsigned int penumbraSamples);
-#elif SHADOW_PCSS
         void updatePoisson(unsigned int shadowSamples, unsigned int penumbraSamples);
-#elif SHADOW_PCF
         void updateFilterSize(unsigned int filterSize);
-#endif
+        void updateAdaptiveSampling(unsigned int earlyOutSamples, float samplesPerTexel);
+        void updateShaderIncludes(const ShaderIncludes& includes);
+        void updateVirtualShadowMap(bool enabled, unsigned int virtualPages, unsigned int poolPages);
         std::string getShaderFileContent(const std::filesystem::path& path);
+        unsigned int getShaderFileRevision(const std::filesystem::path& path) const;
         std::shared_ptr<Texture> getTexture(const std::filesystem::path& path);
         std::shared_ptr<ModelMesh> getModel(const std::filesystem::path& path);
         std::shared_ptr<MaterialModelMesh> getMaterialModel(const std::filesystem::path& path, std::shared_ptr<Material> material);
         std::shared_ptr<GLShader> getShader(ShaderType shaderType);
+        ProgramBinaryCache& getProgramBinaryCache();
         std::shared_ptr<UboMvp> getUboMvp() const;
         std::shared_ptr<UboMaterial> getUboMaterial() const;
         std::shared_ptr<UboLights> getUboLights() const;
         std::shared_ptr<UboWindow> getUboWindow() const;
+        std::shared_ptr<UboSampling> getUboSampling() const;
+        std::shared_ptr<SsboPointLights> getSsboPointLights() const;
         void renderQuad() const;
         static std::filesystem::path reworkPath(const std::filesystem::path& basePath, const std::filesystem::path& midPath, const std::filesystem::path& inputPath);
     private:
@@ -51,7 +55,7 @@ namespace shadow
         shadow::ModelMeshData processModelMesh(aiMesh* mesh, const aiScene* scene, const std::filesystem::path& path);
         std::shared_ptr<shadow::Texture> loadModelTexture(TextureType textureType, const std::filesystem::path& path);
         bool initialised = false;
-        const std::filesystem::path MODELS_TEXTURES_DIR{ "ModelsTextures" }, SHADERS_DIR{ "Shaders" };
+        const std::filesystem::path MODELS_TEXTURES_DIR{ "ModelsTextures" }, SHADERS_DIR{ "Shaders" }, SHADER_CACHE_DIR{ "ShaderCache" };
         std::filesystem::path resourceDirectory{}, modelsTexturesDirectory{}, shadersDirectory{};
         std::map<std::filesystem::path, std::shared_ptr<Texture>> textures{};
         std::map<std::filesystem::path, std::shared_ptr<ModelData>> modelData{};
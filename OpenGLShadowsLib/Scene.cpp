@@ -115,38 +115,77 @@ void shadow::Scene::render()
 
 void shadow::Scene::render(std::shared_ptr<GLShader> overrideShader)
 {
-    static ResourceManager& resourceManager = ResourceManager::getInstance();
     if (overrideShader)
     {
-        renderWithShader(root, overrideShader);
+        renderWithShader(root, overrideShader, nullptr);
     } else
     {
-        for (std::map<ShaderType, std::vector<std::shared_ptr<SceneNode>>>::value_type& pair : shaderMap)
+        renderSubstituted({});
+    }
+}
+
+void shadow::Scene::renderCasters(std::shared_ptr<GLShader> overrideShader, bool dynamic)
+{
+    assert(overrideShader);
+    renderCasters(root, overrideShader, dynamic, false);
+}
+
+void shadow::Scene::renderSubstituted(const std::map<ShaderType, ShaderType>& substitutes)
+{
+    static ResourceManager& resourceManager = ResourceManager::getInstance();
+    for (std::map<ShaderType, std::vector<std::shared_ptr<SceneNode>>>::value_type& pair : shaderMap)
+    {
+        if (pair.first != ShaderType::None && !pair.second.empty())
         {
-            if (pair.first != ShaderType::None && !pair.second.empty())
+            const std::map<ShaderType, ShaderType>::const_iterator substitute = substitutes.find(pair.first);
+            std::shared_ptr<GLShader> shader = resourceManager.getShader(substitute == substitutes.end() ? pair.first : substitute->second);
+            shader->use();
+            for (std::shared_ptr<SceneNode>& node : pair.second)
             {
-                std::shared_ptr<GLShader> shader = resourceManager.getShader(pair.first);
-                shader->use();
-                for (std::shared_ptr<SceneNode>& node : pair.second)
+                if (node->isActive())
                 {
-                    if (node->isActive())
-                    {
-                        assert(node->getMesh());
-                        glm::mat4 model = node->getWorld();
-                        uboMvp->setModel(model);
-                        node->getMesh()->draw(shader);
-                    }
+                    assert(node->getMesh());
+                    glm::mat4 model = node->getWorld();
+                    uboMvp->setModel(model);
+                    node->getMesh()->draw(shader);
                 }
             }
         }
     }
 }
 
+void shadow::Scene::render(std::shared_ptr<GLShader> overrideShader, const glm::mat4& cullViewProjection)
+{
+    assert(overrideShader);
+    renderWithShader(root, overrideShader, &cullViewProjection);
+}
+
 std::shared_ptr<shadow::Camera> shadow::Scene::getCamera() const
 {
     return camera;
 }
 
+shadow::BoundingBox shadow::Scene::getWorldBounds() const
+{
+    BoundingBox bounds{};
+    extendWorldBounds(root, bounds);
+    return bounds;
+}
+
+std::map<const shadow::SceneNode*, shadow::BoundingBox> shadow::Scene::getNodeWorldBounds() const
+{
+    std::map<const SceneNode*, BoundingBox> bounds{};
+    gatherNodeWorldBounds(root, bounds);
+    return bounds;
+}
+
+std::map<const shadow::SceneNode*, shadow::BoundingBox> shadow::Scene::getCasterWorldBounds(bool dynamic) const
+{
+    std::map<const SceneNode*, BoundingBox> bounds{};
+    gatherCasterWorldBounds(root, bounds, dynamic, false);
+    return bounds;
+}
+
 bool shadow::Scene::isInTree(std::shared_ptr<SceneNode> tree, std::shared_ptr<SceneNode> node)
 {
     if (!node)
@@ -168,7 +207,7 @@ bool shadow::Scene::isInTree(std::shared_ptr<SceneNode> tree, std::shared_ptr<Sc
     return false;
 }
 
-void shadow::Scene::renderWithShader(std::shared_ptr<SceneNode> node, std::shared_ptr<GLShader> shader) const
+void shadow::Scene::renderWithShader(std::shared_ptr<SceneNode> node, std::shared_ptr<GLShader> shader, const glm::mat4* cullViewProjection) const
 {
     assert(shader);
     if (!node->isActive())
@@ -177,6 +216,29 @@ void shadow::Scene::renderWithShader(std::shared_ptr<SceneNode> node, std::share
     }
     std::shared_ptr<Mesh> mesh = node->getMesh();
     if (mesh)
+    {
+        glm::mat4 model = node->getWorld();
+        if (!cullViewProjection || mesh->getBounds().intersectsFrustum(*cullViewProjection * model))
+        {
+            uboMvp->setModel(model);
+            mesh->draw(shader);
+        }
+    }
+    for (const std::shared_ptr<SceneNode>& child : node->getChildren())
+    {
+        renderWithShader(child, shader, cullViewProjection);
+    }
+}
+
+void shadow::Scene::renderCasters(std::shared_ptr<SceneNode> node, std::shared_ptr<GLShader> shader, bool dynamic, bool dynamicParent) const
+{
+    if (!node->isActive())
+    {
+        return;
+    }
+    const bool isDynamic = dynamicParent || node->isDynamic();
+    std::shared_ptr<Mesh> mesh = node->getMesh();
+    if (mesh && isDynamic == dynamic)
     {
         glm::mat4 model = node->getWorld();
         uboMvp->setModel(model);
@@ -184,7 +246,59 @@ void shadow::Scene::renderWithShader(std::shared_ptr<SceneNode> node, std::share
     }
     for (const std::shared_ptr<SceneNode>& child : node->getChildren())
     {
-        renderWithShader(child, shader);
+        renderCasters(child, shader, dynamic, isDynamic);
+    }
+}
+
+void shadow::Scene::extendWorldBounds(std::shared_ptr<SceneNode> node, BoundingBox& bounds)
+{
+    if (!node->isActive())
+    {
+        return;
+    }
+    std::shared_ptr<Mesh> mesh = node->getMesh();
+    if (mesh)
+    {
+        bounds.extend(mesh->getBounds().transformed(node->getWorld()));
+    }
+    for (const std::shared_ptr<SceneNode>& child : node->getChildren())
+    {
+        extendWorldBounds(child, bounds);
+    }
+}
+
+void shadow::Scene::gatherNodeWorldBounds(std::shared_ptr<SceneNode> node, std::map<const SceneNode*, BoundingBox>& bounds)
+{
+    if (!node->isActive())
+    {
+        return;
+    }
+    std::shared_ptr<Mesh> mesh = node->getMesh();
+    if (mesh)
+    {
+        bounds.emplace(node.get(), mesh->getBounds().transformed(node->getWorld()));
+    }
+    for (const std::shared_ptr<SceneNode>& child : node->getChildren())
+    {
+        gatherNodeWorldBounds(child, bounds);
+    }
+}
+
+void shadow::Scene::gatherCasterWorldBounds(std::shared_ptr<SceneNode> node, std::map<const SceneNode*, BoundingBox>& bounds, bool dynamic, bool dynamicParent)
+{
+    if (!node->isActive())
+    {
+        return;
+    }
+    const bool isDynamic = dynamicParent || node->isDynamic();
+    std::shared_ptr<Mesh> mesh = node->getMesh();
+    if (mesh && isDynamic == dynamic)
+    {
+        bounds.emplace(node.get(), mesh->getBounds().transformed(node->getWorld()));
+    }
+    for (const std::shared_ptr<SceneNode>& child : node->getChildren())
+    {
+        gatherCasterWorldBounds(child, bounds, dynamic, isDynamic);
     }
 }
 
@@ -29,11 +29,21 @@ namespace shadow
         void setParent(std::shared_ptr<SceneNode> parent, std::shared_ptr<SceneNode> child) const;
         void render();
         void render(std::shared_ptr<GLShader> overrideShader);
+        void render(std::shared_ptr<GLShader> overrideShader, const glm::mat4& cullViewProjection); // skips meshes outside of the given clip volume
+        void renderCasters(std::shared_ptr<GLShader> overrideShader, bool dynamic); // draws either the static or the dynamic meshes only
+        void renderSubstituted(const std::map<ShaderType, ShaderType>& substitutes); // draws the meshes of a shader type with its substitute, if it has one
         std::shared_ptr<Camera> getCamera() const;
+        BoundingBox getWorldBounds() const;
+        std::map<const SceneNode*, BoundingBox> getNodeWorldBounds() const;
+        std::map<const SceneNode*, BoundingBox> getCasterWorldBounds(bool dynamic) const; // either of the static or the dynamic meshes only
     private:
         friend class SceneNode;
         static bool isInTree(std::shared_ptr<SceneNode> tree, std::shared_ptr<SceneNode> node);
-        void renderWithShader(std::shared_ptr<SceneNode> node, std::shared_ptr<GLShader> shader) const;
+        void renderWithShader(std::shared_ptr<SceneNode> node, std::shared_ptr<GLShader> shader, const glm::mat4* cullViewProjection) const;
+        void renderCasters(std::shared_ptr<SceneNode> node, std::shared_ptr<GLShader> shader, bool dynamic, bool dynamicParent) const;
+        static void extendWorldBounds(std::shared_ptr<SceneNode> node, BoundingBox& bounds);
+        static void gatherNodeWorldBounds(std::shared_ptr<SceneNode> node, std::map<const SceneNode*, BoundingBox>& bounds);
+        static void gatherCasterWorldBounds(std::shared_ptr<SceneNode> node, std::map<const SceneNode*, BoundingBox>& bounds, bool dynamic, bool dynamicParent);
         void updateNodeShaderType(ShaderType previous, std::shared_ptr<SceneNode> node);
         std::shared_ptr<SceneNode> root{};
         std::map<ShaderType, std::vector<std::shared_ptr<SceneNode>>> shaderMap{};
@@ -0,0 +1,43 @@
+#include "SceneChangeTracker.h"
+
+std::vector<shadow::BoundingBox> shadow::SceneChangeTracker::update(const Scene& scene)
+{
+    return update(scene.getNodeWorldBounds());
+}
+
+std::vector<shadow::BoundingBox> shadow::SceneChangeTracker::updateCasters(const Scene& scene, bool dynamic)
+{
+    return update(scene.getCasterWorldBounds(dynamic));
+}
+
+void shadow::SceneChangeTracker::reset()
+{
+    nodeBounds.clear();
+}
+
+std::vector<shadow::BoundingBox> shadow::SceneChangeTracker::update(std::map<const SceneNode*, BoundingBox>&& currentBounds)
+{
+    std::vector<BoundingBox> changes{};
+    for (const std::map<const SceneNode*, BoundingBox>::value_type& pair : currentBounds)
+    {
+        const std::map<const SceneNode*, BoundingBox>::const_iterator it = nodeBounds.find(pair.first);
+        if (it == nodeBounds.end())
+        {
+            changes.push_back(pair.second);
+        }
+        else if (it->second.min != pair.second.min || it->second.max != pair.second.max)
+        {
+            changes.push_back(it->second);
+            changes.push_back(pair.second);
+        }
+    }
+    for (const std::map<const SceneNode*, BoundingBox>::value_type& pair : nodeBounds)
+    {
+        if (currentBounds.find(pair.first) == currentBounds.end())
+        {
+            changes.push_back(pair.second);
+        }
+    }
+    nodeBounds = std::move(currentBounds);
+    return changes;
+}
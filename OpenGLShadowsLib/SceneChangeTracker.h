@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Scene.h"
+
+#include <map>
+#include <vector>
+
+namespace shadow
+{
+    // compares the world bounds of scene meshes between updates to find out which regions have to be redrawn
+    class SceneChangeTracker final
+    {
+    public:
+        SceneChangeTracker() = default;
+        ~SceneChangeTracker() = default;
+        SceneChangeTracker(SceneChangeTracker&) = delete;
+        SceneChangeTracker(SceneChangeTracker&&) = delete;
+        SceneChangeTracker& operator=(SceneChangeTracker&) = delete;
+        SceneChangeTracker& operator=(SceneChangeTracker&&) = delete;
+        std::vector<BoundingBox> update(const Scene& scene); // returns both the previous and the current bounds of changed meshes
+        std::vector<BoundingBox> updateCasters(const Scene& scene, bool dynamic); // the same, for either the static or the dynamic meshes only
+        void reset();
+    private:
+        std::vector<BoundingBox> update(std::map<const SceneNode*, BoundingBox>&& currentBounds);
+        std::map<const SceneNode*, BoundingBox> nodeBounds{};
+    };
+}
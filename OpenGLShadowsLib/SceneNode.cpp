@@ -25,6 +25,11 @@ bool shadow::SceneNode::isActiveSelf() const
     return activeSelf;
 }
 
+bool shadow::SceneNode::isDynamic() const
+{
+    return dynamic;
+}
+
 glm::mat4 shadow::SceneNode::getModel() const
 {
     return model;
@@ -58,6 +63,12 @@ shadow::SceneNode& shadow::SceneNode::setActiveSelf(bool activeSelf)
     return *this;
 }
 
+shadow::SceneNode& shadow::SceneNode::setDynamic(bool dynamic)
+{
+    this->dynamic = dynamic;
+    return *this;
+}
+
 shadow::SceneNode& shadow::SceneNode::setModel(glm::mat4 model)
 {
     this->model = model;
@@ -18,10 +18,12 @@ namespace shadow
         SceneNode& operator=(SceneNode&&) = delete;
         bool isActive();
         bool isActiveSelf() const;
+        bool isDynamic() const;
         glm::mat4 getModel() const;
         glm::mat4 getWorld();
         std::shared_ptr<Mesh> getMesh() const;
         SceneNode& setActiveSelf(bool activeSelf);
+        SceneNode& setDynamic(bool dynamic); // dynamic nodes and their children are redrawn into the shadow maps every frame
         SceneNode& setModel(glm::mat4 model);
         SceneNode& setMesh(std::shared_ptr<Mesh> mesh);
         SceneNode& setPosition(glm::vec3 vec);
@@ -39,7 +41,7 @@ namespace shadow
         std::weak_ptr<SceneNode> parent{};
         std::shared_ptr<Mesh> mesh{};
         std::vector<std::shared_ptr<SceneNode>> children{};
-        bool activeSelf{ true }, active{};
+        bool activeSelf{ true }, active{}, dynamic{};
         bool dirty{ true }, activeDirty{ true };
         glm::mat4 model{ glm::mat4(1.0f) }, world{};
     };
@@ -0,0 +1,48 @@
+#include "SeparableBlur.h"
+
+#include <algorithm>
+
+bool shadow::SeparableBlur::initialize(std::shared_ptr<GLShader> shader)
+{
+    if (!shader)
+    {
+        SHADOW_ERROR("Separable blur requires a compute shader!");
+        return false;
+    }
+    this->shader = shader;
+    return true;
+}
+
+void shadow::SeparableBlur::blur(const ShadowMapArray& maps, unsigned int radius, unsigned int passes) const
+{
+    assert(shader);
+    if (radius == 0U || passes == 0U)
+    {
+        return;
+    }
+    shader->use();
+    shader->setInt("radius", static_cast<int>(std::min(radius, MAX_RADIUS)));
+    for (unsigned int i = 0U; i < passes; ++i)
+    {
+        dispatch(maps.getTexture(), maps.getTempTexture(), maps, glm::vec2(1.0f, 0.0f));
+        dispatch(maps.getTempTexture(), maps.getTexture(), maps, glm::vec2(0.0f, 1.0f));
+    }
+    // besides being sampled, the result gets its mipmaps generated and the layers are attached again for the next frame
+    glMemoryBarrier(GL_FRAMEBUFFER_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT);
+    glBindImageTexture(0, 0, 0, GL_TRUE, 0, GL_WRITE_ONLY, maps.getInternalFormat());
+    glActiveTexture(GL_TEXTURE12);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void shadow::SeparableBlur::dispatch(GLuint source, GLuint target, const ShadowMapArray& maps, glm::vec2 direction) const
+{
+    glActiveTexture(GL_TEXTURE12);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, source);
+    glBindImageTexture(0, target, 0, GL_TRUE, 0, GL_WRITE_ONLY, maps.getInternalFormat());
+    shader->setVec2("direction", direction);
+    const GLuint size = static_cast<GLuint>(maps.getSize());
+    // x walks along the blurred axis in tiles, y across it in lines, z over the layers
+    glDispatchCompute((size + TILE_SIZE - 1U) / TILE_SIZE, size, static_cast<GLuint>(ShadowMapArray::LAYERS));
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "GLShader.h"
+#include "ShadowMapArray.h"
+
+#include <memory>
+
+namespace shadow
+{
+    // compute Gaussian blur of all layers of a shadow map array, every work group caches a line segment and its apron in shared memory
+    class SeparableBlur final
+    {
+    public:
+        static constexpr unsigned int MAX_RADIUS{ 32U };
+        SeparableBlur() = default;
+        ~SeparableBlur() = default;
+        SeparableBlur(SeparableBlur&) = delete;
+        SeparableBlur(SeparableBlur&&) = delete;
+        SeparableBlur& operator=(SeparableBlur&) = delete;
+        SeparableBlur& operator=(SeparableBlur&&) = delete;
+        bool initialize(std::shared_ptr<GLShader> shader);
+        void blur(const ShadowMapArray& maps, unsigned int radius, unsigned int passes) const;
+    private:
+        static constexpr GLuint TILE_SIZE{ 128U };
+        void dispatch(GLuint source, GLuint target, const ShadowMapArray& maps, glm::vec2 direction) const;
+        std::shared_ptr<GLShader> shader{};
+    };
+}
@@ -0,0 +1,182 @@
+#include "ShaderFileWatcher.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+shadow::ShaderFileWatcher::~ShaderFileWatcher()
+{
+    stop();
+}
+
+bool shadow::ShaderFileWatcher::start(const std::filesystem::path& directory)
+{
+    assert(!thread.joinable());
+#ifdef _WIN32
+    HANDLE handle = CreateFileW(directory.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        SHADOW_ERROR("Failed to open shader directory '{}' for watching ({})!", directory.generic_string(), GetLastError());
+        return false;
+    }
+    directoryHandle = handle;
+#else
+    inotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyDescriptor < 0)
+    {
+        SHADOW_ERROR("Failed to initialize inotify ({})!", errno);
+        return false;
+    }
+    // editors either write the file in place or rename a temporary one over it
+    if (inotify_add_watch(inotifyDescriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+    {
+        SHADOW_ERROR("Failed to watch shader directory '{}' ({})!", directory.generic_string(), errno);
+        close(inotifyDescriptor);
+        inotifyDescriptor = -1;
+        return false;
+    }
+#endif
+    this->directory = directory;
+    queueHead = queueTail = 0U;
+    overflowed = false;
+    running = true;
+    thread = std::thread(&ShaderFileWatcher::run, this);
+    SHADOW_DEBUG("Watching shader directory '{}' for changes.", directory.generic_string());
+    return true;
+}
+
+void shadow::ShaderFileWatcher::stop()
+{
+    // the thread may have already given up on its own
+    running = false;
+    if (thread.joinable())
+    {
+        thread.join();
+    }
+#ifdef _WIN32
+    if (directoryHandle)
+    {
+        CloseHandle(directoryHandle);
+        directoryHandle = nullptr;
+    }
+#else
+    if (inotifyDescriptor >= 0)
+    {
+        close(inotifyDescriptor);
+        inotifyDescriptor = -1;
+    }
+#endif
+}
+
+bool shadow::ShaderFileWatcher::isRunning() const
+{
+    return running;
+}
+
+bool shadow::ShaderFileWatcher::poll(std::set<std::filesystem::path>& changedFiles)
+{
+    const size_t tail = queueTail.load(std::memory_order_acquire);
+    size_t head = queueHead.load(std::memory_order_relaxed);
+    for (; head != tail; ++head)
+    {
+        changedFiles.insert(directory / queue[head % QUEUE_CAPACITY]);
+    }
+    queueHead.store(head, std::memory_order_release);
+    return !overflowed.exchange(false, std::memory_order_acq_rel);
+}
+
+void shadow::ShaderFileWatcher::push(std::string fileName)
+{
+    const size_t tail = queueTail.load(std::memory_order_relaxed);
+    if (tail - queueHead.load(std::memory_order_acquire) == QUEUE_CAPACITY)
+    {
+        // the render thread rescans the whole directory instead
+        overflowed.store(true, std::memory_order_release);
+        return;
+    }
+    queue[tail % QUEUE_CAPACITY] = std::move(fileName);
+    queueTail.store(tail + 1U, std::memory_order_release);
+}
+
+void shadow::ShaderFileWatcher::run()
+{
+#ifdef _WIN32
+    alignas(FILE_NOTIFY_INFORMATION) char buffer[16384];
+    OVERLAPPED overlapped{};
+    overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    while (running)
+    {
+        ResetEvent(overlapped.hEvent);
+        if (!ReadDirectoryChangesW(directoryHandle, buffer, sizeof(buffer), FALSE, FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME, nullptr, &overlapped, nullptr))
+        {
+            SHADOW_ERROR("Failed to read shader directory changes ({})!", GetLastError());
+            overflowed = true;
+            running = false;
+            break;
+        }
+        // the wait times out regularly so that stop() does not have to wake the thread up
+        while (running && WaitForSingleObject(overlapped.hEvent, STOP_CHECK_INTERVAL_MS) == WAIT_TIMEOUT) {}
+        DWORD bytes{};
+        if (!running)
+        {
+            CancelIoEx(directoryHandle, &overlapped);
+            GetOverlappedResult(directoryHandle, &overlapped, &bytes, TRUE);
+            break;
+        }
+        if (!GetOverlappedResult(directoryHandle, &overlapped, &bytes, FALSE) || bytes == 0U)
+        {
+            // the system buffer overflowed, the changes are unknown
+            overflowed = true;
+            continue;
+        }
+        for (const char* entry = buffer;;)
+        {
+            const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(entry);
+            if (info->Action != FILE_ACTION_REMOVED && info->Action != FILE_ACTION_RENAMED_OLD_NAME)
+            {
+                push(std::filesystem::path(std::wstring(info->FileName, info->FileNameLength / sizeof(WCHAR))).filename().string());
+            }
+            if (info->NextEntryOffset == 0U)
+            {
+                break;
+            }
+            entry += info->NextEntryOffset;
+        }
+    }
+    CloseHandle(overlapped.hEvent);
+#else
+    alignas(inotify_event) char buffer[16384];
+    pollfd descriptor{ inotifyDescriptor, POLLIN, 0 };
+    while (running)
+    {
+        // the poll times out regularly so that stop() does not have to wake the thread up
+        if (::poll(&descriptor, 1, STOP_CHECK_INTERVAL_MS) <= 0)
+        {
+            continue;
+        }
+        ssize_t length;
+        while ((length = read(inotifyDescriptor, buffer, sizeof(buffer))) > 0)
+        {
+            for (const char* entry = buffer; entry < buffer + length;)
+            {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(entry);
+                if (event->mask & IN_Q_OVERFLOW)
+                {
+                    overflowed = true;
+                }
+                else if (event->len > 0U)
+                {
+                    push(event->name);
+                }
+                entry += sizeof(inotify_event) + event->len;
+            }
+        }
+    }
+#endif
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "ShadowLog.h"
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <filesystem>
+#include <set>
+#include <string>
+#include <thread>
+
+namespace shadow
+{
+    // watches the shader directory on a background thread (ReadDirectoryChangesW on Windows, inotify on Linux) and hands
+    // the names of changed files to the render thread through a lock-free single producer, single consumer queue
+    class ShaderFileWatcher final
+    {
+    public:
+        ShaderFileWatcher() = default;
+        ~ShaderFileWatcher();
+        ShaderFileWatcher(ShaderFileWatcher&) = delete;
+        ShaderFileWatcher(ShaderFileWatcher&&) = delete;
+        ShaderFileWatcher& operator=(ShaderFileWatcher&) = delete;
+        ShaderFileWatcher& operator=(ShaderFileWatcher&&) = delete;
+        bool start(const std::filesystem::path& directory);
+        void stop();
+        bool isRunning() const;
+        // moves the queued file paths into changedFiles, false when events were dropped and the directory has to be rescanned
+        bool poll(std::set<std::filesystem::path>& changedFiles);
+    private:
+        static constexpr size_t QUEUE_CAPACITY{ 256U };
+        static constexpr int STOP_CHECK_INTERVAL_MS{ 100 };
+        void run();
+        void push(std::string fileName);
+        std::filesystem::path directory{};
+        std::array<std::string, QUEUE_CAPACITY> queue{};
+        std::atomic<size_t> queueHead{}, queueTail{}; // read by the consumer, written by the producer
+        std::atomic<bool> running{}, overflowed{};
+        std::thread thread{};
+#ifdef _WIN32
+        void* directoryHandle{};
+#else
+        int inotifyDescriptor{ -1 };
+#endif
+    };
+}
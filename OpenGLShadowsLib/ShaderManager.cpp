@@ -1,57 +1,38 @@
 #include "ShaderManager.h"
 #include "GLShader.h"
 #include "ShadowUtils.h"
+#include "LightClusters.h"
 
 #include <fstream>
 #include <sstream>
 
-shadow::ShaderManager::ShaderManager(const std::filesystem::path& shadersDirectory) : shadersDirectory(shadersDirectory) {}
+shadow::ShaderManager::ShaderManager(const std::filesystem::path& shadersDirectory, const std::filesystem::path& shaderCacheDirectory)
+    : shadersDirectory(shadersDirectory), shaderCacheDirectory(shaderCacheDirectory) {}
 
 bool shadow::ShaderManager::reworkShaderFiles()
 {
     bool changed = false;
-    // check for files that were modified
-    for (const std::filesystem::directory_entry& file : std::filesystem::directory_iterator(shadersDirectory))
+    std::set<std::filesystem::path> changedFiles{};
+    if (fileWatcher.isRunning() && fileWatcher.poll(changedFiles))
     {
-        if (is_regular_file(file))
+        // only the files the watcher reported are looked at, usually none
+        for (const std::filesystem::path& path : changedFiles)
         {
-            const std::filesystem::path& path = file.path();
-            std::map<std::filesystem::path, ShaderFileInfo>::iterator it = shaderFileInfos.find(path);
-            if (it != shaderFileInfos.end())
+            std::error_code error{};
+            if (is_regular_file(path, error) && updateShaderFile(path))
             {
-                try
-                {
-                    std::filesystem::file_time_type timestamp = last_write_time(path);
-                    if (it->second.timestamp != timestamp)
-                    {
-                        changed = true;
-                        it->second.timestamp = timestamp;
-                        it->second.content.clear();
-                        it->second.references.clear();
-                        it->second.modified = true;
-                    }
-                }
-                catch (std::exception&) {}
+                changed = true;
             }
-            else
+        }
+    }
+    else
+    {
+        // without the watcher, or after it lost events, every file is compared against its known timestamp
+        for (const std::filesystem::directory_entry& file : std::filesystem::directory_iterator(shadersDirectory))
+        {
+            if (is_regular_file(file) && updateShaderFile(file.path()))
             {
-                std::string extension = path.filename().generic_string();
-                size_t dotIndex = extension.find_last_of('.');
-                if (dotIndex != std::string::npos)
-                {
-                    extension = extension.substr(dotIndex);
-                    std::transform(extension.begin(), extension.end(), extension.begin(), [](auto c) { return std::tolower(c); });
-                    for (const std::string& refExt : SHADER_EXTENSIONS)
-                    {
-                        if (refExt == extension)
-                        {
-                            changed = true;
-                            SHADOW_DEBUG("Adding shader file '{}' to pool...", path.generic_string());
-                            shaderFileInfos.emplace(path, ShaderFileInfo{ {}, {}, last_write_time(path), {}, true });
-                            break;
-                        }
-                    }
-                }
+                changed = true;
             }
         }
     }
@@ -77,7 +58,7 @@ bool shadow::ShaderManager::reworkShaderFiles()
         {
             pair.second.references.clear();
             pair.second.includes.clear();
-            std::ifstream stream(pair.first);
+            std::istringstream stream(pair.second.source);
             std::string line;
             unsigned int lineCounter{};
             while (std::getline(stream, line))
@@ -89,10 +70,6 @@ bool shadow::ShaderManager::reworkShaderFiles()
                 {
                     includedFile = line.substr(INCLUDE_LENGTH);
                 }
-                else if (line.rfind(INCLUDED_FROM_TEXT, 0) == 0)
-                {
-                    includedFile = line.substr(INCLUDED_FROM_LENGTH);
-                }
                 if (!includedFile.empty())
                 {
                     bool fileFound = false;
@@ -145,10 +122,10 @@ bool shadow::ShaderManager::reworkShaderFiles()
         if (!pair.second.modified && isShaderFileModified(pair.first))
         {
             pair.second.modified = true;
-            pair.second.content.clear();
+            pair.second.expanded = false;
         }
     }
-    // rebuild files if needed
+    // expand the includes of modified files, nothing is written back to the disk
     for (std::map<std::filesystem::path, ShaderFileInfo>::value_type& pair : shaderFileInfos)
     {
         if (pair.second.modified && !rebuildShaderFile(pair.first))
@@ -176,27 +153,65 @@ void shadow::ShaderManager::updateShaders() const
     }
 }
 
-#if SHADOW_MASTER || SHADOW_CHSS
+unsigned int shadow::ShaderManager::prewarmShaders() const
+{
+    unsigned int prewarmed{};
+    for (const std::map<ShaderType, std::shared_ptr<GLShader>>::value_type& pair : shaders)
+    {
+        if (pair.second->prewarm())
+        {
+            ++prewarmed;
+        }
+    }
+    return prewarmed;
+}
+
 void shadow::ShaderManager::updateVogelDisk(unsigned int shadowSamples, unsigned int penumbraSamples)
 {
     assert(shadowSamples);
     assert(penumbraSamples);
-    updateInclude(VOGEL_INCLUDE_TEXT, getVogelIncludeContent(shadowSamples, penumbraSamples));
+    uboSampling->setVogelDisks(std::min(shadowSamples, MAX_VOGEL_SAMPLES), std::min(penumbraSamples, MAX_VOGEL_SAMPLES));
 }
-#elif SHADOW_PCSS
+
 void shadow::ShaderManager::updatePoisson(unsigned int shadowSamples, unsigned int penumbraSamples)
 {
     assert(shadowSamples);
     assert(penumbraSamples);
-    updateInclude(POISSON_INCLUDE_TEXT, getPoissonIncludeContent(shadowSamples, penumbraSamples));
+    // the Poisson disk is fixed, larger counts are clamped to it
+    uboSampling->setPoissonSamples(std::min(shadowSamples, MAX_POISSON_SAMPLES), std::min(penumbraSamples, MAX_POISSON_SAMPLES));
 }
-#elif SHADOW_PCF
+
 void shadow::ShaderManager::updateFilterSize(unsigned int filterSize)
 {
     assert(filterSize % 2 == 1);
-    updateInclude(FILTER_SIZE_INCLUDE_TEXT, getFilterSizeIncludeContent(filterSize));
+    uboSampling->setFilterSize(std::min(filterSize, MAX_FILTER_SIZE));
+}
+
+void shadow::ShaderManager::updateAdaptiveSampling(unsigned int earlyOutSamples, float samplesPerTexel)
+{
+    assert(samplesPerTexel >= 0.0f);
+    uboSampling->setAdaptiveSampling(std::min(earlyOutSamples, MAX_VOGEL_SAMPLES), samplesPerTexel);
+}
+
+void shadow::ShaderManager::updateShaderIncludes(const ShaderIncludes& includes)
+{
+    for (const ShaderIncludes::value_type& pair : includes)
+    {
+        // only the includes whose content differs get their shaders rebuilt
+        const std::map<std::string, ShaderTextInclude>::const_iterator it = shaderIncludes.find(pair.first);
+        if (it == shaderIncludes.end() || it->second.content != pair.second)
+        {
+            updateInclude(pair.first, pair.second);
+        }
+    }
+}
+
+void shadow::ShaderManager::updateVirtualShadowMap(bool enabled, unsigned int virtualPages, unsigned int poolPages)
+{
+    assert(virtualPages);
+    assert(poolPages);
+    updateInclude(VIRTUAL_SHADOW_MAP_INCLUDE_TEXT, getVirtualShadowMapIncludeContent(enabled, virtualPages, poolPages));
 }
-#endif
 
 std::string shadow::ShaderManager::getShaderFileContent(const std::filesystem::path& path)
 {
@@ -208,6 +223,12 @@ std::string shadow::ShaderManager::getShaderFileContent(const std::filesystem::p
     return it->second.content;
 }
 
+unsigned int shadow::ShaderManager::getShaderFileRevision(const std::filesystem::path& path) const
+{
+    const std::map<std::filesystem::path, ShaderFileInfo>::const_iterator it = shaderFileInfos.find(path);
+    return it == shaderFileInfos.end() ? 0U : it->second.revision;
+}
+
 std::shared_ptr<shadow::GLShader> shadow::ShaderManager::getShader(ShaderType shaderType)
 {
     if (shaderType == ShaderType::None)
@@ -224,6 +245,11 @@ std::shared_ptr<shadow::GLShader> shadow::ShaderManager::getShader(ShaderType sh
     return it->second;
 }
 
+shadow::ProgramBinaryCache& shadow::ShaderManager::getProgramBinaryCache()
+{
+    return programBinaryCache;
+}
+
 std::shared_ptr<shadow::UboMvp> shadow::ShaderManager::getUboMvp() const
 {
     return uboMvp;
@@ -244,6 +270,16 @@ std::shared_ptr<shadow::UboWindow> shadow::ShaderManager::getUboWindow() const
     return uboWindow;
 }
 
+std::shared_ptr<shadow::UboSampling> shadow::ShaderManager::getUboSampling() const
+{
+    return uboSampling;
+}
+
+std::shared_ptr<shadow::SsboPointLights> shadow::ShaderManager::getSsboPointLights() const
+{
+    return ssboPointLights;
+}
+
 bool shadow::ShaderManager::rebuildShaderFile(const std::filesystem::path& path)
 {
     const std::map<std::filesystem::path, ShaderFileInfo>::iterator it = shaderFileInfos.find(path);
@@ -252,158 +288,164 @@ bool shadow::ShaderManager::rebuildShaderFile(const std::filesystem::path& path)
         SHADOW_ERROR("File '{}' was not found in shaderFileInfos! This should NOT happen.", path.generic_string());
         return false;
     }
-    if (!it->second.modified || !it->second.content.empty()) // if content is not empty, this means that the file was just rebuilt but is still marked as modified for the other files to know
+    if (!it->second.modified || it->second.expanded) // an expanded file may still be marked as modified for the other files to know
     {
         return true;
     }
-    SHADOW_DEBUG("Rebuilding shader file '{}'...", path.generic_string());
-    std::ifstream stream(it->first);
+    for (const std::filesystem::path& refPath : it->second.references)
+    {
+        if (!rebuildShaderFile(refPath))
+        {
+            return false;
+        }
+    }
+    std::string content{};
     if (it->second.references.empty() && it->second.includes.empty())
     {
-        it->second.content = std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+        content = it->second.source;
     }
     else
     {
-        for (const std::filesystem::path& refPath : it->second.references)
+        // switching back to an already seen permutation, e.g. during a parameter sweep, skips the expansion
+        const std::string permutationKey = getPermutationKey(path);
+        const std::map<std::string, std::string>::const_iterator permutation = it->second.permutations.find(permutationKey);
+        if (permutation != it->second.permutations.end())
         {
-            if (!rebuildShaderFile(refPath))
-            {
-                return false;
-            }
+            SHADOW_TRACE("Reusing an expanded permutation of shader file '{}'.", path.generic_string());
+            content = permutation->second;
         }
-        std::vector<std::string> lines{};
-        std::string line;
-        while (std::getline(stream, line))
-        {
-            lines.push_back(line);
-        }
-        std::stringstream ss{};
-        std::stringstream nonContentSs{};
-        bool refillFile = false;
-        for (size_t i = 0; i < lines.size();)
+        else
         {
-            std::string trimmed = lines[i];
-            ShadowUtils::trim(trimmed);
-            if (trimmed.rfind(INCLUDE_TEXT, 0) == 0)
-            {
-                std::string includedFile = trimmed.substr(INCLUDE_LENGTH);
-                bool includedFileFound = false;
-                for (const std::map<std::filesystem::path, ShaderFileInfo>::value_type& pair : shaderFileInfos)
-                {
-                    if (pair.first.filename() == includedFile)
-                    {
-                        includedFileFound = true;
-                        ss << INCLUDED_FROM_TEXT << includedFile << std::endl << pair.second.content << std::endl << END_INCLUDE_TEXT << includedFile << std::endl;
-                        break;
-                    }
-                }
-                if (!includedFileFound)
-                {
-                    bool isTextInclude = false;
-                    for (const std::map<std::string, ShaderTextInclude>::value_type& pair : shaderIncludes)
-                    {
-                        if (pair.first == includedFile)
-                        {
-                            isTextInclude = true;
-                            ss << INCLUDED_FROM_TEXT << includedFile << std::endl << pair.second.content << std::endl << END_INCLUDE_TEXT << includedFile << std::endl;
-                            break;
-                        }
-                    }
-                    if (!isTextInclude)
-                    {
-                        ss << "#error Include file '" << includedFile << "' was NOT found!" << std::endl;
-                    }
-                }
-                nonContentSs << trimmed << std::endl;
-                ++i;
-            }
-            else if (trimmed.rfind(INCLUDED_FROM_TEXT, 0) == 0)
+            SHADOW_DEBUG("Expanding shader file '{}'...", path.generic_string());
+            std::istringstream stream(it->second.source);
+            std::stringstream ss{};
+            std::string line;
+            unsigned int lineCounter{};
+            while (std::getline(stream, line))
             {
-                std::string includedFile = trimmed.substr(INCLUDED_FROM_LENGTH);
-                size_t endIndex = std::string::npos;
-                for (size_t j = i + 1; j < lines.size(); ++j)
+                ++lineCounter;
+                std::string trimmed = line;
+                ShadowUtils::trim(trimmed);
+                if (trimmed.rfind(INCLUDE_TEXT, 0) != 0)
                 {
-                    std::string tr = lines[j];
-                    ShadowUtils::trim(tr);
-                    if (tr.rfind(END_INCLUDE_TEXT, 0) == 0)
-                    {
-                        if (tr.substr(END_INCLUDE_LENGTH) == includedFile)
-                        {
-                            endIndex = j;
-                            break;
-                        }
-                    }
+                    ss << line << std::endl;
+                    continue;
                 }
-                if (endIndex == std::string::npos)
+                std::string includedFile = trimmed.substr(INCLUDE_LENGTH);
+                const std::string* includedContent = getIncludeContent(includedFile);
+                if (includedContent)
                 {
-                    SHADOW_ERROR("Unable to find inclusion end ('{}' included at line {} in '{}')!", includedFile, i + 1, path.generic_string());
+                    ss << INCLUDED_FROM_TEXT << includedFile << std::endl << *includedContent << std::endl << END_INCLUDE_TEXT << includedFile << std::endl;
                 }
                 else
                 {
-                    lines.erase(lines.begin() + i, lines.begin() + endIndex);
-                    bool fileFound = false;
-                    for (const std::map<std::filesystem::path, ShaderFileInfo>::value_type& pair : shaderFileInfos)
-                    {
-                        if (pair.first.filename() == includedFile)
-                        {
-                            fileFound = true;
-                            ss << INCLUDED_FROM_TEXT << includedFile << std::endl << pair.second.content << std::endl << END_INCLUDE_TEXT << includedFile << std::endl;
-                            break;
-                        }
-                    }
-                    if (!fileFound)
-                    {
-                        bool isTextInclude = false;
-                        for (const std::map<std::string, ShaderTextInclude>::value_type& pair : shaderIncludes)
-                        {
-                            if (pair.first == includedFile)
-                            {
-                                isTextInclude = true;
-                                ss << INCLUDED_FROM_TEXT << includedFile << std::endl << pair.second.content << std::endl << END_INCLUDE_TEXT << includedFile << std::endl;
-                                break;
-                            }
-                        }
-                        if (!isTextInclude)
-                        {
-                            SHADOW_ERROR("Include file '{}' referenced in '{}':{} was NOT found!", includedFile, path.generic_string(), i + 1);
-                            ss << INCLUDE_TEXT << includedFile << std::endl;
-                        }
-                    }
+                    SHADOW_ERROR("Include file '{}' referenced in '{}':{} was NOT found!", includedFile, path.generic_string(), lineCounter);
+                    ss << "#error Include file '" << includedFile << "' was NOT found!" << std::endl;
                 }
-                nonContentSs << INCLUDE_TEXT << includedFile << std::endl;
-                ++i;
-            }
-            else if (trimmed.rfind(REFILL_TEXT, 0) == 0)
-            {
-                ss << lines[i] << std::endl;
-                nonContentSs << lines[i] << std::endl;
-                refillFile = true;
-                SHADOW_DEBUG("Shader file '{}' is marked to be refilled.", path.generic_string());
-                ++i;
             }
-            else
+            content = ss.str();
+            it->second.permutations.emplace(permutationKey, content);
+        }
+    }
+    // the programs only rebuild when their expanded sources really changed
+    if (content != it->second.content)
+    {
+        it->second.content = std::move(content);
+        ++it->second.revision;
+    }
+    it->second.expanded = true;
+    return true;
+}
+
+bool shadow::ShaderManager::updateShaderFile(const std::filesystem::path& path)
+{
+    std::map<std::filesystem::path, ShaderFileInfo>::iterator it = shaderFileInfos.find(path);
+    if (it != shaderFileInfos.end())
+    {
+        try
+        {
+            if (it->second.timestamp != last_write_time(path))
             {
-                ss << lines[i] << std::endl;
-                nonContentSs << lines[i] << std::endl;
-                ++i;
+                loadShaderSource(path, it->second);
+                return true;
             }
         }
-        it->second.content = ss.str();
-        stream.close();
-        SHADOW_DEBUG("Overwriting '{}' ({})...", path.generic_string(), refillFile);
-        std::ofstream output(path, std::ios::trunc);
-        if (refillFile)
+        catch (std::exception&) {}
+        return false;
+    }
+    std::string extension = path.filename().generic_string();
+    size_t dotIndex = extension.find_last_of('.');
+    if (dotIndex == std::string::npos)
+    {
+        return false;
+    }
+    extension = extension.substr(dotIndex);
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](auto c) { return std::tolower(c); });
+    for (const std::string& refExt : SHADER_EXTENSIONS)
+    {
+        if (refExt == extension)
         {
-            output << it->second.content;
+            SHADOW_DEBUG("Adding shader file '{}' to pool...", path.generic_string());
+            loadShaderSource(path, shaderFileInfos[path]);
+            return true;
         }
-        else
+    }
+    return false;
+}
+
+void shadow::ShaderManager::loadShaderSource(const std::filesystem::path& path, ShaderFileInfo& info)
+{
+    std::ifstream stream(path);
+    info.source = std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    info.timestamp = last_write_time(path);
+    ++info.sourceRevision;
+    info.permutations.clear();
+    info.references.clear();
+    info.includes.clear();
+    info.modified = true;
+    info.expanded = false;
+}
+
+const std::string* shadow::ShaderManager::getIncludeContent(const std::string& includedFile) const
+{
+    for (const std::map<std::filesystem::path, ShaderFileInfo>::value_type& pair : shaderFileInfos)
+    {
+        if (pair.first.filename() == includedFile)
         {
-            output << nonContentSs.str();
+            return &pair.second.content;
         }
-        output.flush();
-        it->second.timestamp = last_write_time(path);
     }
-    return true;
+    const std::map<std::string, ShaderTextInclude>::const_iterator it = shaderIncludes.find(includedFile);
+    return it == shaderIncludes.end() ? nullptr : &it->second.content;
+}
+
+// identifies everything the expanded content of a file depends on: the text includes it reaches and the sources of the files it references
+std::string shadow::ShaderManager::getPermutationKey(const std::filesystem::path& path) const
+{
+    std::set<std::string> includes{};
+    std::map<std::filesystem::path, unsigned int> sourceRevisions{};
+    std::vector<std::filesystem::path> pending{ path };
+    while (!pending.empty())
+    {
+        const std::map<std::filesystem::path, ShaderFileInfo>::const_iterator it = shaderFileInfos.find(pending.back());
+        pending.pop_back();
+        if (it == shaderFileInfos.end() || !sourceRevisions.emplace(it->first, it->second.sourceRevision).second)
+        {
+            continue;
+        }
+        includes.insert(it->second.includes.begin(), it->second.includes.end());
+        pending.insert(pending.end(), it->second.references.begin(), it->second.references.end());
+    }
+    std::stringstream ss{};
+    for (const std::string& include : includes)
+    {
+        ss << include << '=' << shaderIncludes.at(include).content << '\0';
+    }
+    for (const std::map<std::filesystem::path, unsigned int>::value_type& pair : sourceRevisions)
+    {
+        ss << pair.first.generic_string() << '@' << pair.second << '\0';
+    }
+    return ss.str();
 }
 
 bool shadow::ShaderManager::isShaderFileRecursivelyReferenced(const std::filesystem::path& path, const std::filesystem::path& searchPath)
@@ -457,10 +499,16 @@ bool shadow::ShaderManager::isShaderFileModified(const std::filesystem::path& pa
     return false;
 }
 
-void shadow::ShaderManager::loadShaders(GLsizei windowWidth, GLsizei windowHeight)
+void shadow::ShaderManager::loadShaders(GLsizei windowWidth, GLsizei windowHeight, const ShaderIncludes& shadowIncludes)
 {
+    programBinaryCache.initialize(shaderCacheDirectory);
     SHADOW_DEBUG("Preparing shader includes...");
-    prepareShaderIncludes(windowWidth, windowHeight);
+    prepareShaderIncludes(windowWidth, windowHeight, shadowIncludes);
+    // started before the first scan, so that no change slips in between the two
+    if (!fileWatcher.start(shadersDirectory))
+    {
+        SHADOW_WARN("Shader files will be polled for changes instead of being watched.");
+    }
     SHADOW_DEBUG("Reworking shader files...");
     reworkShaderFiles();
     SHADOW_DEBUG("Loading shaders...");
@@ -468,17 +516,31 @@ void shadow::ShaderManager::loadShaders(GLsizei windowWidth, GLsizei windowHeigh
     shaders.emplace(ShaderType::Material, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "Material")));
     shaders.emplace(ShaderType::DepthDir, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "DepthDir.vert", "Depth.frag")));
     shaders.emplace(ShaderType::DepthSpot, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "DepthSpot.vert", "Depth.frag")));
-#if SHADOW_VSM
     shaders.emplace(ShaderType::DepthDirVSM, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "DepthDir.vert", "DepthVSM.frag")));
     shaders.emplace(ShaderType::DepthSpotVSM, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "DepthSpot.vert", "DepthVSM.frag")));
-    shaders.emplace(ShaderType::GaussianBlur, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "PostProcess.vert", "GaussianBlur.frag")));
-#endif
-#if SHADOW_MASTER || SHADOW_CHSS
+    shaders.emplace(ShaderType::DepthDirMSM, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "DepthDir.vert", "DepthMSM.frag")));
+    shaders.emplace(ShaderType::DepthSpotMSM, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "DepthSpot.vert", "DepthMSM.frag")));
+    shaders.emplace(ShaderType::DepthDirEVSM, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "DepthDir.vert", "DepthEVSM.frag")));
+    shaders.emplace(ShaderType::DepthSpotEVSM, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "DepthSpot.vert", "DepthEVSM.frag")));
+    shaders.emplace(ShaderType::GaussianBlur, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "GaussianBlur.comp", GL_COMPUTE_SHADER)));
     shaders.emplace(ShaderType::DirPenumbra, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "DirPenumbra.vert", "DirPenumbra.frag")));
     shaders.emplace(ShaderType::SpotPenumbra, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "SpotPenumbra.vert", "SpotPenumbra.frag")));
-#endif
+    shaders.emplace(ShaderType::DepthPyramid, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "DepthPyramid.comp", GL_COMPUTE_SHADER)));
     shaders.emplace(ShaderType::PostProcess, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "PostProcess")));
     shaders.emplace(ShaderType::ShadowOnly, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "ShadowOnly")));
+    shaders.emplace(ShaderType::DepthBounds, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "DepthBounds.comp", GL_COMPUTE_SHADER)));
+    shaders.emplace(ShaderType::LightClustering, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "LightClustering.comp", GL_COMPUTE_SHADER)));
+    shaders.emplace(ShaderType::DepthDirVirtual, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "DepthDirVirtual.vert", "Depth.frag")));
+    shaders.emplace(ShaderType::PageMarking, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "PageMarking.comp", GL_COMPUTE_SHADER)));
+    shaders.emplace(ShaderType::DepthCamera, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "DepthCamera.vert", "Depth.frag")));
+    shaders.emplace(ShaderType::ShadowTiles, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "ShadowTiles.comp", GL_COMPUTE_SHADER)));
+    shaders.emplace(ShaderType::ShadowMask, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "PostProcess.vert", "ShadowMask.frag")));
+    shaders.emplace(ShaderType::GBufferMaterial, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "Material.vert", "GBufferMaterial.frag")));
+    shaders.emplace(ShaderType::GBufferTexture, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "Texture.vert", "GBufferTexture.frag")));
+    shaders.emplace(ShaderType::DeferredLighting, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "PostProcess.vert", "DeferredLighting.frag")));
+    shaders.emplace(ShaderType::ContactShadows, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "PostProcess.vert", "ContactShadows.frag")));
+    shaders.emplace(ShaderType::ShadowTemporal, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "PostProcess.vert", "ShadowTemporal.frag")));
+    shaders.emplace(ShaderType::ShadowDenoise, std::shared_ptr<GLShader>(new GLShader(shadersDirectory, "ShadowDenoise.comp", GL_COMPUTE_SHADER)));
     for (unsigned int i = 0U; i != static_cast<unsigned int>(ShaderType::ShaderTypeEnd); ++i)
     {
         const std::map<ShaderType, std::shared_ptr<GLShader>>::iterator it = shaders.find(static_cast<ShaderType>(i));
@@ -490,6 +552,7 @@ void shadow::ShaderManager::loadShaders(GLsizei windowWidth, GLsizei windowHeigh
             }
         }
     }
+    SHADOW_INFO("Shaders loaded ({} programs from the binary cache, {} compiled).", programBinaryCache.getHitCount(), programBinaryCache.getMissCount());
 
     SHADOW_DEBUG("Creating UBOs...");
     uboMvp = std::make_shared<UboMvp>();
@@ -500,6 +563,12 @@ void shadow::ShaderManager::loadShaders(GLsizei windowWidth, GLsizei windowHeigh
         std::make_shared<DirectionalLight>(dirLightData),
         std::make_shared<SpotLight>(spotLightData));
     uboWindow = std::make_shared<UboWindow>();
+    uboSampling = std::make_shared<UboSampling>();
+    uboSampling->setVogelDisks(32U, 16U);
+    uboSampling->setPoissonSamples(32U, 16U);
+    uboSampling->setFilterSize(3U);
+    SHADOW_DEBUG("Creating SSBOs...");
+    ssboPointLights = std::make_shared<SsboPointLights>();
 }
 
 void shadow::ShaderManager::updateInclude(const std::string& inclName, const std::string& inclContent)
@@ -520,88 +589,34 @@ void shadow::ShaderManager::addShaderInclude(const std::string& name, const std:
     shaderIncludes.emplace(name, ShaderTextInclude{ content, true });
 }
 
-std::string shadow::ShaderManager::getShaderImplIncludeContent() const
+std::string shadow::ShaderManager::getVirtualShadowMapIncludeContent(bool enabled, unsigned int virtualPages, unsigned int poolPages) const
 {
     std::stringstream ss{};
-    ss << "#define SHADOW_IMPL " << SHADOW_IMPL << std::endl;
+    ss << "#define SHADOW_VIRTUAL " << (enabled ? 1 : 0) << std::endl;
+    ss << "#define VIRTUAL_PAGES " << virtualPages << std::endl;
+    ss << "#define VIRTUAL_POOL_PAGES " << poolPages << std::endl;
     return ss.str();
 }
 
-#if SHADOW_MASTER || SHADOW_CHSS
-std::string shadow::ShaderManager::getVogelIncludeContent(unsigned int shadowSamples, unsigned int penumbraSamples) const
+std::string shadow::ShaderManager::getClusterGridIncludeContent() const
 {
     std::stringstream ss{};
-    ss << "#define VOGEL_SS " << shadowSamples << std::endl;
-    ss << "#define VOGEL_PS " << penumbraSamples << std::endl << std::endl;
-#if SHADOW_MASTER
-    std::vector<glm::vec2> shadowVogelDisk = getVogelDisk(shadowSamples);
-    std::vector<glm::vec2> penumbraVogelDisk = getVogelDisk(penumbraSamples);
-    ss << "vec2 shadowVogelDisk[VOGEL_SS] = vec2[](" << std::endl;
-    for (unsigned int i = 0; i < shadowSamples; ++i)
-    {
-        ss << "    vec2(" << shadowVogelDisk[i].r << ", " << shadowVogelDisk[i].g << ")";
-        if (i + 1U != shadowSamples)
-        {
-            ss << ",";
-        }
-        ss << std::endl;
-    }
-    ss << "    );" << std::endl << std::endl;
-    ss << "vec2 penumbraVogelDisk[VOGEL_PS] = vec2[](" << std::endl;
-    for (unsigned int i = 0; i < penumbraSamples; ++i)
-    {
-        ss << "    vec2(" << penumbraVogelDisk[i].r << ", " << penumbraVogelDisk[i].g << ")";
-        if (i + 1U != penumbraSamples)
-        {
-            ss << ",";
-        }
-        ss << std::endl;
-    }
-    ss << "    );" << std::endl;
-#endif
+    ss << "#define CLUSTER_X " << LightClusters::CLUSTER_X << std::endl;
+    ss << "#define CLUSTER_Y " << LightClusters::CLUSTER_Y << std::endl;
+    ss << "#define CLUSTER_Z " << LightClusters::CLUSTER_Z << std::endl;
+    ss << "#define CLUSTER_COUNT " << LightClusters::CLUSTER_COUNT << std::endl;
+    ss << "#define MAX_CLUSTER_LIGHTS " << LightClusters::MAX_CLUSTER_LIGHTS << std::endl;
+    ss << "#define CLUSTER_SPOT_BIT 0x80000000u" << std::endl;
     return ss.str();
 }
 
-std::vector<glm::vec2> shadow::ShaderManager::getVogelDisk(unsigned int size) const
+void shadow::ShaderManager::prepareShaderIncludes(GLsizei windowWidth, GLsizei windowHeight, const ShaderIncludes& shadowIncludes)
 {
-    float sizeSqrt = std::sqrt(static_cast<float>(size));
-    std::vector<glm::vec2> result{};
-    for (unsigned int i = 0; i < size; ++i)
+    // the shadow technique provides the contents of its own includes
+    for (const ShaderIncludes::value_type& pair : shadowIncludes)
     {
-        result.emplace_back(
-            std::sqrt(static_cast<float>(i) + 0.5f) / sizeSqrt,
-            static_cast<float>(i) * 2.4f
-        );
+        addShaderInclude(pair.first, pair.second);
     }
-    return result;
-}
-#elif SHADOW_PCSS
-std::string shadow::ShaderManager::getPoissonIncludeContent(unsigned int shadowSamples, unsigned int penumbraSamples) const
-{
-    std::stringstream ss{};
-    // ss << "#define PCSS_MAX_BLOCKERS " << (std::max(shadowSamples, penumbraSamples) > 16 ? 32 : 16) << std::endl;
-    ss << "#define PCSS_MAX_BLOCKERS " << 32 << std::endl;
-    ss << "#define PCSS_BLOCKERS " << shadowSamples << std::endl;
-    ss << "#define PCSS_FILTER_SIZE " << penumbraSamples << std::endl;
-    return ss.str();
-}
-#elif SHADOW_PCF
-std::string shadow::ShaderManager::getFilterSizeIncludeContent(unsigned int filterSize) const
-{
-    std::stringstream ss{};
-    ss << "#define FILTER_SIZE " << filterSize << std::endl;
-    return ss.str();
-}
-#endif
-
-void shadow::ShaderManager::prepareShaderIncludes(GLsizei windowWidth, GLsizei windowHeight)
-{
-#if SHADOW_MASTER || SHADOW_CHSS
-    addShaderInclude(VOGEL_INCLUDE_TEXT, getVogelIncludeContent(32U, 16U));
-#elif SHADOW_PCSS
-    addShaderInclude(POISSON_INCLUDE_TEXT, getPoissonIncludeContent(32U, 16U));
-#elif SHADOW_PCF
-    addShaderInclude(FILTER_SIZE_INCLUDE_TEXT, getFilterSizeIncludeContent(3U));
-#endif
-    addShaderInclude(SHADOW_IMPL_INCLUDE_TEXT, getShaderImplIncludeContent());
+    addShaderInclude(VIRTUAL_SHADOW_MAP_INCLUDE_TEXT, getVirtualShadowMapIncludeContent(false, 1U, 1U));
+    addShaderInclude(CLUSTER_GRID_INCLUDE_TEXT, getClusterGridIncludeContent());
 }
@@ -7,7 +7,10 @@
 #include "UboMaterial.h"
 #include "UboLights.h"
 #include "UboWindow.h"
-#include "ShadowVariants.h"
+#include "UboSampling.h"
+#include "SsboPointLights.h"
+#include "ProgramBinaryCache.h"
+#include "ShaderFileWatcher.h"
 
 #include <map>
 #include <set>
@@ -19,10 +22,15 @@ namespace shadow
         std::set<std::filesystem::path> references{}; // external file includes
         std::set<std::string> includes{}; // plain-text includes provided by this class
         std::filesystem::file_time_type timestamp{};
-        std::string content{}; // file content (contains includes)
-        bool modified{};
+        std::string source{}; // file content as read from the disk, which is never written to
+        std::string content{}; // source with the includes expanded
+        std::map<std::string, std::string> permutations{}; // expanded contents by permutation key
+        unsigned int sourceRevision{}, revision{}; // bumped whenever the source or the content changes
+        bool modified{}, expanded{};
     };
 
+    using ShaderIncludes = std::map<std::string, std::string>; // plain-text include contents by name
+
     struct ShaderTextInclude final
     {
         std::string content{};
@@ -39,56 +47,55 @@ namespace shadow
         ShaderManager& operator=(ShaderManager&&) = delete;
         bool reworkShaderFiles();
         void updateShaders() const;
-#if SHADOW_MASTER || SHADOW_CHSS
+        unsigned int prewarmShaders() const;
         void updateVogelDisk(unsigned int shadowSamples, unsigned int penumbraSamples);
-#elif SHADOW_PCSS
         void updatePoisson(unsigned int shadowSamples, unsigned int penumbraSamples);
-#elif SHADOW_PCF
         void updateFilterSize(unsigned int filterSize);
-#endif
+        void updateAdaptiveSampling(unsigned int earlyOutSamples, float samplesPerTexel);
+        void updateShaderIncludes(const ShaderIncludes& includes);
+        void updateVirtualShadowMap(bool enabled, unsigned int virtualPages, unsigned int poolPages);
         std::string getShaderFileContent(const std::filesystem::path& path);
+        unsigned int getShaderFileRevision(const std::filesystem::path& path) const;
         std::shared_ptr<GLShader> getShader(ShaderType shaderType);
+        ProgramBinaryCache& getProgramBinaryCache();
         std::shared_ptr<UboMvp> getUboMvp() const;
         std::shared_ptr<UboMaterial> getUboMaterial() const;
         std::shared_ptr<UboLights> getUboLights() const;
         std::shared_ptr<UboWindow> getUboWindow() const;
+        std::shared_ptr<UboSampling> getUboSampling() const;
+        std::shared_ptr<SsboPointLights> getSsboPointLights() const;
     private:
         friend class ResourceManager;
-        ShaderManager(const std::filesystem::path& shadersDirectory);
+        ShaderManager(const std::filesystem::path& shadersDirectory, const std::filesystem::path& shaderCacheDirectory);
         bool rebuildShaderFile(const std::filesystem::path& path);
+        bool updateShaderFile(const std::filesystem::path& path);
+        void loadShaderSource(const std::filesystem::path& path, ShaderFileInfo& info);
+        const std::string* getIncludeContent(const std::string& includedFile) const;
+        std::string getPermutationKey(const std::filesystem::path& path) const;
         bool isShaderFileRecursivelyReferenced(const std::filesystem::path& path, const std::filesystem::path& searchPath);
         bool isShaderFileModified(const std::filesystem::path& path);
-        void loadShaders(GLsizei windowWidth, GLsizei windowHeight);
+        void loadShaders(GLsizei windowWidth, GLsizei windowHeight, const ShaderIncludes& shadowIncludes);
         void updateInclude(const std::string& inclName, const std::string& inclContent);
-        void prepareShaderIncludes(GLsizei windowWidth, GLsizei windowHeight);
+        void prepareShaderIncludes(GLsizei windowWidth, GLsizei windowHeight, const ShaderIncludes& shadowIncludes);
         void addShaderInclude(const std::string& name, const std::string& content);
-        std::string getShaderImplIncludeContent() const;
-#if SHADOW_MASTER || SHADOW_CHSS
-        std::string getVogelIncludeContent(unsigned int shadowSamples, unsigned int penumbraSamples) const;
-        std::vector<glm::vec2> getVogelDisk(unsigned int size) const;
-#elif SHADOW_PCSS
-        std::string getPoissonIncludeContent(unsigned int shadowSamples, unsigned int penumbraSamples) const;
-#elif SHADOW_PCF
-        std::string getFilterSizeIncludeContent(unsigned int filterSize) const;
-#endif
+        std::string getVirtualShadowMapIncludeContent(bool enabled, unsigned int virtualPages, unsigned int poolPages) const;
+        std::string getClusterGridIncludeContent() const;
         std::map<std::filesystem::path, ShaderFileInfo> shaderFileInfos{};
         std::map<ShaderType, std::shared_ptr<GLShader>> shaders{};
         std::map<std::string, ShaderTextInclude> shaderIncludes{};
+        ProgramBinaryCache programBinaryCache{};
+        ShaderFileWatcher fileWatcher{};
         std::shared_ptr<UboMvp> uboMvp{};
         std::shared_ptr<UboMaterial> uboMaterial{};
         std::shared_ptr<UboLights> uboLights{};
         std::shared_ptr<UboWindow> uboWindow{};
-        const char* INCLUDE_TEXT = "//SHADOW>include ", * INCLUDED_FROM_TEXT = "//SHADOW>includedfrom ", * END_INCLUDE_TEXT = "//SHADOW>endinclude ", * REFILL_TEXT = "//SHADOW>refill";
-        const std::string SHADOW_IMPL_INCLUDE_TEXT{ "SHADOW_IMPL" };
-#if SHADOW_MASTER || SHADOW_CHSS
-        const std::string VOGEL_INCLUDE_TEXT{ "VOGEL_DISK" };
-#elif SHADOW_PCSS
-        const std::string POISSON_INCLUDE_TEXT{ "POISSON" };
-#elif SHADOW_PCF
-        const std::string FILTER_SIZE_INCLUDE_TEXT{ "FILTER_SIZE" };
-#endif
-        const size_t INCLUDE_LENGTH = strlen(INCLUDE_TEXT), INCLUDED_FROM_LENGTH = strlen(INCLUDED_FROM_TEXT), END_INCLUDE_LENGTH = strlen(END_INCLUDE_TEXT), REFILL_LENGTH = strlen(REFILL_TEXT);
-        const std::vector<std::string> SHADER_EXTENSIONS{ ".glsl", ".vert", ".frag" };
-        std::filesystem::path shadersDirectory{};
+        std::shared_ptr<UboSampling> uboSampling{};
+        std::shared_ptr<SsboPointLights> ssboPointLights{};
+        const char* INCLUDE_TEXT = "//SHADOW>include ", * INCLUDED_FROM_TEXT = "//SHADOW>includedfrom ", * END_INCLUDE_TEXT = "//SHADOW>endinclude ";
+        const std::string VIRTUAL_SHADOW_MAP_INCLUDE_TEXT{ "VIRTUAL_SHADOW_MAP" };
+        const std::string CLUSTER_GRID_INCLUDE_TEXT{ "CLUSTER_GRID" };
+        const size_t INCLUDE_LENGTH = strlen(INCLUDE_TEXT);
+        const std::vector<std::string> SHADER_EXTENSIONS{ ".glsl", ".vert", ".frag", ".comp" };
+        std::filesystem::path shadersDirectory{}, shaderCacheDirectory{};
     };
 }
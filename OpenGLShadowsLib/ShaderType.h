@@ -1,7 +1,5 @@
 #pragma once
 
-#include "ShadowVariants.h"
-
 namespace shadow
 {
     enum class ShaderType : unsigned int
@@ -11,17 +9,31 @@ namespace shadow
         Texture,
         DepthDir,
         DepthSpot,
-#if SHADOW_VSM
         DepthDirVSM,
         DepthSpotVSM,
+        DepthDirMSM,
+        DepthSpotMSM,
+        DepthDirEVSM,
+        DepthSpotEVSM,
         GaussianBlur,
-#endif
-#if SHADOW_MASTER || SHADOW_CHSS
         DirPenumbra,
         SpotPenumbra,
-#endif
+        DepthPyramid,
         PostProcess,
         ShadowOnly,
+        DepthBounds,
+        LightClustering,
+        DepthDirVirtual,
+        PageMarking,
+        DepthCamera,
+        ShadowTiles,
+        ShadowMask,
+        GBufferMaterial,
+        GBufferTexture,
+        DeferredLighting,
+        ContactShadows,
+        ShadowTemporal,
+        ShadowDenoise,
         ShaderTypeEnd
     };
-}
\ No newline at end of file
+}
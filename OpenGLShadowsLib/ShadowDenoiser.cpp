@@ -0,0 +1,110 @@
+#include "ShadowDenoiser.h"
+
+shadow::ShadowDenoiser::~ShadowDenoiser()
+{
+    deleteTextures();
+}
+
+bool shadow::ShadowDenoiser::initialize(std::shared_ptr<GLShader> shader, GLsizei width, GLsizei height)
+{
+    if (!shader)
+    {
+        SHADOW_ERROR("Shadow denoiser requires a compute shader!");
+        return false;
+    }
+    if (width <= 0 || height <= 0)
+    {
+        SHADOW_ERROR("Invalid shadow denoiser size ({}x{})!", width, height);
+        return false;
+    }
+    this->shader = shader;
+    this->width = width;
+    this->height = height;
+    createTextures();
+    return true;
+}
+
+void shadow::ShadowDenoiser::resize(GLsizei width, GLsizei height)
+{
+    assert(guideTexture);
+    assert(width > 0 && height > 0);
+    if (this->width == width && this->height == height)
+    {
+        return;
+    }
+    deleteTextures();
+    this->width = width;
+    this->height = height;
+    createTextures();
+}
+
+GLuint shadow::ShadowDenoiser::denoise(GLuint shadowMask, GLuint depthTexture, const glm::mat4& inverseProjection, unsigned int iterations, unsigned int kernelRadius) const
+{
+    assert(shader);
+    assert(guideTexture);
+    assert(iterations > 0U && iterations <= MAX_ITERATIONS);
+    assert(kernelRadius > 0U && kernelRadius <= MAX_KERNEL_RADIUS);
+    const GLuint groupsX = (width + LOCAL_SIZE - 1U) / LOCAL_SIZE;
+    const GLuint groupsY = (height + LOCAL_SIZE - 1U) / LOCAL_SIZE;
+    shader->use();
+    shader->setMat4("inverseProjection", inverseProjection);
+    shader->setInt("kernelRadius", static_cast<int>(kernelRadius));
+    glActiveTexture(GL_TEXTURE14);
+    glBindTexture(GL_TEXTURE_2D, depthTexture);
+
+    shader->setBool("buildGuide", true);
+    glBindImageTexture(1, guideTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+    glDispatchCompute(groupsX, groupsY, 1U);
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+    glBindImageTexture(1, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+
+    shader->setBool("buildGuide", false);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, guideTexture);
+    GLuint source = shadowMask;
+    for (unsigned int i = 0U; i < iterations; ++i)
+    {
+        const GLuint target = textures[i % 2U];
+        shader->setInt("stepWidth", 1 << i);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, source);
+        glBindImageTexture(0, target, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
+        glDispatchCompute(groupsX, groupsY, 1U);
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+        source = target;
+    }
+    glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
+    glActiveTexture(GL_TEXTURE0);
+    return source;
+}
+
+void shadow::ShadowDenoiser::createTextures()
+{
+    SHADOW_DEBUG("Creating {}x{} shadow denoiser textures...", width, height);
+    auto createTexture = [this](GLuint& texture, GLenum internalFormat)
+    {
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexStorage2D(GL_TEXTURE_2D, 1, internalFormat, width, height);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    };
+    createTexture(guideTexture, GL_RGBA16F);
+    for (GLuint& texture : textures)
+    {
+        createTexture(texture, GL_RGBA8);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void shadow::ShadowDenoiser::deleteTextures()
+{
+    if (guideTexture)
+    {
+        glDeleteTextures(1, &guideTexture);
+        glDeleteTextures(2, textures);
+        guideTexture = textures[0] = textures[1] = 0;
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "GLShader.h"
+
+#include <memory>
+
+namespace shadow
+{
+    // edge-aware a-trous filter of the shadow mask, guided by the view depth, the normals reconstructed from it and the penumbra
+    // radius of every pixel, so that few shadow samples per pixel can be traded for a couple of cheap screen space passes
+    class ShadowDenoiser final
+    {
+    public:
+        static constexpr unsigned int MAX_ITERATIONS{ 5U }, MAX_KERNEL_RADIUS{ 2U };
+        ShadowDenoiser() = default;
+        ~ShadowDenoiser();
+        ShadowDenoiser(ShadowDenoiser&) = delete;
+        ShadowDenoiser(ShadowDenoiser&&) = delete;
+        ShadowDenoiser& operator=(ShadowDenoiser&) = delete;
+        ShadowDenoiser& operator=(ShadowDenoiser&&) = delete;
+        bool initialize(std::shared_ptr<GLShader> shader, GLsizei width, GLsizei height);
+        void resize(GLsizei width, GLsizei height);
+        // returns the texture holding the result, which stays valid until the next call
+        GLuint denoise(GLuint shadowMask, GLuint depthTexture, const glm::mat4& inverseProjection, unsigned int iterations, unsigned int kernelRadius) const;
+    private:
+        static constexpr GLuint LOCAL_SIZE{ 8U };
+        void createTextures();
+        void deleteTextures();
+        std::shared_ptr<GLShader> shader{};
+        GLsizei width{}, height{};
+        GLuint guideTexture{};
+        GLuint textures[2]{}; // written and read in turns
+    };
+}
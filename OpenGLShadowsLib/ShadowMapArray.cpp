@@ -0,0 +1,168 @@
+#include "ShadowMapArray.h"
+
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+
+shadow::ShadowMapArray::~ShadowMapArray()
+{
+    deleteTextures();
+    if (layerFbos[0])
+    {
+        glDeleteFramebuffers(LAYERS, layerFbos.data());
+    }
+}
+
+bool shadow::ShadowMapArray::initialize(GLenum internalFormat, GLsizei size, bool mipmapped)
+{
+    if (size <= 0)
+    {
+        SHADOW_ERROR("Invalid shadow map array size ({})!", size);
+        return false;
+    }
+    SHADOW_DEBUG("Creating {} layer {}x{} shadow map array ({})...", LAYERS, size, size, internalFormat);
+    this->internalFormat = internalFormat;
+    this->size = size;
+    this->mipmapped = mipmapped;
+    glGenFramebuffers(LAYERS, layerFbos.data());
+    createTextures();
+    GLint previousFramebuffer;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    bool complete = true;
+    for (GLuint fbo : layerFbos)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        complete = complete && glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+    if (!complete)
+    {
+        SHADOW_ERROR("Shadow map array framebuffer initialization failed!");
+        return false;
+    }
+    return true;
+}
+
+void shadow::ShadowMapArray::resize(GLsizei size)
+{
+    assert(texture);
+    assert(size > 0);
+    if (this->size == size)
+    {
+        return;
+    }
+    SHADOW_DEBUG("Resizing shadow map array to {}x{}...", size, size);
+    // the storage is immutable because of the texture views, so it has to be recreated
+    deleteTextures();
+    this->size = size;
+    createTextures();
+}
+
+void shadow::ShadowMapArray::setInternalFormat(GLenum internalFormat)
+{
+    assert(texture);
+    if (this->internalFormat == internalFormat)
+    {
+        return;
+    }
+    SHADOW_DEBUG("Changing shadow map array format to {}...", internalFormat);
+    deleteTextures();
+    this->internalFormat = internalFormat;
+    createTextures();
+}
+
+void shadow::ShadowMapArray::setBorderColor(const glm::vec4& borderColor)
+{
+    this->borderColor = borderColor;
+    for (GLuint layerTexture : layerTextures)
+    {
+        if (layerTexture)
+        {
+            glBindTexture(GL_TEXTURE_2D, layerTexture);
+            glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, value_ptr(borderColor));
+        }
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void shadow::ShadowMapArray::generateMipmaps() const
+{
+    assert(mipmapped);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+void shadow::ShadowMapArray::createTextures()
+{
+    levels = 1;
+    if (mipmapped)
+    {
+        while ((size >> levels) > 0)
+        {
+            ++levels;
+        }
+    }
+    GLfloat maxAnisotropy{};
+    if (mipmapped && GLAD_GL_VERSION_4_6) // anisotropic filtering is core only since 4.6
+    {
+        glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &maxAnisotropy);
+    }
+    GLuint arrays[2];
+    glGenTextures(2, arrays);
+    for (GLuint array : arrays)
+    {
+        glBindTexture(GL_TEXTURE_2D_ARRAY, array);
+        glTexStorage3D(GL_TEXTURE_2D_ARRAY, levels, internalFormat, size, size, LAYERS);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    texture = arrays[0];
+    tempTexture = arrays[1];
+    glGenTextures(LAYERS, layerTextures.data());
+    for (GLsizei layer = 0; layer < LAYERS; ++layer)
+    {
+        glTextureView(layerTextures[layer], GL_TEXTURE_2D, texture, internalFormat, 0, levels, layer, 1);
+        glBindTexture(GL_TEXTURE_2D, layerTextures[layer]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, value_ptr(borderColor));
+        if (maxAnisotropy > 1.0f)
+        {
+            glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY, std::min(maxAnisotropy, MAX_ANISOTROPY));
+        }
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    // the layers are rendered one after another, so they can share the depth buffer
+    glGenRenderbuffers(1, &depthRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, size, size);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    GLint previousFramebuffer;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    for (GLsizei layer = 0; layer < LAYERS; ++layer)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, layerFbos[layer]);
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, texture, 0, layer);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthRenderbuffer);
+        glDrawBuffer(GL_COLOR_ATTACHMENT0);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+}
+
+void shadow::ShadowMapArray::deleteTextures()
+{
+    if (texture)
+    {
+        glDeleteTextures(LAYERS, layerTextures.data());
+        glDeleteTextures(1, &texture);
+        glDeleteTextures(1, &tempTexture);
+        glDeleteRenderbuffers(1, &depthRenderbuffer);
+        texture = tempTexture = depthRenderbuffer = 0U;
+        layerTextures.fill(0U);
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "ShadowLog.h"
+
+#include "glad/glad.h"
+#include <glm/glm.hpp>
+#include <array>
+
+namespace shadow
+{
+    // filterable shadow maps of all lights stored as layers of one array texture, so that a single compute dispatch can process them;
+    // every layer also has its own framebuffer and a 2D texture view for sampling
+    class ShadowMapArray final
+    {
+    public:
+        static constexpr GLsizei LAYERS{ 2 };
+        static constexpr GLfloat MAX_ANISOTROPY{ 16.0f };
+        ShadowMapArray() = default;
+        ~ShadowMapArray();
+        ShadowMapArray(ShadowMapArray&) = delete;
+        ShadowMapArray(ShadowMapArray&&) = delete;
+        ShadowMapArray& operator=(ShadowMapArray&) = delete;
+        ShadowMapArray& operator=(ShadowMapArray&&) = delete;
+        bool initialize(GLenum internalFormat, GLsizei size, bool mipmapped);
+        void resize(GLsizei size);
+        void setInternalFormat(GLenum internalFormat);
+        void setBorderColor(const glm::vec4& borderColor);
+        void generateMipmaps() const;
+        inline GLenum getInternalFormat() const;
+        inline GLsizei getSize() const;
+        inline GLuint getTexture() const;
+        inline GLuint getTempTexture() const;
+        inline GLuint getLayerTexture(GLsizei layer) const;
+        inline GLuint getLayerFbo(GLsizei layer) const;
+    private:
+        void createTextures();
+        void deleteTextures();
+        GLenum internalFormat{};
+        GLsizei size{}, levels{ 1 };
+        bool mipmapped{};
+        glm::vec4 borderColor{ 1.0f };
+        GLuint texture{}, tempTexture{}, depthRenderbuffer{};
+        std::array<GLuint, LAYERS> layerTextures{}, layerFbos{};
+    };
+
+    inline GLenum ShadowMapArray::getInternalFormat() const
+    {
+        return internalFormat;
+    }
+
+    inline GLsizei ShadowMapArray::getSize() const
+    {
+        return size;
+    }
+
+    inline GLuint ShadowMapArray::getTexture() const
+    {
+        assert(texture);
+        return texture;
+    }
+
+    inline GLuint ShadowMapArray::getTempTexture() const
+    {
+        assert(tempTexture);
+        return tempTexture;
+    }
+
+    inline GLuint ShadowMapArray::getLayerTexture(GLsizei layer) const
+    {
+        assert(layer >= 0 && layer < LAYERS);
+        return layerTextures[layer];
+    }
+
+    inline GLuint ShadowMapArray::getLayerFbo(GLsizei layer) const
+    {
+        assert(layer >= 0 && layer < LAYERS);
+        return layerFbos[layer];
+    }
+}
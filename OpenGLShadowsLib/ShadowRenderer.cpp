@@ -0,0 +1,196 @@
+#include "ShadowRenderer.h"
+#include "DepthShadowRenderers.h"
+#include "MomentShadowRenderers.h"
+#include "ResourceManager.h"
+#include "Benchmark.h"
+
+#include <glm/gtc/type_ptr.hpp>
+#include <sstream>
+
+shadow::ShadowRenderer::~ShadowRenderer() = default;
+
+std::unique_ptr<shadow::ShadowRenderer> shadow::ShadowRenderer::create(ShadowTechnique technique)
+{
+    switch (technique)
+    {
+    case ShadowTechnique::Master:
+        return std::make_unique<MasterShadowRenderer>();
+    case ShadowTechnique::Basic:
+        return std::make_unique<BasicShadowRenderer>();
+    case ShadowTechnique::PCF:
+        return std::make_unique<PCFShadowRenderer>();
+    case ShadowTechnique::VSM:
+        return std::make_unique<VSMShadowRenderer>();
+    case ShadowTechnique::PCSS:
+        return std::make_unique<PCSSShadowRenderer>();
+    case ShadowTechnique::CHSS:
+        return std::make_unique<CHSSShadowRenderer>();
+    case ShadowTechnique::MSM:
+        return std::make_unique<MSMShadowRenderer>();
+    case ShadowTechnique::EVSM:
+        return std::make_unique<EVSMShadowRenderer>();
+    default:
+        SHADOW_ERROR("Invalid shadow technique ({})!", technique);
+        return {};
+    }
+}
+
+const char* shadow::ShadowRenderer::getName() const
+{
+    return getShadowTechniqueName(getTechnique());
+}
+
+bool shadow::ShadowRenderer::initialize(GLsizei textureSize, GLsizei windowWidth, GLsizei windowHeight)
+{
+    if (textureSize <= 0)
+    {
+        SHADOW_ERROR("Invalid texture size ({})!", textureSize);
+        return false;
+    }
+    if (windowWidth <= 0 || windowHeight <= 0)
+    {
+        SHADOW_ERROR("Invalid window size ({}x{})!", windowWidth, windowHeight);
+        return false;
+    }
+    SHADOW_DEBUG("Initializing {} shadow renderer...", getName());
+    this->textureSize = textureSize;
+    this->windowWidth = windowWidth;
+    this->windowHeight = windowHeight;
+    return true;
+}
+
+void shadow::ShadowRenderer::resizeWindow(GLsizei windowWidth, GLsizei windowHeight)
+{
+    this->windowWidth = windowWidth;
+    this->windowHeight = windowHeight;
+}
+
+void shadow::ShadowRenderer::activate() const
+{
+    updateShaderIncludes();
+}
+
+shadow::ShaderIncludes shadow::ShadowRenderer::getShaderIncludes() const
+{
+    std::stringstream ss{};
+    ss << "#define SHADOW_IMPL " << static_cast<unsigned int>(getTechnique()) << std::endl;
+    // every shader is compiled whatever the technique, so the includes of the moment techniques need contents as well
+    return {
+        { SHADOW_IMPL_INCLUDE_TEXT, ss.str() },
+        { SHADOW_MAP_FORMAT_INCLUDE_TEXT, getShadowMapFormatIncludeContent(GL_DEPTH_COMPONENT, false) },
+        { EVSM_INCLUDE_TEXT, EVSMShadowRenderer::getEvsmIncludeContent(EVSMShadowRenderer::DEFAULT_POSITIVE_EXPONENT, EVSMShadowRenderer::DEFAULT_NEGATIVE_EXPONENT, 0.0f) }
+    };
+}
+
+bool shadow::ShadowRenderer::hasDepthMaps() const
+{
+    return true;
+}
+
+bool shadow::ShadowRenderer::hasBlockerSearch() const
+{
+    return false;
+}
+
+GLenum shadow::ShadowRenderer::getColorFormat() const
+{
+    return GL_NONE;
+}
+
+glm::vec4 shadow::ShadowRenderer::getClearColor() const
+{
+    return glm::vec4(1.0f);
+}
+
+void shadow::ShadowRenderer::renderDirShadowMap(Scene& scene) const
+{
+    renderShadowMap(scene, dirDepthShader, getDirFbo());
+}
+
+void shadow::ShadowRenderer::renderSpotShadowMap(Scene& scene) const
+{
+    renderShadowMap(scene, spotDepthShader, getSpotFbo());
+}
+
+void shadow::ShadowRenderer::renderShadowPasses(Scene& scene, bool dirPaged)
+{
+}
+
+void shadow::ShadowRenderer::classifyTiles(const ShadowTileClassification& shadowTiles, GLuint depthTexture, const glm::mat4& inverseViewProjection, bool dirPaged) const
+{
+}
+
+void shadow::ShadowRenderer::bindShadowTextures(GLuint dirShadowTexture) const
+{
+    glActiveTexture(GL_TEXTURE10);
+    glBindTexture(GL_TEXTURE_2D, dirShadowTexture);
+    glActiveTexture(GL_TEXTURE11);
+    glBindTexture(GL_TEXTURE_2D, getSpotTexture());
+}
+
+void shadow::ShadowRenderer::drawSettings()
+{
+}
+
+shadow::TechniqueConfigurator& shadow::ShadowRenderer::getConfigurator()
+{
+    if (!configurator)
+    {
+        configurator = createConfigurator();
+    }
+    return *configurator;
+}
+
+void shadow::ShadowRenderer::updateShaderIncludes() const
+{
+    ResourceManager::getInstance().updateShaderIncludes(getShaderIncludes());
+}
+
+void shadow::ShadowRenderer::markModified()
+{
+    ++revision;
+}
+
+void shadow::ShadowRenderer::renderShadowMap(Scene& scene, const std::shared_ptr<GLShader>& depthShader, GLuint fbo) const
+{
+    glViewport(0, 0, textureSize, textureSize);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    if (getColorFormat() != GL_NONE)
+    {
+        glClearBufferfv(GL_COLOR, 0, value_ptr(getClearColor()));
+    }
+    glClear(GL_DEPTH_BUFFER_BIT);
+    depthShader->use();
+    scene.render(depthShader);
+}
+
+std::string shadow::ShadowRenderer::getShadowMapFormatIncludeContent(GLenum internalFormat, bool quantized)
+{
+    const char* imageFormat{};
+    switch (internalFormat)
+    {
+    case GL_RG32F:
+        imageFormat = "rg32f";
+        break;
+    case GL_RGBA32F:
+        imageFormat = "rgba32f";
+        break;
+    case GL_RGBA16:
+        imageFormat = "rgba16";
+        break;
+    case GL_RGBA16F:
+        imageFormat = "rgba16f";
+        break;
+    case GL_DEPTH_COMPONENT:
+        imageFormat = "r32f"; // depth based techniques never write the shadow maps as images
+        break;
+    default:
+        SHADOW_ERROR("Unsupported shadow map format ({})!", internalFormat);
+        imageFormat = "rgba32f";
+        break;
+    }
+    std::stringstream ss{};
+    ss << "#define SHADOW_MAP_IMAGE_FORMAT " << imageFormat << std::endl;
+    ss << "#define MSM_QUANTIZED " << (quantized ? 1 : 0) << std::endl;
+    return ss.str();
+}
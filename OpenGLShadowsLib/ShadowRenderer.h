@@ -0,0 +1,97 @@
+#pragma once
+
+#include "ShadowLog.h"
+#include "GLShader.h"
+#include "Scene.h"
+#include "ShaderManager.h"
+#include "ShadowVariants.h"
+
+#include "glad/glad.h"
+#include <glm/glm.hpp>
+#include <memory>
+
+namespace shadow
+{
+    class TechniqueConfigurator;
+    class ShadowTileClassification;
+
+    // a shadow technique with everything specific to it: its maps, the passes rendering and filtering them, its shader permutation and its configurator
+    class ShadowRenderer abstract
+    {
+    public:
+        virtual ~ShadowRenderer();
+        ShadowRenderer(ShadowRenderer&) = delete;
+        ShadowRenderer(ShadowRenderer&&) = delete;
+        ShadowRenderer& operator=(ShadowRenderer&) = delete;
+        ShadowRenderer& operator=(ShadowRenderer&&) = delete;
+        static std::unique_ptr<ShadowRenderer> create(ShadowTechnique technique);
+        virtual ShadowTechnique getTechnique() const = 0;
+        const char* getName() const;
+        virtual bool initialize(GLsizei textureSize, GLsizei windowWidth, GLsizei windowHeight);
+        virtual void resize(GLsizei textureSize) = 0;
+        virtual void resizeWindow(GLsizei windowWidth, GLsizei windowHeight);
+        // publishes the includes and sampling parameters of the technique, which the other techniques overwrite with their own
+        virtual void activate() const;
+        // valid before the initialization, so that the shaders can be compiled for the technique right away
+        virtual ShaderIncludes getShaderIncludes() const;
+        // the virtual and incremental shadow maps are built around plain depth maps
+        virtual bool hasDepthMaps() const;
+        // the blocker search estimates the penumbra that the tile classification and the denoiser rely on
+        virtual bool hasBlockerSearch() const;
+        virtual GLuint getDirFbo() const = 0;
+        virtual GLuint getSpotFbo() const = 0;
+        virtual GLuint getDirTexture() const = 0;
+        virtual GLuint getSpotTexture() const = 0;
+        virtual GLenum getColorFormat() const; // GL_NONE for depth maps
+        virtual glm::vec4 getClearColor() const;
+        inline GLsizei getTextureSize() const;
+        inline std::shared_ptr<GLShader> getDirDepthShader() const;
+        inline std::shared_ptr<GLShader> getSpotDepthShader() const;
+        void renderDirShadowMap(Scene& scene) const;
+        void renderSpotShadowMap(Scene& scene) const;
+        // everything done with the maps once they are rendered, dirPaged when the directional light uses the virtual shadow map instead
+        virtual void renderShadowPasses(Scene& scene, bool dirPaged);
+        virtual void classifyTiles(const ShadowTileClassification& shadowTiles, GLuint depthTexture, const glm::mat4& inverseViewProjection, bool dirPaged) const;
+        virtual void bindShadowTextures(GLuint dirShadowTexture) const;
+        // bumped whenever the maps are recreated or whatever they were rendered with changes
+        inline unsigned int getRevision() const;
+        virtual void drawSettings();
+        TechniqueConfigurator& getConfigurator();
+    protected:
+        ShadowRenderer() = default;
+        virtual std::unique_ptr<TechniqueConfigurator> createConfigurator() = 0;
+        void updateShaderIncludes() const;
+        void markModified();
+        void renderShadowMap(Scene& scene, const std::shared_ptr<GLShader>& depthShader, GLuint fbo) const;
+        static std::string getShadowMapFormatIncludeContent(GLenum internalFormat, bool quantized);
+        static constexpr const char* SHADOW_IMPL_INCLUDE_TEXT{ "SHADOW_IMPL" };
+        static constexpr const char* SHADOW_MAP_FORMAT_INCLUDE_TEXT{ "SHADOW_MAP_FORMAT" };
+        static constexpr const char* EVSM_INCLUDE_TEXT{ "EVSM" };
+        std::shared_ptr<GLShader> dirDepthShader{}, spotDepthShader{};
+        GLsizei textureSize{}, windowWidth{}, windowHeight{};
+    private:
+        std::unique_ptr<TechniqueConfigurator> configurator{};
+        unsigned int revision{};
+    };
+
+    inline GLsizei ShadowRenderer::getTextureSize() const
+    {
+        assert(textureSize);
+        return textureSize;
+    }
+
+    inline std::shared_ptr<GLShader> ShadowRenderer::getDirDepthShader() const
+    {
+        return dirDepthShader;
+    }
+
+    inline std::shared_ptr<GLShader> ShadowRenderer::getSpotDepthShader() const
+    {
+        return spotDepthShader;
+    }
+
+    inline unsigned int ShadowRenderer::getRevision() const
+    {
+        return revision;
+    }
+}
@@ -0,0 +1,103 @@
+#include "ShadowTileClassification.h"
+
+shadow::ShadowTileClassification::~ShadowTileClassification()
+{
+    deleteTexture();
+}
+
+bool shadow::ShadowTileClassification::initialize(std::shared_ptr<GLShader> shader, GLsizei width, GLsizei height, GLsizei tileSize)
+{
+    if (!shader)
+    {
+        SHADOW_ERROR("Shadow tile classification requires a compute shader!");
+        return false;
+    }
+    if (width <= 0 || height <= 0)
+    {
+        SHADOW_ERROR("Invalid shadow tile classification size ({}x{})!", width, height);
+        return false;
+    }
+    if (tileSize <= 0 || tileSize % LOCAL_SIZE != 0)
+    {
+        SHADOW_ERROR("Shadow tile size ({}) must be a multiple of {}!", tileSize, LOCAL_SIZE);
+        return false;
+    }
+    this->shader = shader;
+    this->width = width;
+    this->height = height;
+    this->tileSize = tileSize;
+    createTexture();
+    return true;
+}
+
+void shadow::ShadowTileClassification::resize(GLsizei width, GLsizei height)
+{
+    assert(texture);
+    assert(width > 0 && height > 0);
+    if (this->width == width && this->height == height)
+    {
+        return;
+    }
+    deleteTexture();
+    this->width = width;
+    this->height = height;
+    createTexture();
+}
+
+void shadow::ShadowTileClassification::setTileSize(GLsizei tileSize)
+{
+    assert(texture);
+    assert(tileSize > 0 && tileSize % LOCAL_SIZE == 0);
+    if (this->tileSize == tileSize)
+    {
+        return;
+    }
+    deleteTexture();
+    this->tileSize = tileSize;
+    createTexture();
+}
+
+void shadow::ShadowTileClassification::classify(GLuint depthTexture, const glm::mat4& inverseViewProjection, GLuint dirPyramid, GLuint spotPyramid, bool dirPaged) const
+{
+    assert(shader);
+    assert(texture);
+    shader->use();
+    shader->setMat4("inverseViewProjection", inverseViewProjection);
+    shader->setInt("tileSize", tileSize);
+    shader->setBool("directionalPaged", dirPaged);
+    glActiveTexture(GL_TEXTURE14);
+    glBindTexture(GL_TEXTURE_2D, depthTexture);
+    glActiveTexture(GL_TEXTURE16);
+    glBindTexture(GL_TEXTURE_2D, dirPyramid);
+    glActiveTexture(GL_TEXTURE17);
+    glBindTexture(GL_TEXTURE_2D, spotPyramid);
+    glBindImageTexture(0, texture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RG8UI);
+    glDispatchCompute(tilesX, tilesY, 1U);
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+    glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RG8UI);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void shadow::ShadowTileClassification::createTexture()
+{
+    tilesX = (width + tileSize - 1) / tileSize;
+    tilesY = (height + tileSize - 1) / tileSize;
+    SHADOW_DEBUG("Creating {}x{} shadow tile classification for {}x{} pixel tiles...", tilesX, tilesY, tileSize, tileSize);
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RG8UI, tilesX, tilesY);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void shadow::ShadowTileClassification::deleteTexture()
+{
+    if (texture)
+    {
+        glDeleteTextures(1, &texture);
+        texture = 0;
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "GLShader.h"
+
+#include <memory>
+
+namespace shadow
+{
+    // labels every screen tile as fully lit, fully shadowed or penumbra per light, based on the prepass depth
+    // and the light depth pyramids, so that the main pass only runs the soft shadow filter in penumbra tiles
+    class ShadowTileClassification final
+    {
+    public:
+        ShadowTileClassification() = default;
+        ~ShadowTileClassification();
+        ShadowTileClassification(ShadowTileClassification&) = delete;
+        ShadowTileClassification(ShadowTileClassification&&) = delete;
+        ShadowTileClassification& operator=(ShadowTileClassification&) = delete;
+        ShadowTileClassification& operator=(ShadowTileClassification&&) = delete;
+        bool initialize(std::shared_ptr<GLShader> shader, GLsizei width, GLsizei height, GLsizei tileSize);
+        void resize(GLsizei width, GLsizei height);
+        void setTileSize(GLsizei tileSize);
+        inline GLsizei getTileSize() const;
+        void classify(GLuint depthTexture, const glm::mat4& inverseViewProjection, GLuint dirPyramid, GLuint spotPyramid, bool dirPaged) const;
+        inline GLuint getTexture() const;
+    private:
+        static constexpr GLuint LOCAL_SIZE{ 8U };
+        void createTexture();
+        void deleteTexture();
+        std::shared_ptr<GLShader> shader{};
+        GLsizei width{}, height{}, tileSize{}, tilesX{}, tilesY{};
+        GLuint texture{};
+    };
+
+    inline GLsizei ShadowTileClassification::getTileSize() const
+    {
+        return tileSize;
+    }
+
+    inline GLuint ShadowTileClassification::getTexture() const
+    {
+        assert(texture);
+        return texture;
+    }
+}
@@ -6,18 +6,58 @@
 #define SHADOW_IMPL_VSM 3
 #define SHADOW_IMPL_PCSS 4
 #define SHADOW_IMPL_CHSS 5
+#define SHADOW_IMPL_MSM 6
+#define SHADOW_IMPL_EVSM 7
 
+// the build configuration only picks the technique the application starts with
 #ifndef SHADOW_IMPL
-#error "SHADOW_IMPL is not defined!"
+#define SHADOW_IMPL SHADOW_IMPL_MASTER
 #endif
 
-#if SHADOW_IMPL < SHADOW_IMPL_MASTER || SHADOW_IMPL > SHADOW_IMPL_CHSS
+#if SHADOW_IMPL < SHADOW_IMPL_MASTER || SHADOW_IMPL > SHADOW_IMPL_EVSM
 #error "Invalid SHADOW_IMPL value!"
 #endif
 
-#define SHADOW_MASTER SHADOW_IMPL == SHADOW_IMPL_MASTER
-#define SHADOW_BASIC SHADOW_IMPL == SHADOW_IMPL_BASIC
-#define SHADOW_PCF SHADOW_IMPL == SHADOW_IMPL_PCF
-#define SHADOW_VSM SHADOW_IMPL == SHADOW_IMPL_VSM
-#define SHADOW_PCSS SHADOW_IMPL == SHADOW_IMPL_PCSS
-#define SHADOW_CHSS SHADOW_IMPL == SHADOW_IMPL_CHSS
+namespace shadow
+{
+    // values match SHADOW_IMPL_*, which is what the shaders get specialized with
+    enum class ShadowTechnique : unsigned int
+    {
+        Master = SHADOW_IMPL_MASTER,
+        Basic = SHADOW_IMPL_BASIC,
+        PCF = SHADOW_IMPL_PCF,
+        VSM = SHADOW_IMPL_VSM,
+        PCSS = SHADOW_IMPL_PCSS,
+        CHSS = SHADOW_IMPL_CHSS,
+        MSM = SHADOW_IMPL_MSM,
+        EVSM = SHADOW_IMPL_EVSM,
+        ShadowTechniqueEnd
+    };
+
+    constexpr ShadowTechnique DEFAULT_SHADOW_TECHNIQUE{ static_cast<ShadowTechnique>(SHADOW_IMPL) };
+
+    inline const char* getShadowTechniqueName(ShadowTechnique technique)
+    {
+        switch (technique)
+        {
+        case ShadowTechnique::Master:
+            return "Master";
+        case ShadowTechnique::Basic:
+            return "Basic";
+        case ShadowTechnique::PCF:
+            return "PCF";
+        case ShadowTechnique::VSM:
+            return "VSM";
+        case ShadowTechnique::PCSS:
+            return "PCSS";
+        case ShadowTechnique::CHSS:
+            return "CHSS";
+        case ShadowTechnique::MSM:
+            return "MSM";
+        case ShadowTechnique::EVSM:
+            return "EVSM";
+        default:
+            return "Unknown";
+        }
+    }
+}
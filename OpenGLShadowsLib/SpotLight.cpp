@@ -15,7 +15,7 @@ glm::mat4 shadow::SpotLight::getLightSpace()
 
 void shadow::SpotLight::updateLightSpace()
 {
-    lightData.lightSpace = glm::perspective(FPI * 0.5f, 1.0f, lightData.nearZ, lightData.farZ)
+    lightData.lightSpace = glm::perspective(autoFit && hasFit ? fittedFov : FPI * 0.5f, 1.0f, lightData.nearZ, lightData.farZ)
         * lookAt(lightData.position, lightData.position + lightData.direction, glm::vec3(0.0f, 1.0f, 0.0f));
     lightSpaceDirty = false;
 }
@@ -64,6 +64,43 @@ void shadow::SpotLight::setLightSize(float lightSize)
     dirty = true;
 }
 
+glm::mat4 shadow::SpotLight::getFittingView() const
+{
+    return lookAt(lightData.position, lightData.position + lightData.direction, glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
+void shadow::SpotLight::fitToViewBounds(const BoundingBox& casterBounds, const BoundingBox& receiverViewBounds)
+{
+    if (!casterBounds.isValid() || !receiverViewBounds.isValid())
+    {
+        return;
+    }
+    BoundingBox casters = casterBounds.transformed(getFittingView());
+    // the cone never lights anything outside of the outer cut-off, so the frustum can be narrowed down to it
+    const float FOV_MARGIN = 1.05f;
+    float fov = glm::min(2.0f * acosf(glm::clamp(lightData.outerCutOff, -1.0f, 1.0f)) * FOV_MARGIN, FPI * 0.9f);
+    if (receiverViewBounds.max.z < 0.0f)
+    {
+        // with all receivers in front of the light, the widest angle is found at their nearest depth
+        float extent = glm::max(glm::max(-receiverViewBounds.min.x, receiverViewBounds.max.x), glm::max(-receiverViewBounds.min.y, receiverViewBounds.max.y));
+        fov = glm::min(fov, 2.0f * atanf(extent / -receiverViewBounds.max.z) * FOV_MARGIN);
+    }
+    float farZ = -receiverViewBounds.min.z;
+    float nearZ = glm::max(-casters.max.z, FIT_MIN_NEAR_Z);
+    if (farZ <= nearZ)
+    {
+        return;
+    }
+    hasFit = true;
+    if (fov != fittedFov || nearZ != lightData.nearZ || farZ != lightData.farZ)
+    {
+        fittedFov = fov;
+        lightData.nearZ = nearZ;
+        lightData.farZ = farZ;
+        dirty = lightSpaceDirty = true;
+    }
+}
+
 void shadow::SpotLight::setInnerCutOff(float innerCutOff)
 {
     lightData.innerCutOff = innerCutOff;
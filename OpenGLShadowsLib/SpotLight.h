@@ -32,9 +32,13 @@ namespace shadow
         void setNearZ(float nearZ) override;
         void setFarZ(float farZ) override;
         void setLightSize(float lightSize) override;
+        glm::mat4 getFittingView() const override;
+        void fitToViewBounds(const BoundingBox& casterBounds, const BoundingBox& receiverViewBounds) override;
         void setInnerCutOff(float innerCutOff);
         void setOuterCutOff(float outerCutOff);
     private:
+        float fittedFov{};
+        bool hasFit{ false };
         float angleX{}, angleY{}, angleZ{};
     };
 }
@@ -0,0 +1,29 @@
+#include "SsboPointLights.h"
+
+#include <algorithm>
+
+shadow::SsboPointLights::SsboPointLights()
+    : ShaderStorageBufferObject("PointLights", 1, LIGHTS_OFFSET + MAX_POINT_LIGHTS * sizeof(PointLightData))
+{
+    // the buffer storage is left undefined, so no point lights are read until the first set
+    bufferSubData(&count, sizeof(unsigned int), 0);
+}
+
+void shadow::SsboPointLights::set(std::vector<PointLightData>& data)
+{
+    if (data.size() > MAX_POINT_LIGHTS)
+    {
+        SHADOW_WARN("Only {} out of {} point lights will be used!", MAX_POINT_LIGHTS, data.size());
+    }
+    count = static_cast<unsigned int>(std::min(data.size(), static_cast<size_t>(MAX_POINT_LIGHTS)));
+    bufferSubData(&count, sizeof(unsigned int), 0);
+    if (count)
+    {
+        bufferSubData(data.data(), count * sizeof(PointLightData), LIGHTS_OFFSET);
+    }
+}
+
+unsigned int shadow::SsboPointLights::getCount() const
+{
+    return count;
+}
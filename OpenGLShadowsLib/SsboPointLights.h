@@ -0,0 +1,29 @@
+#pragma once
+
+#include "ShaderStorageBufferObject.h"
+
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace shadow
+{
+    struct PointLightData final
+    {
+        glm::vec3 position{ 0.0f, 0.0f, 0.0f };
+        float radius{ 1.0f }; // the light does not contribute past this distance
+        glm::vec3 color{ 1.0f, 1.0f, 1.0f };
+        float strength{ 0.0f };
+    };
+
+    class SsboPointLights final : public ShaderStorageBufferObject<std::vector<PointLightData>>
+    {
+    public:
+        static constexpr unsigned int MAX_POINT_LIGHTS{ 1024U };
+        SsboPointLights();
+        void set(std::vector<PointLightData>& data) override;
+        unsigned int getCount() const;
+    private:
+        static constexpr GLintptr LIGHTS_OFFSET{ 16 }; // the count is padded to the alignment of the light array
+        unsigned int count{};
+    };
+}
@@ -0,0 +1,68 @@
+#include "StaticShadowCache.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+void shadow::StaticShadowCache::invalidate()
+{
+    valid = false;
+}
+
+void shadow::StaticShadowCache::update(Scene& scene, std::shared_ptr<GLShader> depthShader, GLuint fbo, GLsizei textureSize, GLenum colorFormat, const glm::vec4& clearColor, const glm::mat4& lightSpace)
+{
+    assert(depthShader);
+    glViewport(0, 0, textureSize, textureSize);
+    depthShader->use();
+    if (!cache || textureSize != lastTextureSize || colorFormat != lastColorFormat)
+    {
+        if (!createCache(textureSize, colorFormat))
+        {
+            // without the cache every caster is drawn each frame, as if the split was disabled
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+            if (colorFormat != GL_NONE)
+            {
+                glClearBufferfv(GL_COLOR, 0, value_ptr(clearColor));
+            }
+            glClear(GL_DEPTH_BUFFER_BIT);
+            scene.render(depthShader);
+            return;
+        }
+        valid = false;
+    }
+    if (!valid || lightSpace != lastLightSpace)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, cache->getFbo());
+        if (colorFormat != GL_NONE)
+        {
+            glClearBufferfv(GL_COLOR, 0, value_ptr(clearColor));
+        }
+        glClear(GL_DEPTH_BUFFER_BIT);
+        scene.renderCasters(depthShader, false);
+        valid = true;
+        lastLightSpace = lightSpace;
+    }
+    // both maps share their formats, so the copy is exact and the dynamic casters depth test against the static ones
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, cache->getFbo());
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
+    glBlitFramebuffer(0, 0, textureSize, textureSize, 0, 0, textureSize, textureSize,
+        colorFormat != GL_NONE ? GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT : GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    scene.renderCasters(depthShader, true);
+}
+
+bool shadow::StaticShadowCache::createCache(GLsizei textureSize, GLenum colorFormat)
+{
+    SHADOW_DEBUG("Creating {}x{} static shadow cache ({})...", textureSize, textureSize, colorFormat);
+    cache = std::make_unique<Framebuffer>();
+    lastTextureSize = textureSize;
+    lastColorFormat = colorFormat;
+    // mirrors the formats of the shadow renderers and ShadowMapArray
+    bool isFine = colorFormat == GL_NONE
+        ? cache->initialize(false, GL_DEPTH_ATTACHMENT, GL_DEPTH_COMPONENT, textureSize, textureSize, GL_DEPTH_COMPONENT, GL_FLOAT, GL_NEAREST, GL_CLAMP_TO_BORDER, glm::vec4(1.0f))
+        : cache->initialize(true, GL_COLOR_ATTACHMENT0, colorFormat, textureSize, textureSize, GL_RGBA, GL_FLOAT, GL_NEAREST, GL_CLAMP_TO_EDGE);
+    if (!isFine)
+    {
+        SHADOW_ERROR("Failed to create the static shadow cache!");
+        cache.reset();
+    }
+    return isFine;
+}
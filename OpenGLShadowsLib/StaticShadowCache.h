@@ -0,0 +1,33 @@
+#pragma once
+
+#include "GLShader.h"
+#include "Scene.h"
+#include "Framebuffer.h"
+
+#include <memory>
+
+namespace shadow
+{
+    // keeps the shadow map of the static casters of one light, which is only redrawn when the light space or the map changes, or when it is invalidated;
+    // every frame it is copied into the shadow map and the dynamic casters are drawn on top of it
+    class StaticShadowCache final
+    {
+    public:
+        StaticShadowCache() = default;
+        ~StaticShadowCache() = default;
+        StaticShadowCache(StaticShadowCache&) = delete;
+        StaticShadowCache(StaticShadowCache&&) = delete;
+        StaticShadowCache& operator=(StaticShadowCache&) = delete;
+        StaticShadowCache& operator=(StaticShadowCache&&) = delete;
+        void invalidate();
+        // colorFormat is GL_NONE for depth maps, otherwise the format of the moments that are copied along with the depth
+        void update(Scene& scene, std::shared_ptr<GLShader> depthShader, GLuint fbo, GLsizei textureSize, GLenum colorFormat, const glm::vec4& clearColor, const glm::mat4& lightSpace);
+    private:
+        bool createCache(GLsizei textureSize, GLenum colorFormat);
+        std::unique_ptr<Framebuffer> cache{};
+        bool valid{};
+        GLsizei lastTextureSize{};
+        GLenum lastColorFormat{ GL_NONE };
+        glm::mat4 lastLightSpace{};
+    };
+}
@@ -7,6 +7,10 @@ shadow::TextureMesh::TextureMesh(const std::vector<TextureVertex>& vertices, con
                                  std::map<TextureType, std::shared_ptr<Texture>> textures)
     : textures(std::move(textures)), indexCount(static_cast<GLsizei>(indices.size()))
 {
+    for (const TextureVertex& vertex : vertices)
+    {
+        bounds.extend(vertex.position);
+    }
     glGenVertexArrays(1, &vao);
     glGenBuffers(1, &vbo);
     glGenBuffers(1, &ebo);
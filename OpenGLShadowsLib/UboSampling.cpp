@@ -0,0 +1,76 @@
+#include "UboSampling.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+shadow::UboSampling::UboSampling() : UniformBufferObject("Sampling", 4)
+{
+    set(data);
+}
+
+void shadow::UboSampling::setVogelDisks(unsigned int shadowSamples, unsigned int penumbraSamples)
+{
+    assert(shadowSamples && shadowSamples <= MAX_VOGEL_SAMPLES);
+    assert(penumbraSamples && penumbraSamples <= MAX_VOGEL_SAMPLES);
+    const float shadowSqrt = std::sqrt(static_cast<float>(shadowSamples)), penumbraSqrt = std::sqrt(static_cast<float>(penumbraSamples));
+    for (unsigned int i = 0U; i < MAX_VOGEL_SAMPLES; ++i)
+    {
+        const float radius = std::sqrt(static_cast<float>(i) + 0.5f), angle = static_cast<float>(i) * 2.4f;
+        data.vogelDisks[i] = glm::vec4(radius / shadowSqrt, angle, radius / penumbraSqrt, angle);
+    }
+    data.sampleCounts.x = static_cast<int>(shadowSamples);
+    data.sampleCounts.y = static_cast<int>(penumbraSamples);
+    bufferSubData(data.vogelDisks, sizeof(data.vogelDisks), offsetof(UboSamplingStruct, vogelDisks));
+    bufferSubData(value_ptr(data.sampleCounts), sizeof(glm::ivec4), offsetof(UboSamplingStruct, sampleCounts));
+}
+
+void shadow::UboSampling::setPoissonSamples(unsigned int blockerSamples, unsigned int filterSamples)
+{
+    assert(blockerSamples && blockerSamples <= MAX_POISSON_SAMPLES);
+    assert(filterSamples && filterSamples <= MAX_POISSON_SAMPLES);
+    data.sampleCounts.z = static_cast<int>(blockerSamples);
+    data.sampleCounts.w = static_cast<int>(filterSamples);
+    bufferSubData(value_ptr(data.sampleCounts), sizeof(glm::ivec4), offsetof(UboSamplingStruct, sampleCounts));
+}
+
+void shadow::UboSampling::setFilterSize(unsigned int filterSize)
+{
+    assert(filterSize % 2U == 1U && filterSize <= MAX_FILTER_SIZE);
+    data.filterSize.x = static_cast<int>(filterSize);
+    bufferSubData(value_ptr(data.filterSize), sizeof(glm::ivec4), offsetof(UboSamplingStruct, filterSize));
+}
+
+void shadow::UboSampling::setNoiseOffset(glm::ivec2 noiseOffset)
+{
+    if (glm::ivec2(data.noiseOffset) == noiseOffset)
+    {
+        return;
+    }
+    data.noiseOffset = glm::ivec4(noiseOffset, 0, 0);
+    bufferSubData(value_ptr(data.noiseOffset), sizeof(glm::ivec4), offsetof(UboSamplingStruct, noiseOffset));
+}
+
+void shadow::UboSampling::setAdaptiveSampling(unsigned int earlyOutSamples, float samplesPerTexel)
+{
+    assert(earlyOutSamples <= MAX_VOGEL_SAMPLES && samplesPerTexel >= 0.0f);
+    data.adaptiveSampling.x = static_cast<float>(earlyOutSamples);
+    data.adaptiveSampling.y = samplesPerTexel;
+    bufferSubData(value_ptr(data.adaptiveSampling), sizeof(glm::vec4), offsetof(UboSamplingStruct, adaptiveSampling));
+}
+
+void shadow::UboSampling::setShadowTileSize(unsigned int tileSize)
+{
+    data.shadowTileSize.x = static_cast<int>(tileSize);
+    bufferSubData(value_ptr(data.shadowTileSize), sizeof(glm::ivec4), offsetof(UboSamplingStruct, shadowTileSize));
+}
+
+void shadow::UboSampling::setDeferredShadows(bool deferredShadows)
+{
+    data.deferredShadows.x = deferredShadows ? 1 : 0;
+    bufferSubData(value_ptr(data.deferredShadows), sizeof(glm::ivec4), offsetof(UboSamplingStruct, deferredShadows));
+}
+
+void shadow::UboSampling::setContactShadows(bool contactShadows)
+{
+    data.contactShadows.x = contactShadows ? 1 : 0;
+    bufferSubData(value_ptr(data.contactShadows), sizeof(glm::ivec4), offsetof(UboSamplingStruct, contactShadows));
+}
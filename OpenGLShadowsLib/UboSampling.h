@@ -0,0 +1,42 @@
+#pragma once
+
+#include "UniformBufferObject.h"
+
+#include <glm/glm.hpp>
+
+namespace shadow
+{
+    // array sizes have to match UboSampling.glsl
+    constexpr unsigned int MAX_VOGEL_SAMPLES{ 64U };
+    constexpr unsigned int MAX_POISSON_SAMPLES{ 32U };
+    constexpr unsigned int MAX_FILTER_SIZE{ 31U };
+
+    struct UboSamplingStruct
+    {
+        glm::vec4 vogelDisks[MAX_VOGEL_SAMPLES]{}; // shadow disk (radius, angle) in xy, penumbra disk in zw
+        glm::ivec4 sampleCounts{}; // Vogel shadow and penumbra samples, PCSS blocker and filter samples
+        glm::ivec4 filterSize{}; // PCF filter width in x
+        glm::ivec4 noiseOffset{}; // blue noise tile offset in xy
+        glm::vec4 adaptiveSampling{}; // early-out ring samples in x, samples per covered shadow map texel in y, zero disables either
+        glm::ivec4 shadowTileSize{}; // screen tile size in x when the shadow tile classification is used, 0 otherwise
+        glm::ivec4 deferredShadows{}; // 1 in x when the shading reads the deferred shadow mask
+        glm::ivec4 contactShadows{}; // 1 in x when the shading combines the screen-space contact shadows
+    };
+
+    // sampling kernels read by the shadow shaders, changing them requires no shader rebuild
+    class UboSampling final : public UniformBufferObject<UboSamplingStruct>
+    {
+    public:
+        UboSampling();
+        void setVogelDisks(unsigned int shadowSamples, unsigned int penumbraSamples);
+        void setPoissonSamples(unsigned int blockerSamples, unsigned int filterSamples);
+        void setFilterSize(unsigned int filterSize);
+        void setNoiseOffset(glm::ivec2 noiseOffset);
+        void setAdaptiveSampling(unsigned int earlyOutSamples, float samplesPerTexel);
+        void setShadowTileSize(unsigned int tileSize);
+        void setDeferredShadows(bool deferredShadows);
+        void setContactShadows(bool contactShadows);
+    private:
+        UboSamplingStruct data{};
+    };
+}
@@ -0,0 +1,243 @@
+#include "VirtualShadowMap.h"
+
+#include <glm/gtx/transform.hpp>
+#include <algorithm>
+
+shadow::VirtualShadowMap::~VirtualShadowMap()
+{
+    if (pageTable)
+    {
+        glDeleteTextures(1, &pageTable);
+    }
+}
+
+bool shadow::VirtualShadowMap::initialize(std::shared_ptr<GLShader> depthShader, std::shared_ptr<GLShader> markingShader, GLsizei pageSize, unsigned int virtualPages, unsigned int poolPages)
+{
+    if (!depthShader || !markingShader)
+    {
+        SHADOW_ERROR("Virtual shadow map requires a depth shader and a page marking shader!");
+        return false;
+    }
+    if (pageSize <= 0 || virtualPages == 0U || poolPages == 0U)
+    {
+        SHADOW_ERROR("Invalid virtual shadow map configuration ({} px pages, {}x{} virtual pages, {}x{} pool pages)!", pageSize, virtualPages, virtualPages, poolPages, poolPages);
+        return false;
+    }
+    GLint maxTextureSize;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+    if (pageSize * static_cast<GLsizei>(poolPages) > maxTextureSize)
+    {
+        SHADOW_ERROR("Virtual shadow map page pool ({} px) exceeds the maximum texture size ({} px)!", pageSize * poolPages, maxTextureSize);
+        return false;
+    }
+    SHADOW_DEBUG("Creating a {}x{} virtual shadow map with {}x{} physical pages...", pageSize * virtualPages, pageSize * virtualPages, poolPages, poolPages);
+    this->depthShader = depthShader;
+    this->markingShader = markingShader;
+    this->pageSize = pageSize;
+    this->virtualPages = virtualPages;
+    this->poolPages = poolPages;
+    const GLsizei poolSize = pageSize * static_cast<GLsizei>(poolPages);
+    if (!pool.initialize(false, GL_DEPTH_ATTACHMENT, GL_DEPTH_COMPONENT,
+        poolSize, poolSize, GL_DEPTH_COMPONENT, GL_FLOAT, GL_NEAREST, GL_CLAMP_TO_BORDER, glm::vec4(1.0f)))
+    {
+        return false;
+    }
+    const size_t pageCount = static_cast<size_t>(virtualPages) * virtualPages;
+    if (!readback.initialize(static_cast<GLsizeiptr>(pageCount * sizeof(GLuint))))
+    {
+        return false;
+    }
+    pageTableData.assign(pageCount, 0U);
+    requests.assign(pageCount, 0U);
+    neededPages.assign(pageCount, false);
+    slots.assign(static_cast<size_t>(poolPages) * poolPages, PageSlot{});
+    glGenTextures(1, &pageTable);
+    glBindTexture(GL_TEXTURE_2D, pageTable);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, virtualPages, virtualPages, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, pageTableData.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return true;
+}
+
+void shadow::VirtualShadowMap::invalidate()
+{
+    for (PageSlot& slot : slots)
+    {
+        slot = PageSlot{};
+    }
+    std::fill(pageTableData.begin(), pageTableData.end(), 0U);
+    pageTableDirty = true;
+    poolExhaustedReported = false;
+}
+
+void shadow::VirtualShadowMap::update(Scene& scene, const glm::mat4& lightSpace)
+{
+    assert(pageTable);
+    ++frame;
+    renderedPages = 0U;
+    if (lightSpace != lastLightSpace)
+    {
+        // every cached page was rendered with a different projection
+        invalidate();
+        lastLightSpace = lightSpace;
+    }
+    for (const BoundingBox& bounds : changeTracker.update(scene))
+    {
+        invalidateBounds(bounds, lightSpace);
+    }
+    if (readback.readLatest(requests.data()))
+    {
+        // dilated by a page so that filter kernels and small camera moves do not reach missing pages
+        std::fill(neededPages.begin(), neededPages.end(), false);
+        const int pages = static_cast<int>(virtualPages);
+        for (int y = 0; y < pages; ++y)
+        {
+            for (int x = 0; x < pages; ++x)
+            {
+                if (requests[y * pages + x])
+                {
+                    for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, pages - 1); ++ny)
+                    {
+                        for (int nx = std::max(x - 1, 0); nx <= std::min(x + 1, pages - 1); ++nx)
+                        {
+                            neededPages[ny * pages + nx] = true;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    for (unsigned int page = 0U; page < neededPages.size(); ++page)
+    {
+        if (neededPages[page] && pageTableData[page])
+        {
+            slots[pageTableData[page] - 1U].lastUsedFrame = frame;
+        }
+    }
+    for (unsigned int page = 0U; page < neededPages.size(); ++page)
+    {
+        if (neededPages[page] && !pageTableData[page] && !allocatePage(page))
+        {
+            break;
+        }
+    }
+    if (pageTableDirty)
+    {
+        glBindTexture(GL_TEXTURE_2D, pageTable);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, virtualPages, virtualPages, GL_RED_INTEGER, GL_UNSIGNED_INT, pageTableData.data());
+        glBindTexture(GL_TEXTURE_2D, 0);
+        pageTableDirty = false;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, pool.getFbo());
+    glEnable(GL_SCISSOR_TEST);
+    depthShader->use();
+    for (unsigned int i = 0U; i < slots.size(); ++i)
+    {
+        PageSlot& slot = slots[i];
+        if (slot.resident && slot.dirty && neededPages[slot.page])
+        {
+            renderPage(scene, slot, i, lightSpace);
+            slot.dirty = false;
+            ++renderedPages;
+        }
+    }
+    glDisable(GL_SCISSOR_TEST);
+}
+
+void shadow::VirtualShadowMap::markPages(GLuint depthTexture, GLsizei width, GLsizei height, const glm::mat4& inverseViewProjection, const glm::mat4& lightSpace)
+{
+    assert(markingShader);
+    std::fill(requests.begin(), requests.end(), 0U);
+    readback.bindForWrite(BUFFER_BINDING, requests.data());
+    markingShader->use();
+    markingShader->setMat4("inverseViewProjection", inverseViewProjection);
+    markingShader->setMat4("lightSpace", lightSpace);
+    markingShader->setInt("virtualPages", static_cast<int>(virtualPages));
+    glActiveTexture(GL_TEXTURE14);
+    glBindTexture(GL_TEXTURE_2D, depthTexture);
+    glDispatchCompute((width + LOCAL_SIZE - 1U) / LOCAL_SIZE, (height + LOCAL_SIZE - 1U) / LOCAL_SIZE, 1U);
+    glActiveTexture(GL_TEXTURE0);
+    readback.finishWrite();
+}
+
+void shadow::VirtualShadowMap::invalidateBounds(const BoundingBox& bounds, const glm::mat4& lightSpace)
+{
+    BoundingBox lightBounds = bounds.transformed(lightSpace);
+    if (!lightBounds.isValid())
+    {
+        return;
+    }
+    const float pages = static_cast<float>(virtualPages);
+    glm::ivec2 minPage(glm::floor((glm::vec2(lightBounds.min) * 0.5f + 0.5f) * pages));
+    glm::ivec2 maxPage(glm::floor((glm::vec2(lightBounds.max) * 0.5f + 0.5f) * pages));
+    minPage = glm::max(minPage, glm::ivec2(0));
+    maxPage = glm::min(maxPage, glm::ivec2(static_cast<int>(virtualPages) - 1));
+    for (int y = minPage.y; y <= maxPage.y; ++y)
+    {
+        for (int x = minPage.x; x <= maxPage.x; ++x)
+        {
+            GLuint entry = pageTableData[y * virtualPages + x];
+            if (entry)
+            {
+                slots[entry - 1U].dirty = true;
+            }
+        }
+    }
+}
+
+bool shadow::VirtualShadowMap::allocatePage(unsigned int page)
+{
+    // free slots go first, otherwise the least recently used page that is not needed this frame gets evicted
+    size_t target = slots.size();
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        if (!slots[i].resident)
+        {
+            target = i;
+            break;
+        }
+        if (slots[i].lastUsedFrame < frame && (target == slots.size() || slots[i].lastUsedFrame < slots[target].lastUsedFrame))
+        {
+            target = i;
+        }
+    }
+    if (target == slots.size())
+    {
+        if (!poolExhaustedReported)
+        {
+            SHADOW_WARN("Virtual shadow map page pool ({} pages) is too small for the visible area!", slots.size());
+            poolExhaustedReported = true;
+        }
+        return false;
+    }
+    PageSlot& slot = slots[target];
+    if (slot.resident)
+    {
+        pageTableData[slot.page] = 0U;
+    }
+    slot.page = page;
+    slot.lastUsedFrame = frame;
+    slot.resident = true;
+    slot.dirty = true;
+    pageTableData[page] = static_cast<GLuint>(target + 1U);
+    pageTableDirty = true;
+    return true;
+}
+
+void shadow::VirtualShadowMap::renderPage(Scene& scene, const PageSlot& slot, unsigned int slotIndex, const glm::mat4& lightSpace) const
+{
+    const GLint x = static_cast<GLint>(slotIndex % poolPages) * pageSize;
+    const GLint y = static_cast<GLint>(slotIndex / poolPages) * pageSize;
+    glViewport(x, y, pageSize, pageSize);
+    glScissor(x, y, pageSize, pageSize);
+    glClear(GL_DEPTH_BUFFER_BIT);
+    // crops the light projection so that the page fills the whole viewport
+    const float pages = static_cast<float>(virtualPages);
+    glm::vec2 center = (glm::vec2(slot.page % virtualPages, slot.page / virtualPages) + 0.5f) / pages * 2.0f - 1.0f;
+    glm::mat4 pageProjection = glm::scale(glm::vec3(pages, pages, 1.0f)) * glm::translate(glm::vec3(-center, 0.0f)) * lightSpace;
+    depthShader->setMat4("pageProjection", pageProjection);
+    scene.render(depthShader, pageProjection);
+}
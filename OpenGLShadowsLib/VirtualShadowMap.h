@@ -0,0 +1,86 @@
+#pragma once
+
+#include "GLShader.h"
+#include "Framebuffer.h"
+#include "ReadbackBuffer.h"
+#include "SceneChangeTracker.h"
+
+#include <memory>
+#include <vector>
+
+namespace shadow
+{
+    // a large directional shadow map split into pages, only the pages seen by the camera are kept in a physical pool
+    // and they are rendered again only when the light or the casters covering them change
+    class VirtualShadowMap final
+    {
+    public:
+        VirtualShadowMap() = default;
+        ~VirtualShadowMap();
+        VirtualShadowMap(VirtualShadowMap&) = delete;
+        VirtualShadowMap(VirtualShadowMap&&) = delete;
+        VirtualShadowMap& operator=(VirtualShadowMap&) = delete;
+        VirtualShadowMap& operator=(VirtualShadowMap&&) = delete;
+        bool initialize(std::shared_ptr<GLShader> depthShader, std::shared_ptr<GLShader> markingShader, GLsizei pageSize, unsigned int virtualPages, unsigned int poolPages);
+        void invalidate();
+        void update(Scene& scene, const glm::mat4& lightSpace);
+        void markPages(GLuint depthTexture, GLsizei width, GLsizei height, const glm::mat4& inverseViewProjection, const glm::mat4& lightSpace);
+        inline GLuint getTexture() const;
+        inline GLuint getPageTable() const;
+        inline unsigned int getVirtualPages() const;
+        inline unsigned int getPoolPages() const;
+        inline unsigned int getRenderedPages() const;
+    private:
+        struct PageSlot final
+        {
+            unsigned int page{};
+            unsigned long long lastUsedFrame{};
+            bool resident{}, dirty{};
+        };
+        static constexpr GLuint BUFFER_BINDING{ 0U };
+        static constexpr GLuint LOCAL_SIZE{ 16U };
+        void invalidateBounds(const BoundingBox& bounds, const glm::mat4& lightSpace);
+        bool allocatePage(unsigned int page);
+        void renderPage(Scene& scene, const PageSlot& slot, unsigned int slotIndex, const glm::mat4& lightSpace) const;
+        std::shared_ptr<GLShader> depthShader{}, markingShader{};
+        Framebuffer pool{};
+        ReadbackBuffer readback{};
+        SceneChangeTracker changeTracker{};
+        GLuint pageTable{};
+        GLsizei pageSize{};
+        unsigned int virtualPages{}, poolPages{}, renderedPages{};
+        unsigned long long frame{};
+        bool pageTableDirty{}, poolExhaustedReported{};
+        glm::mat4 lastLightSpace{};
+        std::vector<GLuint> pageTableData{}; // slot index + 1 for resident pages, 0 otherwise
+        std::vector<GLuint> requests{};
+        std::vector<bool> neededPages{};
+        std::vector<PageSlot> slots{};
+    };
+
+    inline GLuint VirtualShadowMap::getTexture() const
+    {
+        return pool.getTexture();
+    }
+
+    inline GLuint VirtualShadowMap::getPageTable() const
+    {
+        assert(pageTable);
+        return pageTable;
+    }
+
+    inline unsigned int VirtualShadowMap::getVirtualPages() const
+    {
+        return virtualPages;
+    }
+
+    inline unsigned int VirtualShadowMap::getPoolPages() const
+    {
+        return poolPages;
+    }
+
+    inline unsigned int VirtualShadowMap::getRenderedPages() const
+    {
+        return renderedPages;
+    }
+}
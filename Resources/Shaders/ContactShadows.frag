@@ -0,0 +1,88 @@
+#version 430 core
+
+//SHADOW>include UboMvp.glsl
+
+//SHADOW>include LightStructs.glsl
+
+//SHADOW>include UboLights.glsl
+
+//SHADOW>include UboWindow.glsl
+
+//SHADOW>include UboSampling.glsl
+
+layout(binding = 14) uniform sampler2D depthTexture;
+layout(binding = 18) uniform sampler2D blueNoise;
+uniform mat4 inverseViewProjection;
+uniform float rayLength; // world space distance marched toward the light
+uniform float thickness; // view depth an occluder is assumed to extend behind its visible surface
+
+in VS_OUT
+{
+    vec2 texCoords;
+} fs_in;
+
+out vec4 outColor;
+
+const int CONTACT_SHADOW_STEPS = 16;
+
+float linearizeDepth(float depth)
+{
+    return projection[3][2] / (depth * 2.0 - 1.0 + projection[2][2]);
+}
+
+// the same blue noise tile as the shadow kernel rotation, so the animated offset decorrelates the steps over frames too
+float stepJitter()
+{
+    ivec2 noiseSize = textureSize(blueNoise, 0);
+    return texelFetch(blueNoise, (ivec2(gl_FragCoord.xy) + noiseOffset.xy) % noiseSize, 0).r;
+}
+
+// Marches the camera depth from the receiver toward the light and reports the first step hidden behind a surface.
+// The occlusion fades along the ray so that the cut-off at its end does not show.
+float traceContactShadow(vec3 pos, vec3 L, float maxDistance, float jitter)
+{
+    float stepLength = min(rayLength, maxDistance) / float(CONTACT_SHADOW_STEPS);
+    for(int i = 0; i < CONTACT_SHADOW_STEPS; ++i)
+    {
+        float t = float(i) + jitter;
+        vec4 clip = projection * view * vec4(pos + L * stepLength * t, 1.0);
+        vec2 ndc = clip.xy / clip.w;
+        if(clip.w <= 0.0 || any(greaterThan(abs(ndc), vec2(1.0))))
+        {
+            break; // the ray has left the screen, the shadow map has to cover the rest
+        }
+        float sceneDepth = linearizeDepth(texelFetch(depthTexture, ivec2((ndc * 0.5 + 0.5) * windowSize), 0).r);
+        float delta = clip.w - sceneDepth;
+        // the relative bias keeps the depth buffer precision from shadowing the receiver itself
+        if(delta > clip.w * 0.001 && delta < thickness)
+        {
+            return 1.0 - t / float(CONTACT_SHADOW_STEPS);
+        }
+    }
+    return 0.0;
+}
+
+void main()
+{
+    float depth = texelFetch(depthTexture, ivec2(gl_FragCoord.xy), 0).r;
+    if(depth == 1.0)
+    {
+        outColor = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+    vec4 ndc = vec4(gl_FragCoord.xy / windowSize * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+    vec4 world = inverseViewProjection * ndc;
+    vec3 pos = world.xyz / world.w;
+    float jitter = stepJitter();
+    float dirShadow = 0.0, spotShadow = 0.0;
+    if(dirLightData.strength != 0.0)
+    {
+        dirShadow = traceContactShadow(pos, normalize(-dirLightData.direction), rayLength, jitter);
+    }
+    if(spotLightData.strength != 0.0)
+    {
+        vec3 toLight = spotLightData.position - pos;
+        spotShadow = traceContactShadow(pos, normalize(toLight), length(toLight), jitter);
+    }
+    outColor = vec4(dirShadow, spotShadow, 0.0, 1.0);
+}
@@ -0,0 +1,188 @@
+#version 430 core
+
+//SHADOW>include UboMvp.glsl
+
+//SHADOW>include LightStructs.glsl
+
+//SHADOW>include UboLights.glsl
+
+//SHADOW>include ShadowVariants.glsl
+
+#if SHADOW_MASTER || SHADOW_CHSS
+layout(binding = 10) uniform sampler2D directionalShadow;
+layout(binding = 11) uniform sampler2D directionalPenumbra;
+layout(binding = 12) uniform sampler2D spotShadow;
+layout(binding = 13) uniform sampler2D spotPenumbra;
+#else
+layout(binding = 10) uniform sampler2D directionalShadow;
+layout(binding = 11) uniform sampler2D spotShadow;
+#endif
+
+layout(binding = 0) uniform sampler2D gAlbedoMetalness;
+layout(binding = 1) uniform sampler2D gNormalRoughness;
+layout(binding = 2) uniform sampler2D gGeometricNormal;
+layout(binding = 14) uniform sampler2D depthTexture;
+uniform mat4 inverseViewProjection;
+
+in VS_OUT
+{
+    vec2 texCoords;
+} fs_in;
+
+out vec4 outColor;
+
+// the full-screen quad has no perspective, the penumbra upsampling uses the reconstructed view depth instead
+float receiverViewDepth;
+#define VIEW_DEPTH receiverViewDepth
+
+//SHADOW>include PBRFunctions.glsl
+
+//SHADOW>include ShadowCalculations.glsl
+
+//SHADOW>include LightClusters.glsl
+
+//SHADOW>include GBuffer.glsl
+
+struct Surface
+{
+    vec3 pos;
+    vec3 N;
+    vec3 geometricN;
+    vec3 V;
+    float NdotV;
+    vec3 F0;
+    vec3 albedo;
+    float roughness;
+    float metallic;
+};
+
+vec3 getRadiance(Surface s, vec3 L, float NdotL)
+{
+    vec3 H = normalize(s.V + L);
+    float cosTheta = clamp(dot(H, s.V), 0.0, 1.0);
+    vec3 F = fresnelSchlick(cosTheta, s.F0);
+    float D = DistributionGGX(s.N, H, s.roughness);
+    float G = GeometrySmith(s.N, s.V, L, s.roughness);
+    vec3 specular = (F*D*G) / max(4.0 * s.NdotV * NdotL, 0.00001);
+    vec3 kD = (vec3(1.0) - specular) * (1.0 - s.metallic);
+    vec3 diffuse = kD * s.albedo / PI;
+    return (diffuse + specular) * NdotL;
+}
+
+vec3 getDirectionalLightColor(Surface s)
+{
+    if(dirLightData.strength == 0.0)
+    {
+        return vec3(0.0);
+    }
+    vec3 L = normalize(-dirLightData.direction);
+    float NdotL = max(dot(s.N, L), 0.0);
+    float geometricNdotL = max(dot(s.geometricN, L), 0.0);
+    float shadow;
+    if(isShadowMaskUsed())
+    {
+        shadow = readShadowMask(MASK_DIRECTIONAL);
+    }
+    else
+    {
+        vec4 dirSpacePos = dirLightData.lightSpace * vec4(s.pos, 1.0);
+#if SHADOW_MASTER || SHADOW_CHSS
+        shadow = isPenumbraTile(TILE_DIRECTIONAL) ? calcShadow(geometricNdotL, dirSpacePos, dirLightData.nearZ, dirLightData.lightSize, directionalShadow, directionalPenumbra, s.geometricN, DIR_SHADOW_PAGED) : calcHardShadow(dirSpacePos, directionalShadow, DIR_SHADOW_PAGED);
+#elif SHADOW_PCSS
+        shadow = isPenumbraTile(TILE_DIRECTIONAL) ? calcShadow(geometricNdotL, dirSpacePos, dirLightData.nearZ, dirLightData.lightSize, directionalShadow, directionalDepthPyramid, DIR_SHADOW_PAGED) : calcHardShadow(dirSpacePos, directionalShadow, DIR_SHADOW_PAGED);
+#elif SHADOW_FILTERABLE
+        shadow = calcShadow(dirSpacePos, directionalShadow);
+#else
+        shadow = calcShadow(geometricNdotL, dirSpacePos, directionalShadow, DIR_SHADOW_PAGED);
+#endif
+    }
+    shadow = applyContactShadow(shadow, MASK_DIRECTIONAL);
+    return getRadiance(s, L, NdotL) * dirLightData.color * dirLightData.strength * (1.0 - shadow);
+}
+
+vec3 getSpotLightColor(Surface s, uint cluster)
+{
+    if(spotLightData.strength == 0.0 || !isSpotLightInCluster(cluster))
+    {
+        return vec3(0.0);
+    }
+    vec3 toLight = spotLightData.position - s.pos;
+    float dist = length(toLight);
+    vec3 L = toLight / dist;
+    float NdotL = max(dot(s.N, L), 0.0);
+    float geometricNdotL = max(dot(s.geometricN, L), 0.0);
+    float shadow;
+    if(isShadowMaskUsed())
+    {
+        shadow = readShadowMask(MASK_SPOT);
+    }
+    else
+    {
+        vec4 spotSpacePos = spotLightData.lightSpace * vec4(s.pos, 1.0);
+#if SHADOW_MASTER || SHADOW_CHSS
+        shadow = isPenumbraTile(TILE_SPOT) ? calcShadow(geometricNdotL, spotSpacePos, spotLightData.nearZ, spotLightData.lightSize, spotShadow, spotPenumbra, s.geometricN, false) : calcHardShadow(spotSpacePos, spotShadow, false);
+#elif SHADOW_PCSS
+        shadow = isPenumbraTile(TILE_SPOT) ? calcShadow(geometricNdotL, spotSpacePos, spotLightData.nearZ, spotLightData.lightSize, spotShadow, spotDepthPyramid, false) : calcHardShadow(spotSpacePos, spotShadow, false);
+#elif SHADOW_FILTERABLE
+        shadow = calcShadow(spotSpacePos, spotShadow);
+#else
+        shadow = calcShadow(geometricNdotL, spotSpacePos, spotShadow, false);
+#endif
+    }
+    shadow = applyContactShadow(shadow, MASK_SPOT);
+    float theta = dot(L, normalize(-spotLightData.direction));
+    float epsilon = spotLightData.innerCutOff - spotLightData.outerCutOff;
+    float intensity = clamp((theta - spotLightData.outerCutOff) / epsilon, 0.0, 1.0);
+    float attenuation = 1.0 / (dist * dist);
+    return getRadiance(s, L, NdotL) * spotLightData.color * spotLightData.strength * attenuation * intensity * (1.0 - shadow);
+}
+
+vec3 getPointLightsColor(Surface s, uint cluster)
+{
+    vec3 result = vec3(0.0);
+    uint lightCount = getClusterLightCount(cluster);
+    for(uint i = 0u; i < lightCount; ++i)
+    {
+        PointLightData light = getClusterPointLight(cluster, i);
+        vec3 toLight = light.position - s.pos;
+        float dist = length(toLight);
+        vec3 L = toLight / dist;
+        float NdotL = max(dot(s.N, L), 0.0);
+        result += getRadiance(s, L, NdotL) * light.color * light.strength * getPointLightAttenuation(dist, light.radius);
+    }
+    return result;
+}
+
+void main()
+{
+    ivec2 texel = ivec2(gl_FragCoord.xy);
+    float depth = texelFetch(depthTexture, texel, 0).r;
+    if(depth == 1.0)
+    {
+        discard; // keeps the clear color of the background
+    }
+    vec4 ndc = vec4(gl_FragCoord.xy / windowSize * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+    vec4 world = inverseViewProjection * ndc;
+    receiverViewDepth = 1.0 / world.w;
+    vec4 albedoMetalness = texelFetch(gAlbedoMetalness, texel, 0);
+    vec4 normalRoughness = texelFetch(gNormalRoughness, texel, 0);
+    Surface s;
+    s.pos = world.xyz / world.w;
+    s.N = decodeGBufferNormal(normalRoughness.xy);
+    // like the forward path, the shadows are biased along the interpolated normal rather than the normal-mapped one
+    s.geometricN = decodeGBufferNormal(texelFetch(gGeometricNormal, texel, 0).rg);
+    s.V = normalize(viewPosition - s.pos);
+    s.NdotV = max(dot(s.N, s.V), 0.0);
+    s.albedo = albedoMetalness.rgb;
+    s.metallic = albedoMetalness.a;
+    s.roughness = normalRoughness.z;
+    s.F0 = mix(vec3(0.04), s.albedo, s.metallic);
+    // every pixel is lit once, however many fragments the G-buffer pass has overdrawn
+    uint cluster = getFragmentCluster(gl_FragCoord.xy, receiverViewDepth);
+    vec3 Lo =
+        s.albedo * ambient
+        + max(getDirectionalLightColor(s), vec3(0.0))
+        + max(getSpotLightColor(s, cluster), vec3(0.0))
+        + max(getPointLightsColor(s, cluster), vec3(0.0));
+    outColor = vec4(Lo, 1.0);
+}
@@ -1,6 +1,6 @@
 #version 430 core
 
+// depth only, leaving gl_FragDepth alone keeps early depth testing enabled
 void main()
 {
-    gl_FragDepth = gl_FragCoord.z; // it's default actually
 }
\ No newline at end of file
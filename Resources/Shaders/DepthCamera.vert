@@ -0,0 +1,13 @@
+#version 430 core
+layout (location = 0) in vec3 pos;
+
+//SHADOW>include UboMvp.glsl
+
+// computed exactly like the main pass vertex shaders, so that it can reuse the prepass depth
+invariant gl_Position;
+
+void main()
+{
+    vec3 worldPos = vec3(model * vec4(pos, 1.0));
+    gl_Position = projection * view * vec4(worldPos, 1.0);
+}
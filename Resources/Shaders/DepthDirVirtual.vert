@@ -0,0 +1,12 @@
+#version 430 core
+layout (location = 0) in vec3 pos;
+
+//SHADOW>include UboMvp.glsl
+
+// light space cropped to the rendered page
+uniform mat4 pageProjection;
+
+void main()
+{
+    gl_Position = pageProjection * model * vec4(pos, 1.0);
+}
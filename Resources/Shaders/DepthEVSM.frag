@@ -0,0 +1,13 @@
+#version 430 core
+
+//SHADOW>include EVSM
+
+out vec4 outColor;
+
+void main()
+{
+    float depth = 2.0 * gl_FragCoord.z - 1.0;
+    float positive = exp(EVSM_POSITIVE_EXPONENT * depth);
+    float negative = -exp(-EVSM_NEGATIVE_EXPONENT * depth);
+    outColor = vec4(positive, positive * positive, negative, negative * negative);
+}
@@ -0,0 +1,27 @@
+#version 430 core
+
+//SHADOW>include SHADOW_MAP_FORMAT
+
+out vec4 outColor;
+
+#if MSM_QUANTIZED
+// 16-bit moments lose too much precision as they are, so they are stored in the optimized basis of the moment shadow mapping paper
+const mat4 MSM_QUANTIZATION = mat4(
+    -2.07224649, 13.7948857237, 0.105877704, 9.7924062118,
+    32.23703778, -59.4683975703, -1.9077466311, -33.7652110555,
+    -68.571074599, 82.0359750338, 9.3496555107, 47.9456096605,
+    39.3703274134, -35.364903257, -6.6543490743, -23.9728048165);
+#endif
+
+void main()
+{
+    float depth = gl_FragCoord.z;
+    float square = depth * depth;
+    vec4 moments = vec4(depth, square, square * depth, square * square);
+#if MSM_QUANTIZED
+    outColor = MSM_QUANTIZATION * moments;
+    outColor.x += 0.035955884801;
+#else
+    outColor = moments;
+#endif
+}
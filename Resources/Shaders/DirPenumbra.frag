@@ -8,14 +8,19 @@ layout(binding = 10) uniform sampler2D directionalShadow;
 
 in VS_OUT
 {
+    vec3 normal;
     vec4 dirSpacePos;
 } fs_in;
 
-out float outColor;
+out vec4 outColor;
 
 //SHADOW>include ShadowCalculations.glsl
 
 void main()
 {
-    outColor = calcPenumbra(fs_in.dirSpacePos, dirLightData.nearZ, dirLightData.lightSize, directionalShadow);
+#if SHADOW_MASTER || SHADOW_CHSS
+    outColor = packPenumbra(calcPenumbra(fs_in.dirSpacePos, dirLightData.nearZ, dirLightData.lightSize, directionalShadow, directionalDepthPyramid, DIR_SHADOW_PAGED), fs_in.normal);
+#else
+    outColor = vec4(0.0); // compiled for every technique, but only rendered by the penumbra based ones
+#endif
 }
@@ -0,0 +1,30 @@
+// the G-buffer of the deferred path:
+// 0 - RGBA8: albedo, metalness
+// 1 - RGB10_A2: octahedral world space normal, roughness
+// 2 - RG16: octahedral world space geometric normal, the shadow bias and the penumbra upsampling ignore the normal map
+// the depth is shared with the main framebuffer
+
+vec2 signNotZero(vec2 v)
+{
+    return vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+// folds the unit sphere onto a square biased to [0, 1] for the unsigned normal target (the penumbra maps keep their own
+// signed pair), at 10 bits per component the error stays below a quarter of a degree
+vec2 encodeGBufferNormal(vec3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    vec2 e = n.z >= 0.0 ? n.xy : (1.0 - abs(n.yx)) * signNotZero(n.xy);
+    return e * 0.5 + 0.5;
+}
+
+vec3 decodeGBufferNormal(vec2 e)
+{
+    e = e * 2.0 - 1.0;
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if(n.z < 0.0)
+    {
+        n.xy = (1.0 - abs(n.yx)) * signNotZero(n.xy);
+    }
+    return normalize(n);
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#version 430 core
+
+//SHADOW>include UboMaterial.glsl
+
+in VS_OUT
+{
+    vec3 pos;
+    vec3 normal;
+    vec3 viewPosition;
+    vec3 toView;
+    vec4 dirSpacePos;
+    vec4 spotSpacePos;
+} fs_in;
+
+layout(location = 0) out vec4 outAlbedoMetalness;
+layout(location = 1) out vec4 outNormalRoughness;
+layout(location = 2) out vec2 outGeometricNormal;
+
+//SHADOW>include GBuffer.glsl
+
+void main()
+{
+    outAlbedoMetalness = vec4(albedo, metallic);
+    outNormalRoughness = vec4(encodeGBufferNormal(normalize(fs_in.normal)), roughness, 1.0);
+    outGeometricNormal = encodeGBufferNormal(normalize(fs_in.normal));
+}
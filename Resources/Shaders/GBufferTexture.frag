@@ -0,0 +1,41 @@
+#version 430 core
+
+in VS_OUT
+{
+    vec3 pos;
+    vec3 normal;
+    vec3 viewPosition;
+    vec2 texCoords;
+    vec3 tangentFragPos;
+    vec3 tangentDirLightDirection;
+    vec3 tangentSpotLightDirection;
+    vec3 tangentSpotLightPosition;
+    mat3 tangentSpace;
+    vec3 toView;
+    vec4 dirSpacePos;
+    vec4 spotSpacePos;
+} fs_in;
+
+layout(binding = 0) uniform sampler2D albedoTexture;
+layout(binding = 1) uniform sampler2D roughnessTexture;
+layout(binding = 2) uniform sampler2D metalnessTexture;
+layout(binding = 3) uniform sampler2D normalTexture;
+
+layout(location = 0) out vec4 outAlbedoMetalness;
+layout(location = 1) out vec4 outNormalRoughness;
+layout(location = 2) out vec2 outGeometricNormal;
+
+//SHADOW>include GBuffer.glsl
+
+void main()
+{
+    vec3 albedo = texture(albedoTexture, fs_in.texCoords).rgb;
+    float roughness = texture(roughnessTexture, fs_in.texCoords).r;
+    float metallic = texture(metalnessTexture, fs_in.texCoords).r;
+    vec3 N = normalize(texture(normalTexture, fs_in.texCoords).rgb * 2.0 - 1.0);
+    // the lighting resolve works in world space, the tangent space is orthonormal so its transpose brings the normal back
+    N = normalize(transpose(fs_in.tangentSpace) * N);
+    outAlbedoMetalness = vec4(albedo, metallic);
+    outNormalRoughness = vec4(encodeGBufferNormal(N), roughness, 1.0);
+    outGeometricNormal = encodeGBufferNormal(normalize(fs_in.normal));
+}
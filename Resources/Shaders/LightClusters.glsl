@@ -0,0 +1,77 @@
+//SHADOW>include CLUSTER_GRID
+
+// requires UboMvp.glsl and UboWindow.glsl to be included beforehand
+
+struct PointLightData
+{
+    vec3 position;
+    float radius;
+    vec3 color;
+    float strength;
+};
+
+layout (std430, binding = 1) buffer PointLights
+{
+    uint pointLightCount;
+    PointLightData pointLights[];
+};
+
+// the highest bit of a count is set if the spot light reaches the cluster
+layout (std430, binding = 2) buffer Clusters
+{
+    uint clusterLightCounts[CLUSTER_COUNT];
+    uint clusterLightIndices[];
+};
+
+float getProjectionNearZ()
+{
+    return projection[3][2] / (projection[2][2] - 1.0);
+}
+
+float getProjectionFarZ()
+{
+    return projection[3][2] / (projection[2][2] + 1.0);
+}
+
+// exponential slicing keeps the clusters roughly cubical
+float getClusterSliceDepth(float slice, float nearZ, float farZ)
+{
+    return nearZ * pow(farZ / nearZ, slice / float(CLUSTER_Z));
+}
+
+uint getClusterIndex(uvec3 cluster)
+{
+    return cluster.x + cluster.y * CLUSTER_X + cluster.z * CLUSTER_X * CLUSTER_Y;
+}
+
+uint getFragmentCluster(vec2 fragCoord, float viewDepth)
+{
+    float nearZ = getProjectionNearZ();
+    float farZ = getProjectionFarZ();
+    uvec2 tile = uvec2(clamp(fragCoord / windowSize * vec2(CLUSTER_X, CLUSTER_Y), vec2(0.0), vec2(CLUSTER_X - 1, CLUSTER_Y - 1)));
+    float slice = log(max(viewDepth, nearZ) / nearZ) / log(farZ / nearZ) * float(CLUSTER_Z);
+    return getClusterIndex(uvec3(tile, uint(clamp(slice, 0.0, float(CLUSTER_Z - 1)))));
+}
+
+uint getClusterLightCount(uint cluster)
+{
+    return clusterLightCounts[cluster] & ~CLUSTER_SPOT_BIT;
+}
+
+bool isSpotLightInCluster(uint cluster)
+{
+    return (clusterLightCounts[cluster] & CLUSTER_SPOT_BIT) != 0u;
+}
+
+PointLightData getClusterPointLight(uint cluster, uint index)
+{
+    return pointLights[clusterLightIndices[cluster * MAX_CLUSTER_LIGHTS + index]];
+}
+
+// windowed inverse square falloff, reaches zero exactly at the light radius
+float getPointLightAttenuation(float dist, float radius)
+{
+    float ratio = dist / radius;
+    float window = clamp(1.0 - ratio * ratio * ratio * ratio, 0.0, 1.0);
+    return window * window / max(dist * dist, 0.0001);
+}
@@ -1,5 +1,7 @@
 #version 430 core
 
+//SHADOW>include UboMvp.glsl
+
 //SHADOW>include UboMaterial.glsl
 
 //SHADOW>include LightStructs.glsl
@@ -34,6 +36,8 @@ out vec4 outColor;
 
 //SHADOW>include ShadowCalculations.glsl
 
+//SHADOW>include LightClusters.glsl
+
 vec3 getDirectionalLightColor(vec3 N, vec3 V, float NdotV, vec3 F0)
 {
     if(dirLightData.strength == 0.0)
@@ -42,15 +46,24 @@ vec3 getDirectionalLightColor(vec3 N, vec3 V, float NdotV, vec3 F0)
     }
     vec3 L = normalize(-dirLightData.direction);
     float NdotL = max(dot(N, L), 0.0);
+    float shadow;
+    if(isShadowMaskUsed())
+    {
+        shadow = readShadowMask(MASK_DIRECTIONAL);
+    }
+    else
+    {
 #if SHADOW_MASTER || SHADOW_CHSS
-    float shadow = calcShadow(NdotL, fs_in.dirSpacePos, dirLightData.nearZ, dirLightData.lightSize, directionalShadow, directionalPenumbra);
+        shadow = isPenumbraTile(TILE_DIRECTIONAL) ? calcShadow(NdotL, fs_in.dirSpacePos, dirLightData.nearZ, dirLightData.lightSize, directionalShadow, directionalPenumbra, fs_in.normal, DIR_SHADOW_PAGED) : calcHardShadow(fs_in.dirSpacePos, directionalShadow, DIR_SHADOW_PAGED);
 #elif SHADOW_PCSS
-    float shadow = calcShadow(NdotL, fs_in.dirSpacePos, dirLightData.nearZ, dirLightData.lightSize, directionalShadow);
-#elif SHADOW_VSM
-    float shadow = calcShadow(fs_in.dirSpacePos, directionalShadow);
+        shadow = isPenumbraTile(TILE_DIRECTIONAL) ? calcShadow(NdotL, fs_in.dirSpacePos, dirLightData.nearZ, dirLightData.lightSize, directionalShadow, directionalDepthPyramid, DIR_SHADOW_PAGED) : calcHardShadow(fs_in.dirSpacePos, directionalShadow, DIR_SHADOW_PAGED);
+#elif SHADOW_FILTERABLE
+        shadow = calcShadow(fs_in.dirSpacePos, directionalShadow);
 #else
-    float shadow = calcShadow(NdotL, fs_in.dirSpacePos, directionalShadow);
+        shadow = calcShadow(NdotL, fs_in.dirSpacePos, directionalShadow, DIR_SHADOW_PAGED);
 #endif
+    }
+    shadow = applyContactShadow(shadow, MASK_DIRECTIONAL);
     vec3 H = normalize(V + L);
     float cosTheta = clamp(dot(H, V), 0.0, 1.0);
     vec3 F = fresnelSchlick(cosTheta, F0);
@@ -62,23 +75,32 @@ vec3 getDirectionalLightColor(vec3 N, vec3 V, float NdotV, vec3 F0)
     return (diffuse + specular) * dirLightData.color * dirLightData.strength * NdotL * (1.0-shadow);
 }
 
-vec3 getSpotLightColor(vec3 N, vec3 V, float NdotV, vec3 F0)
+vec3 getSpotLightColor(vec3 N, vec3 V, float NdotV, vec3 F0, uint cluster)
 {
-    if(spotLightData.strength == 0.0)
+    if(spotLightData.strength == 0.0 || !isSpotLightInCluster(cluster))
     {
         return vec3(0.0);
     }
     vec3 L = normalize(spotLightData.position - fs_in.pos);
     float NdotL = max(dot(N, L), 0.0);
+    float shadow;
+    if(isShadowMaskUsed())
+    {
+        shadow = readShadowMask(MASK_SPOT);
+    }
+    else
+    {
 #if SHADOW_MASTER || SHADOW_CHSS
-    float shadow = calcShadow(NdotL, fs_in.spotSpacePos, spotLightData.nearZ, spotLightData.lightSize, spotShadow, spotPenumbra);
+        shadow = isPenumbraTile(TILE_SPOT) ? calcShadow(NdotL, fs_in.spotSpacePos, spotLightData.nearZ, spotLightData.lightSize, spotShadow, spotPenumbra, fs_in.normal, false) : calcHardShadow(fs_in.spotSpacePos, spotShadow, false);
 #elif SHADOW_PCSS
-    float shadow = calcShadow(NdotL, fs_in.spotSpacePos, spotLightData.nearZ, spotLightData.lightSize, spotShadow);
-#elif SHADOW_VSM
-    float shadow = calcShadow(fs_in.spotSpacePos, spotShadow);
+        shadow = isPenumbraTile(TILE_SPOT) ? calcShadow(NdotL, fs_in.spotSpacePos, spotLightData.nearZ, spotLightData.lightSize, spotShadow, spotDepthPyramid, false) : calcHardShadow(fs_in.spotSpacePos, spotShadow, false);
+#elif SHADOW_FILTERABLE
+        shadow = calcShadow(fs_in.spotSpacePos, spotShadow);
 #else
-    float shadow = calcShadow(NdotL, fs_in.spotSpacePos, spotShadow);
+        shadow = calcShadow(NdotL, fs_in.spotSpacePos, spotShadow, false);
 #endif
+    }
+    shadow = applyContactShadow(shadow, MASK_SPOT);
     vec3 toLight = normalize(-spotLightData.direction);
     float theta = dot(L, toLight);
     float epsilon = spotLightData.innerCutOff - spotLightData.outerCutOff;
@@ -96,13 +118,39 @@ vec3 getSpotLightColor(vec3 N, vec3 V, float NdotV, vec3 F0)
     return (diffuse + specular) * spotLightData.color * spotLightData.strength * attenuation * intensity * NdotL * (1.0-shadow);
 }
 
+vec3 getPointLightsColor(vec3 N, vec3 V, float NdotV, vec3 F0, uint cluster)
+{
+    vec3 result = vec3(0.0);
+    uint lightCount = getClusterLightCount(cluster);
+    for(uint i = 0u; i < lightCount; ++i)
+    {
+        PointLightData light = getClusterPointLight(cluster, i);
+        vec3 toLight = light.position - fs_in.pos;
+        float dist = length(toLight);
+        vec3 L = toLight / dist;
+        float NdotL = max(dot(N, L), 0.0);
+        vec3 H = normalize(V + L);
+        float cosTheta = max(dot(H, V), 0.0);
+        vec3 F = fresnelSchlick(cosTheta, F0);
+        float D = DistributionGGX(N, H, roughness);
+        float G = GeometrySmith(N, V, L, roughness);
+        vec3 specular = (F*D*G) / max(4.0 * NdotV * NdotL, 0.00001);
+        vec3 kD = (vec3(1.0) - specular) * (1.0 - metallic);
+        vec3 diffuse = kD * albedo / PI;
+        result += (diffuse + specular) * light.color * light.strength * getPointLightAttenuation(dist, light.radius) * NdotL;
+    }
+    return result;
+}
+
 void main()
 {
+    uint cluster = getFragmentCluster(gl_FragCoord.xy, 1.0 / gl_FragCoord.w);
     float NdotV = max(dot(fs_in.normal, fs_in.toView), 0.0);
     vec3 F0 = mix(vec3(0.04), albedo, metallic);
     vec3 Lo =
         albedo * ambient
         + getDirectionalLightColor(fs_in.normal, fs_in.toView, NdotV, F0)
-        + getSpotLightColor(fs_in.normal, fs_in.toView, NdotV, F0);
+        + getSpotLightColor(fs_in.normal, fs_in.toView, NdotV, F0, cluster)
+        + getPointLightsColor(fs_in.normal, fs_in.toView, NdotV, F0, cluster);
     outColor = vec4(Lo, 1.0);
 }
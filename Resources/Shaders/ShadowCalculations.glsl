@@ -2,58 +2,291 @@
 
 //SHADOW>include UboWindow.glsl
 
+//SHADOW>include UboSampling.glsl
+
+//SHADOW>include VIRTUAL_SHADOW_MAP
+
+layout(binding = 20) uniform sampler2D shadowMask;
+
+const int MASK_DIRECTIONAL = 0;
+const int MASK_SPOT = 1;
+
+// With deferred shadows the shadow term of every light was already resolved by a full-screen pass.
+bool isShadowMaskUsed()
+{
+    return deferredShadows.x != 0;
+}
+
+float readShadowMask(int light)
+{
+    return texelFetch(shadowMask, ivec2(gl_FragCoord.xy), 0)[light];
+}
+
+layout(binding = 21) uniform sampler2D contactShadowMask;
+
+// Contact shadows catch the occluders too close to their receivers for the resolution of the shadow maps.
+float applyContactShadow(float shadow, int light)
+{
+    if(contactShadows.x == 0)
+    {
+        return shadow;
+    }
+    return max(shadow, texelFetch(contactShadowMask, ivec2(gl_FragCoord.xy), 0)[light]);
+}
+
+#if !(SHADOW_FILTERABLE)
+#if SHADOW_VIRTUAL
+layout(binding = 15) uniform usampler2D directionalPageTable;
+#endif
+
+const bool DIR_SHADOW_PAGED = SHADOW_VIRTUAL != 0;
+
+// Paged lookups resolve the virtual coordinates through the page table.
+// Pages that are not resident (yet) are treated as unoccluded.
+float sampleShadowDepth(sampler2D text, vec2 coords, bool paged)
+{
+#if SHADOW_VIRTUAL
+    if(paged)
+    {
+        if(any(lessThan(coords, vec2(0.0))) || any(greaterThanEqual(coords, vec2(1.0))))
+        {
+            return 1.0;
+        }
+        vec2 virtualCoords = coords * VIRTUAL_PAGES;
+        uint entry = texelFetch(directionalPageTable, ivec2(virtualCoords), 0).r;
+        if(entry == 0u)
+        {
+            return 1.0;
+        }
+        uint slot = entry - 1u;
+        vec2 physicalPage = vec2(slot % uint(VIRTUAL_POOL_PAGES), slot / uint(VIRTUAL_POOL_PAGES));
+        return texture(text, (physicalPage + fract(virtualCoords)) / VIRTUAL_POOL_PAGES).r;
+    }
+#endif
+    return texture(text, coords).r;
+}
+
+vec2 shadowMapSize(sampler2D text, bool paged)
+{
+#if SHADOW_VIRTUAL
+    if(paged)
+    {
+        return vec2(textureSize(text, 0)) / VIRTUAL_POOL_PAGES * VIRTUAL_PAGES;
+    }
+#endif
+    return vec2(textureSize(text, 0));
+}
+#endif
+
+#if SHADOW_MASTER || SHADOW_CHSS || SHADOW_PCSS
+layout(binding = 16) uniform sampler2D directionalDepthPyramid;
+layout(binding = 17) uniform sampler2D spotDepthPyramid;
+layout(binding = 18) uniform sampler2D blueNoise;
+layout(binding = 19) uniform usampler2D shadowTileClasses;
+
+const int TILE_DIRECTIONAL = 0;
+const int TILE_SPOT = 1;
+const uint TILE_PENUMBRA = 2u;
+
+// light space filter radius of the last soft lookup, 0 when it needed none; the shadow mask passes it on to the denoiser
+float shadowFilterRadiusUV;
+
+// Screen tiles classified as fully lit or fully shadowed by a light resolve with a single lookup,
+// only penumbra tiles take the full filter. Without the classification every tile counts as penumbra.
+bool isPenumbraTile(int light)
+{
+    if(shadowTileSize.x == 0)
+    {
+        return true;
+    }
+    return texelFetch(shadowTileClasses, ivec2(gl_FragCoord.xy) / shadowTileSize.x, 0)[light] == TILE_PENUMBRA;
+}
+
+float calcHardShadow(vec4 lightSpacePos, sampler2D text, bool paged)
+{
+    vec3 projCoords = (lightSpacePos.xyz / lightSpacePos.w) * 0.5 + 0.5;
+    if(projCoords.z > 1.0)
+    {
+        return 0.0;
+    }
+    return sampleShadowDepth(text, projCoords.xy, paged) < projCoords.z - 0.008 ? 1.0 : 0.0;
+}
+
+// Kernel rotation angle, read once per lookup from tiled blue noise instead of evaluating white noise per sample.
+float kernelRotation()
+{
+    ivec2 noiseSize = textureSize(blueNoise, 0);
+    return texelFetch(blueNoise, (ivec2(gl_FragCoord.xy) + noiseOffset.xy) % noiseSize, 0).r * 6.28318531;
+}
+
+// Sample of a vogel disk of sampleCount samples spread evenly over the unit disk, rotated by phi.
+vec2 vogelDiskSample(int sampleIndex, int sampleCount, float phi)
+{
+    float r = sqrt(sampleIndex + 0.5) / sqrt(float(sampleCount));
+    float theta = sampleIndex * 2.4 + phi;
+    return vec2(r * cos(theta), r * sin(theta));
+}
+
+// Adaptive sampling: a small ring of evenly spread samples covers the whole kernel first. When all of them agree
+// the lookup is resolved right away, otherwise the kernel sample count scales with the shadow map texels it covers.
+
+// Occlusion shared by every ring sample, -1 when they disagree or the ring is disabled.
+float ringOcclusion(sampler2D text, vec2 center, float radius, float receiverDepth, float phi, bool paged)
+{
+    int ringSamples = int(adaptiveSampling.x);
+    if(ringSamples <= 0)
+    {
+        return -1.0;
+    }
+    int occluded = 0;
+    for(int i = 0; i < ringSamples; ++i)
+    {
+        if(sampleShadowDepth(text, center + vogelDiskSample(i, ringSamples, phi) * radius, paged) < receiverDepth)
+        {
+            ++occluded;
+        }
+    }
+    return occluded == 0 ? 0.0 : (occluded == ringSamples ? 1.0 : -1.0);
+}
+
+int adaptiveSampleCount(int sampleCount, float radius, vec2 mapSize)
+{
+    if(adaptiveSampling.y <= 0.0)
+    {
+        return sampleCount;
+    }
+    vec2 texelRadius = radius * mapSize;
+    return clamp(int(ceil(3.14159265 * texelRadius.x * texelRadius.y * adaptiveSampling.y)), 1, sampleCount);
+}
+
+// Minimum and maximum depth inside the blocker search square, read from the pyramid level
+// where the square covers at most 2x2 texels. Paged maps have no pyramid, their bounds are unknown.
+vec2 blockerSearchBounds(sampler2D pyramid, vec2 center, float radius, bool paged)
+{
+    if(paged)
+    {
+        return vec2(0.0, 1.0);
+    }
+    float baseSize = float(textureSize(pyramid, 0).x);
+    int lod = int(clamp(ceil(log2(max(2.0 * radius * baseSize, 1.0))), 0.0, float(textureQueryLevels(pyramid) - 1)));
+    ivec2 size = textureSize(pyramid, lod);
+    ivec2 minTexel = clamp(ivec2(floor((center - radius) * size)), ivec2(0), size - 1);
+    ivec2 maxTexel = clamp(ivec2(floor((center + radius) * size)), ivec2(0), size - 1);
+    vec2 bounds = vec2(1.0, 0.0);
+    for(int y = minTexel.y; y <= maxTexel.y; ++y)
+    {
+        for(int x = minTexel.x; x <= maxTexel.x; ++x)
+        {
+            vec2 texelBounds = texelFetch(pyramid, ivec2(x, y), lod).rg;
+            bounds = vec2(min(bounds.x, texelBounds.x), max(bounds.y, texelBounds.y));
+        }
+    }
+    return bounds;
+}
+#endif
+
 #if SHADOW_MASTER || SHADOW_CHSS
-//SHADOW>include VOGEL_DISK
+#define VOGEL_SS sampleCounts.x
+#define VOGEL_PS sampleCounts.y
 
 #if SHADOW_MASTER
-// Provided vogel disks are arrays of vec2.
-// Each vec2 consists of radius and angle (theta).
+// Provided vogel disks hold the radius and angle (theta) of every sample.
+// Disks reduced by the adaptive sampling are stretched back to the full kernel.
 
-vec2 sampleShadowVogelDisk(int sampleIndex, float phi)
+vec2 sampleShadowVogelDisk(int sampleIndex, int sampleCount, float phi)
 {
-    vec2 rTheta = shadowVogelDisk[sampleIndex];
+    vec2 rTheta = vogelDisks[sampleIndex].xy;
+    rTheta.r *= sqrt(float(VOGEL_SS) / float(sampleCount));
     rTheta.g += phi;
     return vec2(rTheta.r * cos(rTheta.g), rTheta.r * sin(rTheta.g));
 }
 
-vec2 samplePenumbraVogelDisk(int sampleIndex, float phi)
+vec2 samplePenumbraVogelDisk(int sampleIndex, int sampleCount, float phi)
 {
-    vec2 rTheta = penumbraVogelDisk[sampleIndex];
+    vec2 rTheta = vogelDisks[sampleIndex].zw;
+    rTheta.r *= sqrt(float(VOGEL_PS) / float(sampleCount));
     rTheta.g += phi;
     return vec2(rTheta.r * cos(rTheta.g), rTheta.r * sin(rTheta.g));
 }
 #else
-const float VOGEL_SS_SQRT = sqrt(VOGEL_SS);
-const float VOGEL_PS_SQRT = sqrt(VOGEL_PS);
+vec2 sampleShadowVogelDisk(int sampleIndex, int sampleCount, float phi)
+{
+    return vogelDiskSample(sampleIndex, sampleCount, phi);
+}
 
-vec2 sampleShadowVogelDisk(int sampleIndex, float phi)
+vec2 samplePenumbraVogelDisk(int sampleIndex, int sampleCount, float phi)
 {
-    float r = sqrt(sampleIndex + 0.5f) / VOGEL_SS_SQRT;
-    float theta = sampleIndex * 2.4f + phi;
-    return vec2(r * cos(theta), r * sin(theta));
+    return vogelDiskSample(sampleIndex, sampleCount, phi);
 }
+#endif
 
-vec2 samplePenumbraVogelDisk(int sampleIndex, float phi)
+float penumbraSize(float receiverDepth, float blockerDepth)
 {
-    float r = sqrt(sampleIndex + 0.5f) / VOGEL_PS_SQRT;
-    float theta = sampleIndex * 2.4f + phi;
-    return vec2(r * cos(theta), r * sin(theta));
+    return (receiverDepth-blockerDepth) / blockerDepth;
+}
+
+vec2 encodeOctahedral(vec3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    return n.z >= 0.0 ? n.xy : (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+}
+
+vec3 decodeOctahedral(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
 }
+
+// Penumbra texels store the ratio along with the view depth and normal of their surface, which guide the upsampling.
+// For a perspective projection the view depth equals 1 / gl_FragCoord.w, full-screen passes provide their own.
+#ifndef VIEW_DEPTH
+#define VIEW_DEPTH (1.0 / gl_FragCoord.w)
 #endif
 
-float interleavedGradientNoise(vec2 screenPos)
+vec4 packPenumbra(float penumbraRatio, vec3 normal)
 {
-    const vec3 factors = vec3(0.06711056f, 0.00583715f, 52.9829189f);
-    return fract(factors.z * sin(dot(screenPos.xy, factors.xy)));
+    return vec4(min(penumbraRatio, 1.0), VIEW_DEPTH, encodeOctahedral(normalize(normal)));
 }
 
-float penumbraSize(float receiverDepth, float blockerDepth)
+const float PENUMBRA_DEPTH_SIGMA = 0.02; // relative view depth difference
+const float PENUMBRA_NORMAL_POWER = 16.0;
+
+// Joint bilateral upsampling of the 2x2 closest low resolution texels. Texels from other surfaces get negligible
+// weights, when no texel belongs to this surface the one closest in depth is used instead.
+float upsamplePenumbra(sampler2D penumbraText, vec3 normal)
 {
-    return (receiverDepth-blockerDepth) / blockerDepth;
+    ivec2 lowSize = textureSize(penumbraText, 0);
+    vec2 lowCoords = gl_FragCoord.xy / windowSize * vec2(lowSize) - 0.5;
+    ivec2 baseTexel = ivec2(floor(lowCoords));
+    vec2 bilinear = fract(lowCoords);
+    float depth = VIEW_DEPTH;
+    normal = normalize(normal);
+    float penumbraRatio = 0.0, weightSum = 0.0;
+    float nearestRatio = 0.0, nearestDifference = 1e30;
+    for(int i = 0; i < 4; ++i)
+    {
+        ivec2 offset = ivec2(i & 1, i >> 1);
+        vec4 texelData = texelFetch(penumbraText, clamp(baseTexel + offset, ivec2(0), lowSize - 1), 0);
+        float depthDifference = abs(texelData.g - depth) / depth;
+        vec2 bilinearWeights = mix(1.0 - bilinear, bilinear, vec2(offset));
+        float depthWeight = exp(-depthDifference * depthDifference / (2.0 * PENUMBRA_DEPTH_SIGMA * PENUMBRA_DEPTH_SIGMA));
+        float normalWeight = pow(max(dot(normal, decodeOctahedral(texelData.ba)), 0.0), PENUMBRA_NORMAL_POWER);
+        float weight = bilinearWeights.x * bilinearWeights.y * depthWeight * normalWeight;
+        penumbraRatio += texelData.r * weight;
+        weightSum += weight;
+        if(depthDifference < nearestDifference)
+        {
+            nearestDifference = depthDifference;
+            nearestRatio = texelData.r;
+        }
+    }
+    return weightSum > 1e-4 ? penumbraRatio / weightSum : nearestRatio;
 }
 
 #if SHADOW_MASTER
-float calcPenumbra(vec4 lightSpacePos, float nearZ, float lightSize, sampler2D text)
+float calcPenumbra(vec4 lightSpacePos, float nearZ, float lightSize, sampler2D text, sampler2D pyramid, bool paged)
 {
     vec3 projCoords = (lightSpacePos.xyz / lightSpacePos.w) * 0.5 + 0.5;
     if(projCoords.z > 1.0)
@@ -63,10 +296,28 @@ float calcPenumbra(vec4 lightSpacePos, float nearZ, float lightSize, sampler2D t
     float blockerDepth = 0.0;
     int numBlockers = 0;
     vec2 texCoords = projCoords.xy;
-    float searchWidth = lightSize * (projCoords.z - nearZ) / projCoords.z;
-    for(int i = 0; i < VOGEL_PS; ++i)
+    // the light near plane is not in depth units, the width turns negative for receivers with smaller depths
+    float searchWidth = abs(lightSize * (projCoords.z - nearZ) / projCoords.z);
+    vec2 depthBounds = blockerSearchBounds(pyramid, texCoords, searchWidth, paged);
+    if(depthBounds.x >= projCoords.z)
     {
-        float depth = texture(text, texCoords + samplePenumbraVogelDisk(i, interleavedGradientNoise(gl_FragCoord.xy / windowSize)) * searchWidth).r;
+        return 0.0;
+    }
+    if(depthBounds.y < projCoords.z)
+    {
+        // every sample would be a blocker, their average lies within the bounds
+        blockerDepth = 0.5 * (depthBounds.x + depthBounds.y);
+        return (projCoords.z - blockerDepth) / blockerDepth;
+    }
+    float phi = kernelRotation();
+    if(ringOcclusion(text, texCoords, searchWidth, projCoords.z, phi, paged) == 0.0)
+    {
+        return 0.0;
+    }
+    int sampleCount = adaptiveSampleCount(VOGEL_PS, searchWidth, shadowMapSize(text, paged));
+    for(int i = 0; i < sampleCount; ++i)
+    {
+        float depth = sampleShadowDepth(text, texCoords + samplePenumbraVogelDisk(i, sampleCount, phi) * searchWidth, paged);
         if(depth < projCoords.z)
         {
             blockerDepth += depth;
@@ -81,34 +332,41 @@ float calcPenumbra(vec4 lightSpacePos, float nearZ, float lightSize, sampler2D t
     return (projCoords.z - blockerDepth) / blockerDepth;
 }
 
-float calcShadow(float worldNdotL, vec4 lightSpacePos, float nearZ, float lightSize, sampler2D text, sampler2D penumbraText)
+float calcShadow(float worldNdotL, vec4 lightSpacePos, float nearZ, float lightSize, sampler2D text, sampler2D penumbraText, vec3 normal, bool paged)
 {
-    vec2 screenCoords = gl_FragCoord.xy / windowSize;
     vec3 projCoords = (lightSpacePos.xyz / lightSpacePos.w) * 0.5 + 0.5;
     if(projCoords.z > 1.0)
     {
         return 0.0;
     }
-    float penumbraRatio = texture(penumbraText, screenCoords).r;
+    float penumbraRatio = upsamplePenumbra(penumbraText, normal);
     if(penumbraRatio == 0.0)
     {
         return 0.0;
     }
     float filterRadiusUV = penumbraRatio * lightSize * nearZ / projCoords.z;
+    shadowFilterRadiusUV = filterRadiusUV;
     float shadow = 0.0;
-    for(int i = 0; i < VOGEL_SS; ++i)
+    float phi = kernelRotation();
+    float ring = ringOcclusion(text, projCoords.xy, filterRadiusUV, projCoords.z - 0.008, phi, paged);
+    if(ring >= 0.0)
     {
-        float depth = texture(text, projCoords.xy + sampleShadowVogelDisk(i, interleavedGradientNoise(screenCoords)) * filterRadiusUV).r;
+        return ring;
+    }
+    int sampleCount = adaptiveSampleCount(VOGEL_SS, filterRadiusUV, shadowMapSize(text, paged));
+    for(int i = 0; i < sampleCount; ++i)
+    {
+        float depth = sampleShadowDepth(text, projCoords.xy + sampleShadowVogelDisk(i, sampleCount, phi) * filterRadiusUV, paged);
         if(depth < projCoords.z - 0.008)
         {
             shadow += 1.0;
         }
     }
-    shadow /= VOGEL_SS;
+    shadow /= float(sampleCount);
     return shadow;
 }
 #else
-float calcPenumbra(vec4 lightSpacePos, float nearZ, float lightSize, sampler2D text)
+float calcPenumbra(vec4 lightSpacePos, float nearZ, float lightSize, sampler2D text, sampler2D pyramid, bool paged)
 {
     vec3 projCoords = (lightSpacePos.xyz / lightSpacePos.w) * 0.5 + 0.5;
     if(projCoords.z > 1.0)
@@ -118,10 +376,27 @@ float calcPenumbra(vec4 lightSpacePos, float nearZ, float lightSize, sampler2D t
     float blockerDepth = 0.0;
     int numBlockers = 0;
     vec2 texCoords = projCoords.xy;
-    float searchWidth = lightSize * (projCoords.z - nearZ) / projCoords.z;
-    for(int i = 0; i < VOGEL_PS; ++i)
+    float searchWidth = abs(lightSize * (projCoords.z - nearZ) / projCoords.z);
+    vec2 depthBounds = blockerSearchBounds(pyramid, texCoords, searchWidth, paged);
+    if(depthBounds.x >= projCoords.z)
+    {
+        return 0.0;
+    }
+    if(depthBounds.y < projCoords.z)
     {
-        float depth = texture(text, texCoords + samplePenumbraVogelDisk(i, interleavedGradientNoise(gl_FragCoord.xy / windowSize)) * searchWidth).r;
+        // every sample would be a blocker, their average lies within the bounds
+        blockerDepth = 0.5 * (depthBounds.x + depthBounds.y);
+        return (projCoords.z - blockerDepth) / blockerDepth;
+    }
+    float phi = kernelRotation();
+    if(ringOcclusion(text, texCoords, searchWidth, projCoords.z, phi, paged) == 0.0)
+    {
+        return 0.0;
+    }
+    int sampleCount = adaptiveSampleCount(VOGEL_PS, searchWidth, shadowMapSize(text, paged));
+    for(int i = 0; i < sampleCount; ++i)
+    {
+        float depth = sampleShadowDepth(text, texCoords + samplePenumbraVogelDisk(i, sampleCount, phi) * searchWidth, paged);
         if(depth < projCoords.z)
         {
             blockerDepth += depth;
@@ -136,45 +411,46 @@ float calcPenumbra(vec4 lightSpacePos, float nearZ, float lightSize, sampler2D t
     return (projCoords.z - blockerDepth) / blockerDepth;
 }
 
-float calcShadow(float worldNdotL, vec4 lightSpacePos, float nearZ, float lightSize, sampler2D text, sampler2D penumbraText)
+float calcShadow(float worldNdotL, vec4 lightSpacePos, float nearZ, float lightSize, sampler2D text, sampler2D penumbraText, vec3 normal, bool paged)
 {
     vec3 projCoords = (lightSpacePos.xyz / lightSpacePos.w) * 0.5 + 0.5;
     if(projCoords.z > 1.0)
     {
         return 0.0;
     }
-    float penumbraRatio = texture(penumbraText, gl_FragCoord.xy / windowSize).r;
+    float penumbraRatio = upsamplePenumbra(penumbraText, normal);
     if(penumbraRatio == 0.0)
     {
         return 0.0;
     }
     float filterRadiusUV = penumbraRatio * lightSize * nearZ / projCoords.z;
+    shadowFilterRadiusUV = filterRadiusUV;
     float shadow = 0.0;
-    for(int i = 0; i < VOGEL_SS; ++i)
+    float phi = kernelRotation();
+    float ring = ringOcclusion(text, projCoords.xy, filterRadiusUV, projCoords.z - 0.008, phi, paged);
+    if(ring >= 0.0)
     {
-        float depth = texture(text, projCoords.xy + sampleShadowVogelDisk(i, interleavedGradientNoise(gl_FragCoord.xy / windowSize)) * filterRadiusUV).r;
+        return ring;
+    }
+    int sampleCount = adaptiveSampleCount(VOGEL_SS, filterRadiusUV, shadowMapSize(text, paged));
+    for(int i = 0; i < sampleCount; ++i)
+    {
+        float depth = sampleShadowDepth(text, projCoords.xy + sampleShadowVogelDisk(i, sampleCount, phi) * filterRadiusUV, paged);
         if(depth < projCoords.z - 0.008)
         {
             shadow += 1.0;
         }
     }
-    shadow /= VOGEL_SS;
+    shadow /= float(sampleCount);
     return shadow;
 }
 #endif
 #elif SHADOW_PCSS
 
-//SHADOW>include POISSON
-
-#if PCSS_BLOCKERS <= 0 || PCSS_BLOCKERS > PCSS_MAX_BLOCKERS
-#error Invalid PCSS_BLOCKERS value!
-#endif
-
-#if PCSS_FILTER_SIZE <= 0 || PCSS_FILTER_SIZE > PCSS_MAX_BLOCKERS
-#error Invalid PCSS_FILTER_SIZE value!
-#endif
+#define PCSS_MAX_BLOCKERS 32
+#define PCSS_BLOCKERS sampleCounts.z
+#define PCSS_FILTER_SIZE sampleCounts.w
 
-#if PCSS_MAX_BLOCKERS == 32
 vec2 POISSON_DISK[PCSS_MAX_BLOCKERS] = {
     vec2(0.06407013, 0.05409927),
     vec2(0.7366577, 0.5789394),
@@ -209,36 +485,13 @@ vec2 POISSON_DISK[PCSS_MAX_BLOCKERS] = {
     vec2(-0.04661255, 0.7995201),
     vec2(0.4402924, 0.3640312),
 };
-#elif PCSS_MAX_BLOCKERS == 16
-vec2 POISSON_DISK[PCSS_MAX_BLOCKERS] =
-{
-    vec2(-0.94201624, -0.39906216),
-    vec2(0.94558609, -0.76890725),
-    vec2(-0.094184101, -0.92938870),
-    vec2(0.34495938, 0.29387760),
-    vec2(-0.91588581, 0.45771432),
-    vec2(-0.81544232, -0.87912464),
-    vec2(-0.38277543, 0.27676845),
-    vec2(0.97484398, 0.75648379),
-    vec2(0.44323325, -0.97511554),
-    vec2(0.53742981, -0.47373420),
-    vec2(-0.26496911, -0.41893023),
-    vec2(0.79197514, 0.19090188),
-    vec2(-0.24188840, 0.99706507),
-    vec2(-0.81409955, 0.91437590),
-    vec2(0.19984126, 0.78641367),
-    vec2(0.14383161, -0.14100790)
-};
-#else
-#error Invalid PCSS_MAX_BLOCKERS value!
-#endif
 
 float penumbraSize(float receiverDepth, float blockerDepth)
 {
     return (receiverDepth-blockerDepth) / blockerDepth;
 }
 
-float calcShadow(float worldNdotL, vec4 lightSpacePos, float nearZ, float lightSize, sampler2D text)
+float calcShadow(float worldNdotL, vec4 lightSpacePos, float nearZ, float lightSize, sampler2D text, sampler2D pyramid, bool paged)
 {
     vec3 projCoords = (lightSpacePos.xyz / lightSpacePos.w) * 0.5 + 0.5;
     if(projCoords.z > 1.0)
@@ -248,10 +501,29 @@ float calcShadow(float worldNdotL, vec4 lightSpacePos, float nearZ, float lightS
     float blockerDepth = 0.0;
     int numBlockers = 0;
     vec2 texCoords=projCoords.xy;
-    float searchWidth = lightSize * (projCoords.z - nearZ) / projCoords.z;
+    float searchWidth = abs(lightSize * (projCoords.z - nearZ) / projCoords.z);
+    vec2 depthBounds = blockerSearchBounds(pyramid, texCoords, searchWidth, paged);
+    if(depthBounds.x >= projCoords.z)
+    {
+        return 0.0;
+    }
+    // the nearest possible blocker bounds the filter disk, a fully occluded search region resolves the umbra
+    // only if that disk stays within it
+    float maxFilterRadiusUV = (projCoords.z - depthBounds.x) / depthBounds.x * lightSize * nearZ / projCoords.z;
+    if(depthBounds.y < projCoords.z - 0.008 && maxFilterRadiusUV <= searchWidth)
+    {
+        return 1.0;
+    }
+    float phi = kernelRotation();
+    mat2 rotation = mat2(cos(phi), sin(phi), -sin(phi), cos(phi));
+    if(ringOcclusion(text, texCoords, searchWidth, projCoords.z, phi, paged) == 0.0)
+    {
+        return 0.0;
+    }
+    // a prefix of the fixed Poisson disk does not cover the kernel evenly, so only the ring early-out applies here
     for(int i=0;i<PCSS_BLOCKERS;++i)
     {
-        float depth = texture(text, texCoords + POISSON_DISK[i] * searchWidth).r;
+        float depth = sampleShadowDepth(text, texCoords + rotation * POISSON_DISK[i] * searchWidth, paged);
         if(depth < projCoords.z)
         {
             blockerDepth += depth;
@@ -265,46 +537,50 @@ float calcShadow(float worldNdotL, vec4 lightSpacePos, float nearZ, float lightS
     blockerDepth /= numBlockers;
     float penumbraRatio = (projCoords.z - blockerDepth) / blockerDepth;
     float filterRadiusUV = penumbraRatio * lightSize * nearZ / projCoords.z;
+    shadowFilterRadiusUV = filterRadiusUV;
     float shadow = 0.0;
+    float ring = ringOcclusion(text, projCoords.xy, filterRadiusUV, projCoords.z - 0.008, phi, paged);
+    if(ring >= 0.0)
+    {
+        return ring;
+    }
     for(int i=0;i<PCSS_FILTER_SIZE;++i)
     {
-        float depth = texture(text, projCoords.xy + POISSON_DISK[i] * filterRadiusUV).r;
+        float depth = sampleShadowDepth(text, projCoords.xy + rotation * POISSON_DISK[i] * filterRadiusUV, paged);
         if(depth < projCoords.z - 0.008)
         {
             shadow += 1.0;
         }
     }
-    shadow /= PCSS_FILTER_SIZE;
+    shadow /= float(PCSS_FILTER_SIZE);
     return shadow;
 }
 #elif SHADOW_PCF
-//SHADOW>include FILTER_SIZE
-const int PCF_MAX = FILTER_SIZE / 2, PCF_MIN = -PCF_MAX;
-const float FILTER_SIZE_SQUARED = FILTER_SIZE * FILTER_SIZE;
 const float TEX_SIZE_MULTIPLIER = 1.0f;
-float calcShadow(float worldNdotL, vec4 lightSpacePos, sampler2D text)
+float calcShadow(float worldNdotL, vec4 lightSpacePos, sampler2D text, bool paged)
 {
     vec3 projCoords = (lightSpacePos.xyz / lightSpacePos.w) * 0.5 + 0.5;
     if(projCoords.z  <= 1.0)
     {
-        float closestDepth = texture(text, projCoords.xy).r;
+        float closestDepth = sampleShadowDepth(text, projCoords.xy, paged);
         float currentDepth = projCoords.z;
         float bias = max(0.007 * (1.0 - worldNdotL), 0.0085);
         if(currentDepth - bias > closestDepth)
         {
             return 1.0;
         }
-        vec2 texelSize = TEX_SIZE_MULTIPLIER / textureSize(text, 0);
+        vec2 texelSize = TEX_SIZE_MULTIPLIER / shadowMapSize(text, paged);
+        int pcfMax = filterSize.x / 2, pcfMin = -pcfMax;
         float shadow = 0.0;
-        for(int x = PCF_MIN; x <= PCF_MAX; ++x)
+        for(int x = pcfMin; x <= pcfMax; ++x)
         {
-            for(int y = PCF_MIN; y <= PCF_MAX; ++y)
+            for(int y = pcfMin; y <= pcfMax; ++y)
             {
-                float pcfDepth = texture(text, projCoords.xy + vec2(x,y) * texelSize).r;
+                float pcfDepth = sampleShadowDepth(text, projCoords.xy + vec2(x,y) * texelSize, paged);
                 shadow += currentDepth - bias > pcfDepth ? 0.0 : 1.0;
             }
         }
-        return 1.0 - (shadow / FILTER_SIZE_SQUARED);
+        return 1.0 - (shadow / float(filterSize.x * filterSize.x));
     }
     return 0.0;
 }
@@ -327,13 +603,107 @@ float calcShadow(vec4 lightSpacePos, sampler2D text)
     float pMax = linstep(0.25, 1.0, variance / (variance + d*d));
     return 1.0 - min(max(p, pMax), 1.0);
 }
+#elif SHADOW_MSM
+//SHADOW>include SHADOW_MAP_FORMAT
+
+#if MSM_QUANTIZED
+const mat4 MSM_DEQUANTIZATION = mat4(
+    0.2227744146, 0.1549679261, 0.1451988946, 0.163127443,
+    0.0771972861, 0.1394629426, 0.2120202157, 0.2591432266,
+    0.7926986636, 0.7963415838, 0.7258694464, 0.6539092497,
+    0.0319417555, -0.1722823173, -0.2758014811, -0.3376131734);
+const float MSM_MOMENT_BIAS = 6e-5;
+#else
+const float MSM_MOMENT_BIAS = 3e-5;
+#endif
+const float MSM_DEPTH_BIAS = 0.0005;
+
+// reference: Peters, Klein - Moment Shadow Mapping (Hamburger 4MSM)
+float calcShadow(vec4 lightSpacePos, sampler2D text)
+{
+    vec3 projCoords = (lightSpacePos.xyz / lightSpacePos.w) * 0.5 + 0.5;
+    if(projCoords.z > 0.999)
+    {
+        return 0.0;
+    }
+    vec4 moments = texture(text, projCoords.xy);
+#if MSM_QUANTIZED
+    moments.x -= 0.035955884801;
+    moments = MSM_DEQUANTIZATION * moments;
+#endif
+    vec4 b = mix(moments, vec4(0.5), MSM_MOMENT_BIAS);
+    float depth = projCoords.z - MSM_DEPTH_BIAS;
+    // Cholesky decomposition of the Hankel matrix of the biased moments
+    float L32D22 = -b.x * b.y + b.z;
+    float D22 = -b.x * b.x + b.y;
+    float squaredDepthVariance = -b.y * b.y + b.w;
+    float D33D22 = dot(vec2(squaredDepthVariance, -L32D22), vec2(D22, L32D22));
+    float InvD22 = 1.0 / D22;
+    float L32 = L32D22 * InvD22;
+    vec3 c = vec3(1.0, depth, depth * depth);
+    c.y -= b.x;
+    c.z -= b.y + L32 * c.y;
+    c.y *= InvD22;
+    c.z *= D22 / D33D22;
+    c.y -= L32 * c.z;
+    c.x -= dot(c.yz, b.xy);
+    // the roots of c.x + c.y * z + c.z * z^2 are the two other support points of the reconstructed distribution
+    float p = c.y / c.z;
+    float q = c.x / c.z;
+    float r = sqrt(max(p * p * 0.25 - q, 0.0));
+    vec2 z = vec2(-p * 0.5 - r, -p * 0.5 + r);
+    vec4 switchVal = (z.y < depth) ? vec4(z.x, depth, 1.0, 1.0) :
+        ((z.x < depth) ? vec4(depth, z.x, 0.0, 1.0) : vec4(0.0));
+    float quotient = (switchVal.x * z.y - b.x * (switchVal.x + z.y) + b.y) / ((z.y - switchVal.y) * (depth - z.x));
+    return clamp(switchVal.z + switchVal.w * quotient, 0.0, 1.0);
+}
+#elif SHADOW_EVSM
+//SHADOW>include EVSM
+
+const float EVSM_MIN_VARIANCE = 0.0001;
+const float EVSM_LIGHT_BLEEDING_REDUCTION = 0.2;
+
+float linstep(float low, float high, float v)
+{
+    return clamp((v-low)/(high-low), 0.0, 1.0);
+}
+float chebyshevUpperBound(vec2 moments, float mean, float minVariance)
+{
+    float variance = max(moments.y - moments.x * moments.x, minVariance);
+    float d = mean - moments.x;
+    float pMax = variance / (variance + d*d);
+    return mean <= moments.x ? 1.0 : pMax;
+}
+// the mipmapped map is prefiltered, so a single trilinear (or anisotropic) lookup replaces any sample loop
+float calcShadow(vec4 lightSpacePos, sampler2D text)
+{
+    vec3 projCoords = (lightSpacePos.xyz / lightSpacePos.w) * 0.5 + 0.5;
+    // the derivatives are undefined past the divergent return, so the gradients are taken before it (the bias scales them)
+    float gradScale = exp2(float(EVSM_MIP_BIAS));
+    vec2 gradX = dFdx(projCoords.xy) * gradScale;
+    vec2 gradY = dFdy(projCoords.xy) * gradScale;
+    if(projCoords.z > 0.999)
+    {
+        return 0.0;
+    }
+    vec4 moments = textureGrad(text, projCoords.xy, gradX, gradY);
+    float depth = 2.0 * projCoords.z - 1.0;
+    vec2 exponents = vec2(EVSM_POSITIVE_EXPONENT, EVSM_NEGATIVE_EXPONENT);
+    vec2 warped = vec2(exp(exponents.x * depth), -exp(-exponents.y * depth));
+    // the minimal variance follows the slope of the warp, so that it stays the same in depth units
+    vec2 depthScale = EVSM_MIN_VARIANCE * exponents * warped;
+    vec2 minVariance = depthScale * depthScale;
+    float positive = chebyshevUpperBound(moments.xy, warped.x, minVariance.x);
+    float negative = chebyshevUpperBound(moments.zw, warped.y, minVariance.y);
+    return 1.0 - linstep(EVSM_LIGHT_BLEEDING_REDUCTION, 1.0, min(positive, negative));
+}
 #elif SHADOW_BASIC
-float calcShadow(float worldNdotL, vec4 lightSpacePos, sampler2D text)
+float calcShadow(float worldNdotL, vec4 lightSpacePos, sampler2D text, bool paged)
 {
     vec3 projCoords = (lightSpacePos.xyz / lightSpacePos.w) * 0.5 + 0.5;
     if(projCoords.z  <= 1.0)
     {
-        float closestDepth = texture(text, projCoords.xy).r;
+        float closestDepth = sampleShadowDepth(text, projCoords.xy, paged);
         float currentDepth = projCoords.z;
         float bias = max(0.005 * (1.0 - worldNdotL), 0.0009);
         if(currentDepth - bias > closestDepth)
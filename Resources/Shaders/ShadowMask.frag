@@ -0,0 +1,92 @@
+#version 430 core
+
+//SHADOW>include LightStructs.glsl
+
+//SHADOW>include UboLights.glsl
+
+//SHADOW>include ShadowVariants.glsl
+
+#if SHADOW_MASTER || SHADOW_CHSS
+layout(binding = 10) uniform sampler2D directionalShadow;
+layout(binding = 11) uniform sampler2D directionalPenumbra;
+layout(binding = 12) uniform sampler2D spotShadow;
+layout(binding = 13) uniform sampler2D spotPenumbra;
+#else
+layout(binding = 10) uniform sampler2D directionalShadow;
+layout(binding = 11) uniform sampler2D spotShadow;
+#endif
+
+layout(binding = 14) uniform sampler2D depthTexture;
+uniform mat4 inverseViewProjection;
+uniform int light; // 0 for the directional light, 1 for the spot light
+
+//SHADOW>include ShadowMaskPacking.glsl
+
+in VS_OUT
+{
+    vec2 texCoords;
+} fs_in;
+
+out vec4 outColor;
+
+// the full-screen quad has no perspective, the penumbra upsampling uses the reconstructed view depth instead
+float receiverViewDepth;
+#define VIEW_DEPTH receiverViewDepth
+
+//SHADOW>include ShadowCalculations.glsl
+
+float getDirectionalShadow(vec3 pos, vec3 normal)
+{
+    vec4 dirSpacePos = dirLightData.lightSpace * vec4(pos, 1.0);
+#if SHADOW_MASTER || SHADOW_CHSS
+    return isPenumbraTile(TILE_DIRECTIONAL) ? calcShadow(dot(normal, -dirLightData.direction), dirSpacePos, dirLightData.nearZ, dirLightData.lightSize, directionalShadow, directionalPenumbra, normal, DIR_SHADOW_PAGED) : calcHardShadow(dirSpacePos, directionalShadow, DIR_SHADOW_PAGED);
+#elif SHADOW_PCSS
+    return isPenumbraTile(TILE_DIRECTIONAL) ? calcShadow(dot(normal, -dirLightData.direction), dirSpacePos, dirLightData.nearZ, dirLightData.lightSize, directionalShadow, directionalDepthPyramid, DIR_SHADOW_PAGED) : calcHardShadow(dirSpacePos, directionalShadow, DIR_SHADOW_PAGED);
+#elif SHADOW_FILTERABLE
+    return calcShadow(dirSpacePos, directionalShadow);
+#else
+    return calcShadow(dot(normal, -dirLightData.direction), dirSpacePos, directionalShadow, DIR_SHADOW_PAGED);
+#endif
+}
+
+float getSpotShadow(vec3 pos, vec3 normal)
+{
+    vec4 spotSpacePos = spotLightData.lightSpace * vec4(pos, 1.0);
+#if SHADOW_MASTER || SHADOW_CHSS
+    return isPenumbraTile(TILE_SPOT) ? calcShadow(dot(normal, normalize(spotLightData.position - pos)), spotSpacePos, spotLightData.nearZ, spotLightData.lightSize, spotShadow, spotPenumbra, normal, false) : calcHardShadow(spotSpacePos, spotShadow, false);
+#elif SHADOW_PCSS
+    return isPenumbraTile(TILE_SPOT) ? calcShadow(dot(normal, normalize(spotLightData.position - pos)), spotSpacePos, spotLightData.nearZ, spotLightData.lightSize, spotShadow, spotDepthPyramid, false) : calcHardShadow(spotSpacePos, spotShadow, false);
+#elif SHADOW_FILTERABLE
+    return calcShadow(spotSpacePos, spotShadow);
+#else
+    return calcShadow(dot(normal, normalize(spotLightData.position - pos)), spotSpacePos, spotShadow, false);
+#endif
+}
+
+void main()
+{
+    float depth = texelFetch(depthTexture, ivec2(gl_FragCoord.xy), 0).r;
+    vec4 ndc = vec4(gl_FragCoord.xy / windowSize * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+    vec4 world = inverseViewProjection * ndc;
+    vec3 pos = world.xyz / world.w;
+    receiverViewDepth = 1.0 / world.w;
+    // the geometric normal, there is no G-buffer to read the shading one from
+    vec3 normal = normalize(cross(dFdx(pos), dFdy(pos)));
+    float shadow = 0.0;
+    float penumbra = 0.0;
+#if SHADOW_MASTER || SHADOW_CHSS || SHADOW_PCSS
+    // the screen derivatives of the light space coordinates turn the filter radius into pixels for the denoiser
+    vec4 lightSpacePos = (light == 0 ? dirLightData.lightSpace : spotLightData.lightSpace) * vec4(pos, 1.0);
+    vec2 lightCoords = lightSpacePos.xy / lightSpacePos.w * 0.5;
+    float lightCoordsPerPixel = max(length(dFdx(lightCoords)), length(dFdy(lightCoords)));
+    shadowFilterRadiusUV = 0.0;
+#endif
+    if(depth < 1.0) // the background does not receive shadows
+    {
+        shadow = light == 0 ? getDirectionalShadow(pos, normal) : getSpotShadow(pos, normal);
+#if SHADOW_MASTER || SHADOW_CHSS || SHADOW_PCSS
+        penumbra = shadowFilterRadiusUV / max(lightCoordsPerPixel, 1e-6);
+#endif
+    }
+    outColor = packShadowMask(shadow, penumbra);
+}
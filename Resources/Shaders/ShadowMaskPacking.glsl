@@ -0,0 +1,15 @@
+// the shadow mask keeps both lights in one RGBA8 target: the shadow terms in rg, next to them the penumbra radii in ba,
+// in screen pixels normalized to MAX_PENUMBRA_PIXELS so that the denoiser can bound its footprint per light
+const float MAX_PENUMBRA_PIXELS = 32.0;
+
+// both lights get the same value, the color mask of the mask pass keeps the channels of the other light
+vec4 packShadowMask(float shadow, float penumbraPixels)
+{
+    float penumbra = min(penumbraPixels / MAX_PENUMBRA_PIXELS, 1.0);
+    return vec4(shadow, shadow, penumbra, penumbra);
+}
+
+vec2 unpackPenumbraRadius(vec4 mask)
+{
+    return mask.ba * MAX_PENUMBRA_PIXELS;
+}
\ No newline at end of file
@@ -41,15 +41,24 @@ vec3 getDirectionalLightColor(vec3 N)
     {
         return vec3(0.0);
     }
+    float shadow;
+    if(isShadowMaskUsed())
+    {
+        shadow = readShadowMask(MASK_DIRECTIONAL);
+    }
+    else
+    {
 #if SHADOW_MASTER || SHADOW_CHSS
-    float shadow = calcShadow(dot(fs_in.normal, -dirLightData.direction), fs_in.dirSpacePos, dirLightData.nearZ, dirLightData.lightSize, directionalShadow, directionalPenumbra);
+        shadow = isPenumbraTile(TILE_DIRECTIONAL) ? calcShadow(dot(fs_in.normal, -dirLightData.direction), fs_in.dirSpacePos, dirLightData.nearZ, dirLightData.lightSize, directionalShadow, directionalPenumbra, fs_in.normal, DIR_SHADOW_PAGED) : calcHardShadow(fs_in.dirSpacePos, directionalShadow, DIR_SHADOW_PAGED);
 #elif SHADOW_PCSS
-    float shadow = calcShadow(dot(fs_in.normal, -dirLightData.direction), fs_in.dirSpacePos, dirLightData.nearZ, dirLightData.lightSize, directionalShadow);
-#elif SHADOW_VSM
-    float shadow = calcShadow(fs_in.dirSpacePos, directionalShadow);
+        shadow = isPenumbraTile(TILE_DIRECTIONAL) ? calcShadow(dot(fs_in.normal, -dirLightData.direction), fs_in.dirSpacePos, dirLightData.nearZ, dirLightData.lightSize, directionalShadow, directionalDepthPyramid, DIR_SHADOW_PAGED) : calcHardShadow(fs_in.dirSpacePos, directionalShadow, DIR_SHADOW_PAGED);
+#elif SHADOW_FILTERABLE
+        shadow = calcShadow(fs_in.dirSpacePos, directionalShadow);
 #else
-    float shadow = calcShadow(dot(fs_in.normal, -dirLightData.direction), fs_in.dirSpacePos, directionalShadow);
+        shadow = calcShadow(dot(fs_in.normal, -dirLightData.direction), fs_in.dirSpacePos, directionalShadow, DIR_SHADOW_PAGED);
 #endif
+    }
+    shadow = applyContactShadow(shadow, MASK_DIRECTIONAL);
     vec3 L = normalize(-fs_in.tangentDirLightDirection);
     float NdotL = max(dot(N, L), 0.0);
     return dirLightData.color * dirLightData.strength * NdotL * (1.0 - shadow);
@@ -61,15 +70,24 @@ vec3 getSpotLightColor(vec3 N)
     {
         return vec3(0.0);
     }
+    float shadow;
+    if(isShadowMaskUsed())
+    {
+        shadow = readShadowMask(MASK_SPOT);
+    }
+    else
+    {
 #if SHADOW_MASTER || SHADOW_CHSS
-    float shadow = calcShadow(dot(fs_in.normal, normalize(spotLightData.position - fs_in.pos)), fs_in.spotSpacePos, spotLightData.nearZ, spotLightData.lightSize, spotShadow, spotPenumbra);
+        shadow = isPenumbraTile(TILE_SPOT) ? calcShadow(dot(fs_in.normal, normalize(spotLightData.position - fs_in.pos)), fs_in.spotSpacePos, spotLightData.nearZ, spotLightData.lightSize, spotShadow, spotPenumbra, fs_in.normal, false) : calcHardShadow(fs_in.spotSpacePos, spotShadow, false);
 #elif SHADOW_PCSS
-    float shadow = calcShadow(dot(fs_in.normal, normalize(spotLightData.position - fs_in.pos)), fs_in.spotSpacePos, spotLightData.nearZ, spotLightData.lightSize, spotShadow);
-#elif SHADOW_VSM
-    float shadow = calcShadow(fs_in.spotSpacePos, spotShadow);
+        shadow = isPenumbraTile(TILE_SPOT) ? calcShadow(dot(fs_in.normal, normalize(spotLightData.position - fs_in.pos)), fs_in.spotSpacePos, spotLightData.nearZ, spotLightData.lightSize, spotShadow, spotDepthPyramid, false) : calcHardShadow(fs_in.spotSpacePos, spotShadow, false);
+#elif SHADOW_FILTERABLE
+        shadow = calcShadow(fs_in.spotSpacePos, spotShadow);
 #else
-    float shadow = calcShadow(dot(fs_in.normal, normalize(spotLightData.position - fs_in.pos)), fs_in.spotSpacePos, spotShadow);
+        shadow = calcShadow(dot(fs_in.normal, normalize(spotLightData.position - fs_in.pos)), fs_in.spotSpacePos, spotShadow, false);
 #endif
+    }
+    shadow = applyContactShadow(shadow, MASK_SPOT);
     vec3 L = normalize(fs_in.tangentSpotLightPosition - fs_in.tangentFragPos);
     float NdotL = max(dot(N, L), 0.0);
     vec3 toLight = normalize(-fs_in.tangentSpotLightDirection);
@@ -24,6 +24,9 @@ out VS_OUT
     vec4 spotSpacePos;
 } vs_out;
 
+// matches the depth prepass
+invariant gl_Position;
+
 void main()
 {
     vs_out.pos = vec3(model * vec4(pos, 1.0));
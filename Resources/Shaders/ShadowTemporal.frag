@@ -0,0 +1,61 @@
+#version 430 core
+
+//SHADOW>include UboWindow.glsl
+
+layout(binding = 0) uniform sampler2D currentMask;
+layout(binding = 1) uniform sampler2D history; // shadow terms in rg, view depth in b
+layout(binding = 14) uniform sampler2D depthTexture;
+uniform mat4 inverseViewProjection;
+uniform mat4 previousViewProjection;
+uniform float historyWeight;
+uniform bool historyValid;
+
+in VS_OUT
+{
+    vec2 texCoords;
+} fs_in;
+
+out vec4 outColor;
+
+const float DISOCCLUSION_DEPTH_TOLERANCE = 0.02; // relative to the view depth
+
+void main()
+{
+    ivec2 texel = ivec2(gl_FragCoord.xy);
+    float depth = texelFetch(depthTexture, texel, 0).r;
+    if(depth == 1.0)
+    {
+        outColor = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+    vec4 ndc = vec4(gl_FragCoord.xy / windowSize * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+    vec4 world = inverseViewProjection * ndc;
+    vec3 pos = world.xyz / world.w;
+    float viewDepth = 1.0 / world.w;
+    vec2 current = texelFetch(currentMask, texel, 0).rg;
+    vec2 result = current;
+    vec4 previousClip = previousViewProjection * vec4(pos, 1.0);
+    vec2 previousCoords = previousClip.xy / previousClip.w * 0.5 + 0.5;
+    if(historyValid && previousClip.w > 0.0 && all(greaterThanEqual(previousCoords, vec2(0.0))) && all(lessThanEqual(previousCoords, vec2(1.0))))
+    {
+        vec3 previous = texture(history, previousCoords).rgb;
+        // the surface seen there in the previous frame was a different one, e.g. it has just been uncovered
+        bool disoccluded = abs(previous.b - previousClip.w) > DISOCCLUSION_DEPTH_TOLERANCE * previousClip.w;
+        if(!disoccluded)
+        {
+            // the history may only vary within the range of the current neighbourhood, which rejects stale shadows of moved casters
+            vec2 neighbourhoodMin = current, neighbourhoodMax = current;
+            for(int y = -1; y <= 1; ++y)
+            {
+                for(int x = -1; x <= 1; ++x)
+                {
+                    vec2 neighbour = texelFetch(currentMask, clamp(texel + ivec2(x, y), ivec2(0), ivec2(windowSize) - 1), 0).rg;
+                    neighbourhoodMin = min(neighbourhoodMin, neighbour);
+                    neighbourhoodMax = max(neighbourhoodMax, neighbour);
+                }
+            }
+            result = mix(current, clamp(previous.rg, neighbourhoodMin, neighbourhoodMax), historyWeight);
+        }
+    }
+    outColor = vec4(result, viewDepth, 1.0);
+}
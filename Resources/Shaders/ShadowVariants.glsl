@@ -4,6 +4,8 @@
 #define SHADOW_IMPL_VSM 3
 #define SHADOW_IMPL_PCSS 4
 #define SHADOW_IMPL_CHSS 5
+#define SHADOW_IMPL_MSM 6
+#define SHADOW_IMPL_EVSM 7
 
 //SHADOW>include SHADOW_IMPL
 
@@ -11,7 +13,7 @@
 #error "SHADOW_IMPL is not defined!"
 #endif
 
-#if SHADOW_IMPL < SHADOW_IMPL_MASTER || SHADOW_IMPL > SHADOW_IMPL_CHSS
+#if SHADOW_IMPL < SHADOW_IMPL_MASTER || SHADOW_IMPL > SHADOW_IMPL_EVSM
 #error "Invalid SHADOW_IMPL value!"
 #endif
 
@@ -21,3 +23,8 @@
 #define SHADOW_VSM SHADOW_IMPL == SHADOW_IMPL_VSM
 #define SHADOW_PCSS SHADOW_IMPL == SHADOW_IMPL_PCSS
 #define SHADOW_CHSS SHADOW_IMPL == SHADOW_IMPL_CHSS
+#define SHADOW_MSM SHADOW_IMPL == SHADOW_IMPL_MSM
+#define SHADOW_EVSM SHADOW_IMPL == SHADOW_IMPL_EVSM
+
+// variants storing prefilterable moments instead of plain depth
+#define SHADOW_FILTERABLE (SHADOW_VSM || SHADOW_MSM || SHADOW_EVSM)
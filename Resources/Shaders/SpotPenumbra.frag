@@ -10,14 +10,19 @@ layout(binding = 12) uniform sampler2D spotShadow;
 
 in VS_OUT
 {
+    vec3 normal;
     vec4 spotSpacePos;
 } fs_in;
 
-out float outColor;
+out vec4 outColor;
 
 //SHADOW>include ShadowCalculations.glsl
 
 void main()
 {
-    outColor = calcPenumbra(fs_in.spotSpacePos, spotLightData.nearZ, spotLightData.lightSize, spotShadow);
+#if SHADOW_MASTER || SHADOW_CHSS
+    outColor = packPenumbra(calcPenumbra(fs_in.spotSpacePos, spotLightData.nearZ, spotLightData.lightSize, spotShadow, spotDepthPyramid, false), fs_in.normal);
+#else
+    outColor = vec4(0.0); // compiled for every technique, but only rendered by the penumbra based ones
+#endif
 }
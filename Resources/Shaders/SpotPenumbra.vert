@@ -1,5 +1,6 @@
 #version 430 core
 layout (location = 0) in vec3 pos;
+layout (location = 1) in vec3 normal;
 
 //SHADOW>include UboMvp.glsl
 
@@ -9,6 +10,7 @@ layout (location = 0) in vec3 pos;
 
 out VS_OUT
 {
+    vec3 normal;
     vec4 spotSpacePos;
 } vs_out;
 
@@ -16,6 +18,7 @@ void main()
 {
     vec4 position = model * vec4(pos, 1.0);
     position.w = 1.0;
+    vs_out.normal = transpose(inverse(mat3(model))) * normal;
     vs_out.spotSpacePos = spotLightData.lightSpace * position;
     gl_Position = projection * view * position;
 }
@@ -1,5 +1,7 @@
 #version 430 core
 
+//SHADOW>include UboMvp.glsl
+
 //SHADOW>include LightStructs.glsl
 
 //SHADOW>include UboLights.glsl
@@ -26,6 +28,7 @@ in VS_OUT
     vec3 tangentDirLightDirection;
     vec3 tangentSpotLightDirection;
     vec3 tangentSpotLightPosition;
+    mat3 tangentSpace;
     vec3 toView;
     vec4 dirSpacePos;
     vec4 spotSpacePos;
@@ -42,21 +45,32 @@ out vec4 outColor;
 
 //SHADOW>include ShadowCalculations.glsl
 
+//SHADOW>include LightClusters.glsl
+
 vec3 getDirectionalLightColor(vec3 N, vec3 V, float NdotV, vec3 F0, vec3 albedo, float roughness, float metallic)
 {
     if(dirLightData.strength == 0.0)
     {
         return vec3(0.0);
     }
+    float shadow;
+    if(isShadowMaskUsed())
+    {
+        shadow = readShadowMask(MASK_DIRECTIONAL);
+    }
+    else
+    {
 #if SHADOW_MASTER || SHADOW_CHSS
-    float shadow = calcShadow(dot(fs_in.normal, -dirLightData.direction), fs_in.dirSpacePos, dirLightData.nearZ, dirLightData.lightSize, directionalShadow, directionalPenumbra);
+        shadow = isPenumbraTile(TILE_DIRECTIONAL) ? calcShadow(dot(fs_in.normal, -dirLightData.direction), fs_in.dirSpacePos, dirLightData.nearZ, dirLightData.lightSize, directionalShadow, directionalPenumbra, fs_in.normal, DIR_SHADOW_PAGED) : calcHardShadow(fs_in.dirSpacePos, directionalShadow, DIR_SHADOW_PAGED);
 #elif SHADOW_PCSS
-    float shadow = calcShadow(dot(fs_in.normal, -dirLightData.direction), fs_in.dirSpacePos, dirLightData.nearZ, dirLightData.lightSize, directionalShadow);
-#elif SHADOW_VSM
-    float shadow = calcShadow(fs_in.dirSpacePos, directionalShadow);
+        shadow = isPenumbraTile(TILE_DIRECTIONAL) ? calcShadow(dot(fs_in.normal, -dirLightData.direction), fs_in.dirSpacePos, dirLightData.nearZ, dirLightData.lightSize, directionalShadow, directionalDepthPyramid, DIR_SHADOW_PAGED) : calcHardShadow(fs_in.dirSpacePos, directionalShadow, DIR_SHADOW_PAGED);
+#elif SHADOW_FILTERABLE
+        shadow = calcShadow(fs_in.dirSpacePos, directionalShadow);
 #else
-    float shadow = calcShadow(dot(fs_in.normal, -dirLightData.direction), fs_in.dirSpacePos, directionalShadow);
+        shadow = calcShadow(dot(fs_in.normal, -dirLightData.direction), fs_in.dirSpacePos, directionalShadow, DIR_SHADOW_PAGED);
 #endif
+    }
+    shadow = applyContactShadow(shadow, MASK_DIRECTIONAL);
     vec3 L = normalize(-fs_in.tangentDirLightDirection);
     float NdotL = max(dot(N, L), 0.0);
     vec3 H = normalize(V + L);
@@ -70,21 +84,30 @@ vec3 getDirectionalLightColor(vec3 N, vec3 V, float NdotV, vec3 F0, vec3 albedo,
     return (diffuse + specular) * dirLightData.color * dirLightData.strength * NdotL * (1.0-shadow);
 }
 
-vec3 getSpotLightColor(vec3 N, vec3 V, float NdotV, vec3 F0, vec3 albedo, float roughness, float metallic)
+vec3 getSpotLightColor(vec3 N, vec3 V, float NdotV, vec3 F0, vec3 albedo, float roughness, float metallic, uint cluster)
 {
-    if(spotLightData.strength == 0.0)
+    if(spotLightData.strength == 0.0 || !isSpotLightInCluster(cluster))
     {
         return vec3(0.0);
     }
+    float shadow;
+    if(isShadowMaskUsed())
+    {
+        shadow = readShadowMask(MASK_SPOT);
+    }
+    else
+    {
 #if SHADOW_MASTER || SHADOW_CHSS
-    float shadow = calcShadow(dot(fs_in.normal, normalize(spotLightData.position - fs_in.pos)), fs_in.spotSpacePos, spotLightData.nearZ, spotLightData.lightSize, spotShadow, spotPenumbra);
+        shadow = isPenumbraTile(TILE_SPOT) ? calcShadow(dot(fs_in.normal, normalize(spotLightData.position - fs_in.pos)), fs_in.spotSpacePos, spotLightData.nearZ, spotLightData.lightSize, spotShadow, spotPenumbra, fs_in.normal, false) : calcHardShadow(fs_in.spotSpacePos, spotShadow, false);
 #elif SHADOW_PCSS
-    float shadow = calcShadow(dot(fs_in.normal, normalize(spotLightData.position - fs_in.pos)), fs_in.spotSpacePos, spotLightData.nearZ, spotLightData.lightSize, spotShadow);
-#elif SHADOW_VSM
-    float shadow = calcShadow(fs_in.spotSpacePos, spotShadow);
+        shadow = isPenumbraTile(TILE_SPOT) ? calcShadow(dot(fs_in.normal, normalize(spotLightData.position - fs_in.pos)), fs_in.spotSpacePos, spotLightData.nearZ, spotLightData.lightSize, spotShadow, spotDepthPyramid, false) : calcHardShadow(fs_in.spotSpacePos, spotShadow, false);
+#elif SHADOW_FILTERABLE
+        shadow = calcShadow(fs_in.spotSpacePos, spotShadow);
 #else
-    float shadow = calcShadow(dot(fs_in.normal, normalize(spotLightData.position - fs_in.pos)), fs_in.spotSpacePos, spotShadow);
+        shadow = calcShadow(dot(fs_in.normal, normalize(spotLightData.position - fs_in.pos)), fs_in.spotSpacePos, spotShadow, false);
 #endif
+    }
+    shadow = applyContactShadow(shadow, MASK_SPOT);
     vec3 L = normalize(fs_in.tangentSpotLightPosition - fs_in.tangentFragPos);
     float NdotL = max(dot(N, L), 0.0);
     vec3 toLight = normalize(-fs_in.tangentSpotLightDirection);
@@ -104,8 +127,33 @@ vec3 getSpotLightColor(vec3 N, vec3 V, float NdotV, vec3 F0, vec3 albedo, float
     return (diffuse + specular) * spotLightData.color * spotLightData.strength * attenuation * intensity * NdotL * (1.0-shadow);
 }
 
+vec3 getPointLightsColor(vec3 N, vec3 V, float NdotV, vec3 F0, vec3 albedo, float roughness, float metallic, uint cluster)
+{
+    vec3 result = vec3(0.0);
+    uint lightCount = getClusterLightCount(cluster);
+    for(uint i = 0u; i < lightCount; ++i)
+    {
+        PointLightData light = getClusterPointLight(cluster, i);
+        vec3 toLight = light.position - fs_in.pos;
+        float dist = length(toLight);
+        vec3 L = normalize(fs_in.tangentSpace * toLight);
+        float NdotL = max(dot(N, L), 0.0);
+        vec3 H = normalize(V + L);
+        float cosTheta = max(dot(H, V), 0.0);
+        vec3 F = fresnelSchlick(cosTheta, F0);
+        float D = DistributionGGX(N, H, roughness);
+        float G = GeometrySmith(N, V, L, roughness);
+        vec3 specular = (F*D*G) / max(4.0 * NdotV * NdotL, 0.00001);
+        vec3 kD = (vec3(1.0) - specular) * (1.0 - metallic);
+        vec3 diffuse = kD * albedo / PI;
+        result += (diffuse + specular) * light.color * light.strength * getPointLightAttenuation(dist, light.radius) * NdotL;
+    }
+    return result;
+}
+
 void main()
 {
+    uint cluster = getFragmentCluster(gl_FragCoord.xy, 1.0 / gl_FragCoord.w);
     vec3 albedo = texture(albedoTexture, fs_in.texCoords).rgb;
     float roughness = texture(roughnessTexture, fs_in.texCoords).r;
     float metallic = texture(metalnessTexture, fs_in.texCoords).r;
@@ -115,6 +163,7 @@ void main()
     vec3 Lo =
         albedo * ambient
         + max(getDirectionalLightColor(N, fs_in.toView, NdotV, F0, albedo, roughness, metallic), vec3(0.0))
-        + max(getSpotLightColor(N, fs_in.toView, NdotV, F0, albedo, roughness, metallic), vec3(0.0));
+        + max(getSpotLightColor(N, fs_in.toView, NdotV, F0, albedo, roughness, metallic, cluster), vec3(0.0))
+        + max(getPointLightsColor(N, fs_in.toView, NdotV, F0, albedo, roughness, metallic, cluster), vec3(0.0));
     outColor = vec4(Lo, 1.0);
 }
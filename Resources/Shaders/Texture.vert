@@ -21,11 +21,15 @@ out VS_OUT
     vec3 tangentDirLightDirection;
     vec3 tangentSpotLightDirection;
     vec3 tangentSpotLightPosition;
+    mat3 tangentSpace;
     vec3 toView;
     vec4 dirSpacePos;
     vec4 spotSpacePos;
 } vs_out;
 
+// matches the depth prepass
+invariant gl_Position;
+
 void main()
 {
     vs_out.pos = vec3(model * vec4(pos, 1.0));
@@ -39,6 +43,7 @@ void main()
     vs_out.tangentDirLightDirection = TBN * dirLightData.direction;
     vs_out.tangentSpotLightDirection = TBN * spotLightData.direction;
     vs_out.tangentSpotLightPosition = TBN * spotLightData.position;
+    vs_out.tangentSpace = TBN;
     vs_out.toView = normalize(TBN * viewPosition - vs_out.tangentFragPos);
     vs_out.dirSpacePos = dirLightData.lightSpace * vec4(vs_out.pos, 1.0);
     vs_out.spotSpacePos = spotLightData.lightSpace * vec4(vs_out.pos, 1.0);
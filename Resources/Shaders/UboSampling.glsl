@@ -0,0 +1,13 @@
+#define MAX_VOGEL_SAMPLES 64
+
+layout (std140, binding = 4) uniform Sampling
+{
+    vec4 vogelDisks[MAX_VOGEL_SAMPLES]; // shadow disk (radius, angle) in xy, penumbra disk in zw
+    ivec4 sampleCounts; // Vogel shadow and penumbra samples, PCSS blocker and filter samples
+    ivec4 filterSize; // PCF filter width in x
+    ivec4 noiseOffset; // blue noise tile offset in xy
+    vec4 adaptiveSampling; // early-out ring samples in x, samples per covered shadow map texel in y, zero disables either
+    ivec4 shadowTileSize; // screen tile size in x when the shadow tile classification is used, 0 otherwise
+    ivec4 deferredShadows; // 1 in x when the shading reads the deferred shadow mask
+    ivec4 contactShadows; // 1 in x when the shading combines the screen-space contact shadows
+};
\ No newline at end of file